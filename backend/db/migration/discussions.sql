@@ -27,6 +27,16 @@ CREATE TABLE IF NOT EXISTS discussion_replies (
     FOREIGN KEY (user_id) REFERENCES users(id) ON DELETE CASCADE
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
+-- 点赞记录表，(user_id, target_type, target_id) 唯一，target_type：0-讨论，1-回复
+CREATE TABLE IF NOT EXISTS discussion_likes (
+    user_id INT NOT NULL,
+    target_type TINYINT NOT NULL,
+    target_id INT NOT NULL,
+    created_at BIGINT NOT NULL,
+    PRIMARY KEY (user_id, target_type, target_id),
+    KEY idx_discussion_likes_target (target_type, target_id)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
 -- 添加索引用于提高查询效率
 CREATE INDEX idx_discussions_problem_id ON discussions(problem_id);
 CREATE INDEX idx_discussion_replies_discussion_id ON discussion_replies(discussion_id);
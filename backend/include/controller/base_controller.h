@@ -2,6 +2,7 @@
 #define BASE_CONTROLLER_H
 
 #include "../http/http_server.h"
+#include "../http/json_writer.h"
 #include <json/json.h>
 #include <string>
 #include <map>
@@ -9,8 +10,8 @@
 // 从请求体解析JSON的通用方法
 Json::Value parseRequestBody(const std::string& body);
 
-// 将JSON对象序列化为字符串的通用方法
-std::string jsonToString(const Json::Value& value);
+// 将JSON对象序列化为字符串的通用方法（默认紧凑输出）
+std::string jsonToString(const Json::Value& value, bool pretty = false);
 
 class BaseController {
 public:
@@ -26,6 +27,10 @@ protected:
     
     // 错误响应辅助方法
     void sendErrorResponse(http::Response& res, const std::string& message, int statusCode = 400);
+    
+    // 条件请求辅助方法：设置ETag和Cache-Control，If-None-Match命中时返回304并返回true
+    bool checkNotModified(const http::Request& req, http::Response& res, const std::string& etag,
+                          const std::string& cache_control = "public, no-cache");
 };
 
 #endif // BASE_CONTROLLER_H 
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "../http/http_server.h"
 #include "../models/discussion.h"
+#include "../services/discussion_likes.h"
 #include "../middleware/auth_middleware.h"
 #include "base_controller.h"
 
@@ -24,6 +25,9 @@ private:
     // 获取题目相关讨论
     void handleGetProblemDiscussions(const http::Request& req, http::Response& res);
     
+    // 获取热门讨论
+    void handleGetHotDiscussions(const http::Request& req, http::Response& res);
+    
     // 获取讨论详情
     void handleGetDiscussionDetail(const http::Request& req, http::Response& res);
     
@@ -45,8 +49,8 @@ private:
     // 删除回复
     void handleDeleteReply(const http::Request& req, http::Response& res);
     
-    // 从URL路径获取ID
-    int getIdFromPath(const std::string& path, const std::string& prefix);
+    // 点赞或取消点赞讨论/回复
+    void handleSetLike(const http::Request& req, http::Response& res, LikeTarget target, bool liked);
 };
 
 #endif // DISCUSSION_CONTROLLER_H 
\ No newline at end of file
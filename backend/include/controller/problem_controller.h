@@ -55,11 +55,11 @@ private:
     // 获取单个提交详情
     void handleGetSubmissionDetail(const http::Request& req, http::Response& res);
     
+    // 订阅提交评测状态（Server-Sent Events）
+    void handleSubmissionEvents(const http::Request& req, http::Response& res);
+    
     // 重新提交代码
     void handleResubmitCode(const http::Request& req, http::Response& res);
-    
-    // 从路径参数中获取ID
-    int getIdFromPath(const std::string& path, const std::string& prefix);
 };
 
 #endif // PROBLEM_CONTROLLER_H 
\ No newline at end of file
@@ -19,6 +19,9 @@ private:
     
     // 数据库测试处理
     void handleDbTest(const http::Request& req, http::Response& res);
+    
+    // 发布JWT验证公钥集合（JWKS）
+    void handleJwks(const http::Request& req, http::Response& res);
 };
 
 #endif // SYSTEM_CONTROLLER_H 
\ No newline at end of file
@@ -62,6 +62,9 @@ private:
     
     // 重置用户密码（管理员）
     void handleResetUserPassword(const http::Request& req, http::Response& res);
+    
+    // 发送涉及密码哈希的错误响应，哈希线程池繁忙时返回503
+    void sendPasswordErrorResponse(http::Response& res, const std::string& error_message, int status_code);
 };
 
 #endif // USER_CONTROLLER_H
\ No newline at end of file
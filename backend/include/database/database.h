@@ -2,8 +2,10 @@
 #define DATABASE_H
 
 #include <string>
+#include <vector>
 #include <memory>
 #include <mutex>
+#include <functional>
 #include <utility> // 添加用于std::pair
 #include "database_pool.h"
 
@@ -45,6 +47,20 @@ public:
     // 执行SQL命令（插入，更新，删除）
     bool executeCommand(const std::string& command);
     
+    // 执行SQL命令并返回影响的行数（在同一连接上读取，不受其他线程的操作影响）
+    bool executeCommand(const std::string& command, unsigned long long& affected_rows);
+    
+    // 执行插入命令并返回自增ID（在同一连接上读取）
+    bool executeInsert(const std::string& command, unsigned long long& insert_id);
+    
+    // 在同一连接上以事务执行一组命令，任一失败时回滚；affected_rows 为各命令影响行数之和
+    bool executeTransaction(const std::vector<std::string>& commands, unsigned long long& affected_rows);
+    
+    // 在同一连接上以事务先执行查询（通常带 FOR UPDATE 锁定要修改的行），再执行 commands 和 build 根据查询结果追加的命令；
+    // 查询失败、build 返回false或任一命令失败时回滚
+    bool executeTransaction(const std::string& query, const std::function<bool(MYSQL_RES*, std::vector<std::string>&)>& build,
+                            const std::vector<std::string>& commands, unsigned long long& affected_rows);
+    
     // 获取上一次操作影响的行数
     unsigned long long getAffectedRows();
     
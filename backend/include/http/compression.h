@@ -0,0 +1,210 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <zlib.h>
+
+// 默认压缩阈值（字节），小于该大小的响应不压缩
+#define DEFAULT_COMPRESSION_MIN_SIZE 1024
+
+// 默认压缩结果缓存容量（字节）
+#define DEFAULT_COMPRESSION_CACHE_BYTES (32 * 1024 * 1024)
+
+namespace http {
+
+    // 响应内容编码
+    enum class ContentEncoding {
+        NONE,
+        GZIP,
+        DEFLATE
+    };
+
+    // 响应压缩工具
+    class Compression {
+    public:
+        // 根据 Accept-Encoding 协商编码，优先gzip，其次deflate；q=0 表示明确拒绝
+        // * 只作用于客户端没有单独列出的编码，如 "gzip;q=0, *" 不会选择gzip
+        static ContentEncoding negotiate(const std::string& accept_encoding) {
+            int gzip = -1;      // -1 未列出，0 拒绝，1 接受
+            int deflate = -1;
+            int any = -1;
+
+            size_t start = 0;
+            while (start < accept_encoding.size()) {
+                size_t end = accept_encoding.find(',', start);
+                if (end == std::string::npos) {
+                    end = accept_encoding.size();
+                }
+                std::string item = accept_encoding.substr(start, end - start);
+                start = end + 1;
+
+                // 拆分编码名和q值
+                std::string name = item;
+                double q = 1.0;
+                size_t semi = item.find(';');
+                if (semi != std::string::npos) {
+                    name = item.substr(0, semi);
+                    size_t q_pos = item.find("q=", semi);
+                    if (q_pos != std::string::npos) {
+                        q = std::atof(item.c_str() + q_pos + 2);
+                    }
+                }
+                name = trimLower(name);
+                int accepted = q > 0.0 ? 1 : 0;
+
+                // 同一编码出现多次时，任一次接受即视为接受
+                if (name == "gzip" || name == "x-gzip") {
+                    gzip = std::max(gzip, accepted);
+                } else if (name == "deflate") {
+                    deflate = std::max(deflate, accepted);
+                } else if (name == "*") {
+                    any = std::max(any, accepted);
+                }
+            }
+
+            if ((gzip < 0 ? any : gzip) > 0) return ContentEncoding::GZIP;
+            if ((deflate < 0 ? any : deflate) > 0) return ContentEncoding::DEFLATE;
+            return ContentEncoding::NONE;
+        }
+
+        static const char* encodingName(ContentEncoding encoding) {
+            switch (encoding) {
+                case ContentEncoding::GZIP: return "gzip";
+                case ContentEncoding::DEFLATE: return "deflate";
+                default: return "identity";
+            }
+        }
+
+        // 压缩数据，gzip格式带gzip头，deflate格式为zlib封装（HTTP规范中的deflate）
+        static bool compress(const std::string& input, ContentEncoding encoding, std::string& output) {
+            if (encoding == ContentEncoding::NONE) {
+                return false;
+            }
+
+            z_stream stream;
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+
+            int window_bits = encoding == ContentEncoding::GZIP ? 15 + 16 : 15;
+            if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                return false;
+            }
+
+            output.resize(deflateBound(&stream, static_cast<uLong>(input.size())) + 32);
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+            stream.avail_in = static_cast<uInt>(input.size());
+            stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+            stream.avail_out = static_cast<uInt>(output.size());
+
+            int ret = deflate(&stream, Z_FINISH);
+            size_t written = stream.total_out;
+            deflateEnd(&stream);
+
+            if (ret != Z_STREAM_END) {
+                output.clear();
+                return false;
+            }
+            output.resize(written);
+            return true;
+        }
+
+    private:
+        static std::string trimLower(const std::string& value) {
+            size_t begin = value.find_first_not_of(" \t");
+            if (begin == std::string::npos) {
+                return "";
+            }
+            size_t end = value.find_last_not_of(" \t");
+            std::string result = value.substr(begin, end - begin + 1);
+            for (auto& c : result) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            return result;
+        }
+    };
+
+    // 压缩结果缓存
+    // 以 "编码 + 请求路径" 为键缓存压缩后的字节，同时记录原始响应体的长度和哈希；
+    // 只有原始内容完全一致时才复用，内容变化后自动重新压缩。按总字节数做LRU淘汰。
+    class CompressionCache {
+    public:
+        explicit CompressionCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes), used_bytes_(0) {}
+
+        // 查找缓存，命中时通过output返回压缩结果
+        bool get(const std::string& key, const std::string& body, std::string& output) {
+            size_t body_hash = std::hash<std::string>()(body);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it == index_.end()) {
+                return false;
+            }
+            const Entry& entry = *it->second;
+            if (entry.body_size != body.size() || entry.body_hash != body_hash) {
+                return false;
+            }
+            // 移到LRU头部
+            entries_.splice(entries_.begin(), entries_, it->second);
+            output = entry.compressed;
+            return true;
+        }
+
+        // 写入缓存
+        void put(const std::string& key, const std::string& body, const std::string& compressed) {
+            size_t entry_bytes = key.size() + compressed.size();
+            if (entry_bytes > capacity_bytes_ / 4) {
+                return; // 过大的响应不缓存，避免挤掉其他热点
+            }
+            size_t body_hash = std::hash<std::string>()(body);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                used_bytes_ -= it->second->key.size() + it->second->compressed.size();
+                entries_.erase(it->second);
+                index_.erase(it);
+            }
+
+            Entry entry;
+            entry.key = key;
+            entry.body_size = body.size();
+            entry.body_hash = body_hash;
+            entry.compressed = compressed;
+            entries_.push_front(std::move(entry));
+            index_[key] = entries_.begin();
+            used_bytes_ += entry_bytes;
+
+            while (used_bytes_ > capacity_bytes_ && !entries_.empty()) {
+                const Entry& last = entries_.back();
+                used_bytes_ -= last.key.size() + last.compressed.size();
+                index_.erase(last.key);
+                entries_.pop_back();
+            }
+        }
+
+    private:
+        struct Entry {
+            std::string key;
+            size_t body_size;
+            size_t body_hash;
+            std::string compressed;
+        };
+
+        size_t capacity_bytes_;
+        size_t used_bytes_;
+        std::list<Entry> entries_;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+        std::mutex mutex_;
+    };
+}
+
+#endif // COMPRESSION_H
@@ -5,11 +5,18 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <utility>
 #include <iostream>
 // 使用项目include目录中的httplib库
 #include "../httplib/httplib.h"
+#include "server_config.h"
+#include "task_queue.h"
+#include "router.h"
+#include "compression.h"
 #include <json/json.h>
 
+struct TokenClaims;
+
 namespace http {
     
     // HTTP请求结构的适配器
@@ -20,6 +27,9 @@ namespace http {
         std::map<std::string, std::string> headers;
         std::string body;
         std::map<std::string, std::string> params; // 新增参数存储
+        PathParams path_params; // 路由匹配得到的路径参数
+        // 已验证的令牌声明，由认证中间件在受保护路由中填充，未认证时为空
+        mutable std::shared_ptr<const TokenClaims> claims;
         
         // 从 httplib::Request 创建此适配器
         static Request from_httplib(const httplib::Request& req) {
@@ -66,6 +76,24 @@ namespace http {
             return "";
         }
         
+        // 获取整数路径参数（如 /api/problems/:id 中的 id），不存在时返回-1
+        int get_path_id(const std::string& name = "id") const {
+            auto it = path_params.ints.find(name);
+            if (it != path_params.ints.end()) {
+                return it->second;
+            }
+            return -1;
+        }
+        
+        // 获取字符串路径参数
+        std::string get_path_param(const std::string& name) const {
+            auto it = path_params.strings.find(name);
+            if (it != path_params.strings.end()) {
+                return it->second;
+            }
+            return "";
+        }
+        
         // 获取不带查询参数的路径
         std::string get_base_path() const {
             size_t pos = path.find('?');
@@ -82,11 +110,25 @@ namespace http {
         std::string status_message = "OK";
         std::map<std::string, std::string> headers;
         std::string body;
+        bool pretty_json = false; // 请求带有 ?pretty=1 时输出带缩进的JSON
+        httplib::ContentProviderWithoutLength stream_provider; // 流式响应的数据提供者
+        httplib::ContentProviderResourceReleaser stream_releaser; // 流式响应结束时的清理回调
         
-        // 将此适配器应用到 httplib::Response
-        void apply_to_httplib(httplib::Response& res) const {
+        // 将此适配器应用到 httplib::Response（响应体直接移交，不再拷贝）
+        void apply_to_httplib(httplib::Response& res) {
             res.status = status_code;
-            res.body = body;
+            
+            if (stream_provider) {
+                // Content-Type 由 set_chunked_content_provider 设置，避免重复
+                auto type_it = headers.find("Content-Type");
+                res.set_chunked_content_provider(type_it != headers.end() ? type_it->second : "text/plain",
+                                                 std::move(stream_provider), std::move(stream_releaser));
+                if (type_it != headers.end()) {
+                    headers.erase(type_it);
+                }
+            } else {
+                res.body = std::move(body);
+            }
             
             // 设置所有 headers
             for (const auto& header : headers) {
@@ -94,6 +136,15 @@ namespace http {
             }
         }
         
+        // 设置为分块传输的流式响应（如SSE），provider 在工作线程中被反复调用，
+        // 调用 sink.done() 结束响应，返回 false 表示中止连接；releaser 在连接结束时必定被调用
+        void stream(const std::string& content_type, httplib::ContentProviderWithoutLength provider,
+                    httplib::ContentProviderResourceReleaser releaser = nullptr) {
+            set_content_type(content_type);
+            stream_provider = std::move(provider);
+            stream_releaser = std::move(releaser);
+        }
+        
         void set_header(const std::string& key, const std::string& value) {
             headers[key] = value;
         }
@@ -116,6 +167,12 @@ namespace http {
             body = json_str;
             set_content_type("application/json");
         }
+        
+        // 设置为JSON响应（移动语义，避免拷贝大响应体）
+        void json(std::string&& json_str) {
+            body = std::move(json_str);
+            set_content_type("application/json");
+        }
     };
     
     // 路由处理器函数类型
@@ -126,14 +183,74 @@ namespace http {
     private:
         uint16_t port_;
         std::unique_ptr<httplib::Server> server_;
+        Router<RouteHandler> router_;
+        bool enable_compression_ = true;
+        size_t compression_min_size_ = DEFAULT_COMPRESSION_MIN_SIZE;
+        std::unique_ptr<CompressionCache> compression_cache_;
         
     public:
         // 修改构造函数，使用C++11兼容的方式创建unique_ptr
-        HttpServer(uint16_t port = 8080) : port_(port), server_(new httplib::Server()) {
-            // 设置错误处理程序
+        HttpServer(uint16_t port = 8080) : port_(port), server_(new httplib::Server()),
+            compression_cache_(new CompressionCache(DEFAULT_COMPRESSION_CACHE_BYTES)) {
+            setup_handlers();
+        }
+        
+        // 按配置创建服务器：工作线程池、排队上限、长连接、超时和请求体大小
+        explicit HttpServer(const ServerConfig& config) : port_(config.port), server_(new httplib::Server()) {
+            setup_handlers();
+            
+            size_t worker_threads = config.worker_threads;
+            size_t max_queued_requests = config.max_queued_requests;
+            server_->new_task_queue = [worker_threads, max_queued_requests]() -> httplib::TaskQueue* {
+                return new SheddingTaskQueue(worker_threads, max_queued_requests);
+            };
+            
+            server_->set_keep_alive_max_count(config.keep_alive_max_count);
+            server_->set_keep_alive_timeout(config.keep_alive_timeout_sec);
+            server_->set_read_timeout(config.read_timeout_sec, 0);
+            server_->set_write_timeout(config.write_timeout_sec, 0);
+            server_->set_payload_max_length(config.max_payload_length);
+            
+            enable_compression_ = config.enable_compression;
+            compression_min_size_ = config.compression_min_size;
+            if (config.compression_cache_bytes > 0) {
+                compression_cache_.reset(new CompressionCache(config.compression_cache_bytes));
+            }
+        }
+        
+        ~HttpServer() {
+            stop();
+        }
+        
+    private:
+        // 注册错误、异常、过载和CORS预检处理程序
+        void setup_handlers() {
+            // 设置错误处理程序：保留已有的状态码，只为没有响应体的错误（如413、503）补充JSON消息
             server_->set_error_handler([](const httplib::Request& req, httplib::Response& res) {
-                res.status = 500;
-                res.set_content("{\"status\": \"error\", \"message\": \"Internal server error\"}", "application/json");
+                if (!res.body.empty()) {
+                    return;
+                }
+                if (res.status == 413) {
+                    res.set_content("{\"status\":\"error\",\"message\":\"请求体过大\"}", "application/json");
+                } else if (res.status == 503) {
+                    res.set_content("{\"status\":\"error\",\"message\":\"服务器繁忙，请稍后重试\"}", "application/json");
+                } else {
+                    res.status = 500;
+                    res.set_content("{\"status\": \"error\", \"message\": \"Internal server error\"}", "application/json");
+                }
+            });
+            
+            // 工作队列已满时，降级线程上的请求在路由前直接返回503并关闭连接
+            server_->set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+                if (!SheddingTaskQueue::isShedding()) {
+                    return httplib::Server::HandlerResponse::Unhandled;
+                }
+                res.status = 503;
+                res.set_header("Retry-After", "1");
+                res.set_header("Connection", "close");
+                res.set_header("Access-Control-Allow-Origin", "*");
+                res.set_content("{\"status\":\"error\",\"message\":\"服务器繁忙，请稍后重试\"}", "application/json");
+                return httplib::Server::HandlerResponse::Handled;
             });
             
             // 设置异常处理程序
@@ -156,44 +273,111 @@ namespace http {
                 res.set_header("Access-Control-Max-Age", "3600"); // 缓存预检请求结果1小时
                 res.status = 204; // No Content
             });
+            
+            // 所有业务路由由前缀树路由器统一分发，httplib 只保留每个方法一个入口
+            auto dispatcher = [this](const httplib::Request& req, httplib::Response& res) {
+                dispatch(req, res);
+            };
+            server_->Get(".*", dispatcher);
+            server_->Post(".*", dispatcher);
+            server_->Put(".*", dispatcher);
+            server_->Delete(".*", dispatcher);
         }
         
-        ~HttpServer() {
-            stop();
+        // 按方法和路径查找路由并调用处理程序
+        void dispatch(const httplib::Request& req, httplib::Response& res) {
+            PathParams path_params;
+            // HEAD 请求沿用 GET 路由
+            const std::string& method = req.method == "HEAD" ? std::string("GET") : req.method;
+            const RouteHandler* handler = router_.match(method, req.path, path_params);
+            if (!handler) {
+                res.status = 404;
+                res.set_header("Access-Control-Allow-Origin", "*");
+                res.set_content("{\"status\":\"error\",\"message\":\"接口不存在\"}", "application/json");
+                return;
+            }
+            
+            // 将 httplib 请求转换为我们的请求
+            Request our_req = Request::from_httplib(req);
+            our_req.path_params = std::move(path_params);
+            Response our_res;
+            std::string pretty = our_req.get_param("pretty");
+            our_res.pretty_json = (pretty == "1" || pretty == "true");
+            
+            // 设置默认响应头
+            our_res.set_header("Server", "C++ HTTP Server");
+            
+            // 自动为所有响应添加CORS头部
+            our_res.set_cors_headers();
+            
+            // 调用处理程序
+            (*handler)(our_req, our_res);
+            
+            // 按 Accept-Encoding 压缩响应体
+            compress_response(req, our_res);
+            
+            // 将我们的响应应用到 httplib 响应
+            our_res.apply_to_httplib(res);
         }
         
-        // 添加路由
-        void add_route(const std::string& method, const std::string& path, RouteHandler handler) {
-            auto wrapper = [handler](const httplib::Request& req, httplib::Response& res) {
-                // 将 httplib 请求转换为我们的请求
-                Request our_req = Request::from_httplib(req);
-                Response our_res;
-                
-                // 设置默认响应头
-                our_res.set_header("Server", "C++ HTTP Server");
-                
-                // 自动为所有响应添加CORS头部
-                our_res.set_cors_headers();
-                
-                // 调用处理程序
-                handler(our_req, our_res);
-                
-                // 将我们的响应应用到 httplib 响应
-                our_res.apply_to_httplib(res);
-            };
+        // 响应压缩：超过阈值的文本响应按协商结果压缩；
+        // 匿名GET请求的200响应会缓存压缩结果，内容不变时直接复用
+        void compress_response(const httplib::Request& req, Response& res) {
+            if (!enable_compression_ || res.body.size() < compression_min_size_ ||
+                res.headers.count("Content-Encoding")) {
+                return;
+            }
+            
+            auto type_it = res.headers.find("Content-Type");
+            if (type_it == res.headers.end() ||
+                (type_it->second.find("json") == std::string::npos && type_it->second.find("text") == std::string::npos)) {
+                return;
+            }
             
-            // 注册到 httplib 服务器
-            if (method == "GET") {
-                server_->Get(path, wrapper);
-            } else if (method == "POST") {
-                server_->Post(path, wrapper);
-            } else if (method == "PUT") {
-                server_->Put(path, wrapper);
-            } else if (method == "DELETE") {
-                server_->Delete(path, wrapper);
-            } else if (method == "OPTIONS") {
-                server_->Options(path, wrapper);
+            ContentEncoding encoding = Compression::negotiate(req.get_header_value("Accept-Encoding"));
+            res.set_header("Vary", "Accept-Encoding");
+            if (encoding == ContentEncoding::NONE) {
+                return;
             }
+            
+            bool cacheable = compression_cache_ && req.method == "GET" && res.status_code == 200 &&
+                             !req.has_header("Authorization");
+            std::string cache_key;
+            std::string compressed;
+            if (cacheable) {
+                cache_key = std::string(Compression::encodingName(encoding)) + " " + req.target;
+                if (compression_cache_->get(cache_key, res.body, compressed)) {
+                    res.body.swap(compressed);
+                    res.set_header("Content-Encoding", Compression::encodingName(encoding));
+                    weaken_etag(res);
+                    return;
+                }
+            }
+            
+            if (!Compression::compress(res.body, encoding, compressed) || compressed.size() >= res.body.size()) {
+                return;
+            }
+            
+            if (cacheable) {
+                compression_cache_->put(cache_key, res.body, compressed);
+            }
+            res.body.swap(compressed);
+            res.set_header("Content-Encoding", Compression::encodingName(encoding));
+            weaken_etag(res);
+        }
+        
+        // 压缩后的字节与原始表示不同，强ETag降级为弱ETag
+        static void weaken_etag(Response& res) {
+            auto it = res.headers.find("ETag");
+            if (it != res.headers.end() && it->second.compare(0, 2, "W/") != 0) {
+                it->second = "W/" + it->second;
+            }
+        }
+        
+    public:
+        // 添加路由，路径模板支持 :id 形式的整数参数和 :name:str 形式的字符串参数
+        void add_route(const std::string& method, const std::string& path, RouteHandler handler) {
+            router_.add(method, path, std::move(handler));
         }
         
         // GET方法路由
@@ -222,11 +406,11 @@ namespace http {
             return server_->listen("0.0.0.0", port_);
         }
         
-        // 停止服务器
+        // 停止服务器，使 start() 返回
+        // 会在信号处理函数中调用，只关闭监听套接字，不输出日志
         void stop() {
             if (server_) {
                 server_->stop();
-                std::cout << "HTTP服务器已停止" << std::endl;
             }
         }
         
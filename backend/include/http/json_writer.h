@@ -0,0 +1,111 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <string>
+#include <memory>
+#include <streambuf>
+#include <ostream>
+#include <json/json.h>
+
+namespace http {
+
+    // 直接追加到目标字符串的输出缓冲区，避免先写入临时字符串再拷贝
+    class StringAppendBuf : public std::streambuf {
+    public:
+        explicit StringAppendBuf(std::string& out) : out_(out) {}
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (ch != traits_type::eof()) {
+                out_.push_back(traits_type::to_char_type(ch));
+            }
+            return ch;
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            out_.append(s, static_cast<size_t>(n));
+            return n;
+        }
+
+    private:
+        std::string& out_;
+    };
+
+    // JSON响应写入器
+    // 默认输出紧凑格式（无缩进、无换行），pretty模式下使用制表符缩进便于调试
+    // StreamWriter按线程缓存，避免每次响应都重新构建配置
+    class JsonWriter {
+    public:
+        // 将JSON值追加写入到out中
+        static void write(const Json::Value& value, std::string& out, bool pretty = false) {
+            StringAppendBuf buf(out);
+            std::ostream os(&buf);
+            getWriter(pretty).write(value, &os);
+        }
+
+        // 将JSON值序列化为字符串
+        static std::string toString(const Json::Value& value, bool pretty = false) {
+            std::string out;
+            write(value, out, pretty);
+            return out;
+        }
+
+        // 追加一个转义后的JSON字符串字面量（含引号）
+        static void writeString(const std::string& str, std::string& out) {
+            out.push_back('"');
+            for (size_t i = 0; i < str.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(str[i]);
+                switch (c) {
+                    case '"':  out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\b': out += "\\b"; break;
+                    case '\f': out += "\\f"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        if (c < 0x20) {
+                            static const char hex[] = "0123456789abcdef";
+                            out += "\\u00";
+                            out.push_back(hex[c >> 4]);
+                            out.push_back(hex[c & 0x0F]);
+                        } else {
+                            // UTF-8字节原样输出
+                            out.push_back(static_cast<char>(c));
+                        }
+                }
+            }
+            out.push_back('"');
+        }
+
+        // 构建 {"status":..., "message":...} 形式的简单响应
+        static std::string statusMessage(const std::string& status, const std::string& message) {
+            std::string out;
+            out.reserve(32 + message.size());
+            out += "{\"status\":";
+            writeString(status, out);
+            out += ",\"message\":";
+            writeString(message, out);
+            out += "}";
+            return out;
+        }
+
+    private:
+        static Json::StreamWriter& getWriter(bool pretty) {
+            static thread_local std::unique_ptr<Json::StreamWriter> compact_writer;
+            static thread_local std::unique_ptr<Json::StreamWriter> pretty_writer;
+
+            std::unique_ptr<Json::StreamWriter>& writer = pretty ? pretty_writer : compact_writer;
+            if (!writer) {
+                Json::StreamWriterBuilder builder;
+                // 启用UTF-8直接输出
+                builder["emitUTF8"] = true;
+                builder["indentation"] = pretty ? "\t" : "";
+                writer.reset(builder.newStreamWriter());
+            }
+            return *writer;
+        }
+    };
+}
+
+#endif // JSON_WRITER_H
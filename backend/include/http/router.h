@@ -0,0 +1,197 @@
+#ifndef ROUTER_H
+#define ROUTER_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <climits>
+
+namespace http {
+
+    // 路径参数类型
+    enum class PathParamType {
+        INT,    // 非负整数，如 :id
+        STRING  // 任意非空片段，如 :name:str
+    };
+
+    // 路由匹配得到的路径参数
+    struct PathParams {
+        std::map<std::string, int> ints;
+        std::map<std::string, std::string> strings;
+    };
+
+    // 前缀树路由器
+    // 路由模板按 '/' 切分为片段，静态片段精确匹配，":name" 匹配整数片段，":name:str" 匹配任意片段。
+    // 匹配时逐段下降，耗时与路径长度成正比；静态片段优先于参数片段。
+    template <typename Handler>
+    class Router {
+    public:
+        Router() : root_(new Node()) {}
+
+        // 注册路由，返回false表示模板非法
+        bool add(const std::string& method, const std::string& pattern, Handler handler) {
+            Node* node = root_.get();
+            std::vector<std::string> segments = split(pattern);
+
+            for (const auto& segment : segments) {
+                if (segment.size() > 1 && segment[0] == ':') {
+                    std::string name = segment.substr(1);
+                    PathParamType type = PathParamType::INT;
+                    size_t colon = name.find(':');
+                    if (colon != std::string::npos) {
+                        std::string type_name = name.substr(colon + 1);
+                        name = name.substr(0, colon);
+                        if (type_name == "str") {
+                            type = PathParamType::STRING;
+                        } else if (type_name != "int") {
+                            std::cerr << "路由模板参数类型无效: " << pattern << std::endl;
+                            return false;
+                        }
+                    }
+
+                    if (!node->param_child) {
+                        node->param_child.reset(new Node());
+                        node->param_name = name;
+                        node->param_type = type;
+                    } else if (node->param_name != name || node->param_type != type) {
+                        std::cerr << "路由模板参数冲突: " << pattern << "，沿用参数 :" << node->param_name << std::endl;
+                    }
+                    node = node->param_child.get();
+                } else {
+                    std::unique_ptr<Node>& child = node->children[segment];
+                    if (!child) {
+                        child.reset(new Node());
+                    }
+                    node = child.get();
+                }
+            }
+
+            if (node->handlers.count(method)) {
+                std::cerr << "路由重复注册，覆盖原处理器: " << method << " " << pattern << std::endl;
+            }
+            node->handlers[method] = std::move(handler);
+            return true;
+        }
+
+        // 查找路由，成功时返回处理器并填充路径参数
+        const Handler* match(const std::string& method, const std::string& path, PathParams& params) const {
+            std::vector<std::pair<const char*, size_t>> segments;
+            splitPath(path, segments);
+            return matchNode(root_.get(), method, segments, 0, params);
+        }
+
+    private:
+        struct Node {
+            std::map<std::string, std::unique_ptr<Node>> children;
+            std::unique_ptr<Node> param_child;
+            std::string param_name;
+            PathParamType param_type = PathParamType::INT;
+            std::map<std::string, Handler> handlers;
+        };
+
+        std::unique_ptr<Node> root_;
+
+        static std::vector<std::string> split(const std::string& pattern) {
+            std::vector<std::string> segments;
+            size_t start = 0;
+            while (start <= pattern.size()) {
+                size_t end = pattern.find('/', start);
+                if (end == std::string::npos) {
+                    end = pattern.size();
+                }
+                if (end > start) {
+                    segments.push_back(pattern.substr(start, end - start));
+                }
+                start = end + 1;
+            }
+            return segments;
+        }
+
+        // 切分请求路径（忽略查询字符串和空片段），不拷贝字符串
+        static void splitPath(const std::string& path, std::vector<std::pair<const char*, size_t>>& segments) {
+            size_t length = path.find('?');
+            if (length == std::string::npos) {
+                length = path.size();
+            }
+            size_t start = 0;
+            while (start < length) {
+                size_t end = path.find('/', start);
+                if (end == std::string::npos || end > length) {
+                    end = length;
+                }
+                if (end > start) {
+                    segments.push_back(std::make_pair(path.data() + start, end - start));
+                }
+                start = end + 1;
+            }
+        }
+
+        // 解析整数片段，只接受不超过int范围的数字
+        static bool parseInt(const char* data, size_t size, int& value) {
+            if (size == 0 || size > 10) {
+                return false;
+            }
+            long long result = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (data[i] < '0' || data[i] > '9') {
+                    return false;
+                }
+                result = result * 10 + (data[i] - '0');
+            }
+            if (result > INT_MAX) {
+                return false;
+            }
+            value = static_cast<int>(result);
+            return true;
+        }
+
+        static const Handler* matchNode(const Node* node, const std::string& method,
+                                        const std::vector<std::pair<const char*, size_t>>& segments,
+                                        size_t index, PathParams& params) {
+            if (index == segments.size()) {
+                auto it = node->handlers.find(method);
+                return it != node->handlers.end() ? &it->second : nullptr;
+            }
+
+            const char* data = segments[index].first;
+            size_t size = segments[index].second;
+
+            // 静态片段优先
+            auto child = node->children.find(std::string(data, size));
+            if (child != node->children.end()) {
+                const Handler* handler = matchNode(child->second.get(), method, segments, index + 1, params);
+                if (handler) {
+                    return handler;
+                }
+            }
+
+            // 参数片段
+            if (node->param_child) {
+                if (node->param_type == PathParamType::INT) {
+                    int value = 0;
+                    if (!parseInt(data, size, value)) {
+                        return nullptr;
+                    }
+                    const Handler* handler = matchNode(node->param_child.get(), method, segments, index + 1, params);
+                    if (handler) {
+                        params.ints[node->param_name] = value;
+                    }
+                    return handler;
+                }
+
+                const Handler* handler = matchNode(node->param_child.get(), method, segments, index + 1, params);
+                if (handler) {
+                    params.strings[node->param_name] = std::string(data, size);
+                }
+                return handler;
+            }
+
+            return nullptr;
+        }
+    };
+}
+
+#endif // ROUTER_H
@@ -0,0 +1,226 @@
+#ifndef SERVER_CONFIG_H
+#define SERVER_CONFIG_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <thread>
+#include <algorithm>
+#include <json/json.h>
+#include "../httplib/httplib.h"
+#include "compression.h"
+
+// 默认配置文件路径（不存在时使用内置默认值）
+#define DEFAULT_SERVER_CONFIG_FILE "config/server.json"
+
+// 默认请求体大小上限（字节）
+#define DEFAULT_MAX_PAYLOAD_LENGTH (16 * 1024 * 1024)
+
+namespace http {
+
+    // HTTP服务器配置
+    // 优先级：命令行参数 > 配置文件 > 内置默认值
+    struct ServerConfig {
+        uint16_t port = 8080;
+        // 工作线程数
+        size_t worker_threads = (std::max)(8u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() - 1 : 0);
+        // 等待工作线程处理的连接队列上限，超过后返回503（0表示不限制）
+        size_t max_queued_requests = 256;
+        // 单个长连接最多处理的请求数
+        size_t keep_alive_max_count = CPPHTTPLIB_KEEPALIVE_MAX_COUNT;
+        // 长连接空闲超时（秒）
+        time_t keep_alive_timeout_sec = CPPHTTPLIB_KEEPALIVE_TIMEOUT_SECOND;
+        // 读写超时（秒）
+        time_t read_timeout_sec = CPPHTTPLIB_SERVER_READ_TIMEOUT_SECOND;
+        time_t write_timeout_sec = CPPHTTPLIB_SERVER_WRITE_TIMEOUT_SECOND;
+        // 请求体大小上限（字节），超过时直接返回413
+        size_t max_payload_length = DEFAULT_MAX_PAYLOAD_LENGTH;
+        // 是否启用响应压缩（gzip/deflate）
+        bool enable_compression = true;
+        // 响应压缩阈值（字节）
+        size_t compression_min_size = DEFAULT_COMPRESSION_MIN_SIZE;
+        // 压缩结果缓存容量（字节），0表示不缓存
+        size_t compression_cache_bytes = DEFAULT_COMPRESSION_CACHE_BYTES;
+        // JWT共享密钥（HS256），为空时使用内置默认值
+        std::string jwt_secret;
+        // JWT签名私钥文件（PEM，P-256或Ed25519），配置后改用ES256/EdDSA签名
+        std::string jwt_signing_key;
+        // 轮换期间仍需接受的旧密钥文件
+        std::vector<std::string> jwt_verify_keys;
+
+        // 从JSON配置文件加载，文件中缺省的字段保持原值
+        bool loadFromFile(const std::string& path, std::string& error_message) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                error_message = "无法打开配置文件: " + path;
+                return false;
+            }
+
+            Json::Value root;
+            Json::CharReaderBuilder builder;
+            std::string errors;
+            if (!Json::parseFromStream(builder, file, &root, &errors) || !root.isObject()) {
+                error_message = "配置文件格式错误: " + errors;
+                return false;
+            }
+
+            try {
+                if (root.isMember("port")) port = static_cast<uint16_t>(root["port"].asUInt());
+                if (root.isMember("worker_threads")) worker_threads = root["worker_threads"].asUInt();
+                if (root.isMember("max_queued_requests")) max_queued_requests = root["max_queued_requests"].asUInt();
+                if (root.isMember("keep_alive_max_count")) keep_alive_max_count = root["keep_alive_max_count"].asUInt();
+                if (root.isMember("keep_alive_timeout")) keep_alive_timeout_sec = root["keep_alive_timeout"].asInt();
+                if (root.isMember("read_timeout")) read_timeout_sec = root["read_timeout"].asInt();
+                if (root.isMember("write_timeout")) write_timeout_sec = root["write_timeout"].asInt();
+                if (root.isMember("max_payload_length")) max_payload_length = root["max_payload_length"].asUInt64();
+                if (root.isMember("enable_compression")) enable_compression = root["enable_compression"].asBool();
+                if (root.isMember("compression_min_size")) compression_min_size = root["compression_min_size"].asUInt64();
+                if (root.isMember("compression_cache_bytes")) compression_cache_bytes = root["compression_cache_bytes"].asUInt64();
+                if (root.isMember("jwt_secret")) jwt_secret = root["jwt_secret"].asString();
+                if (root.isMember("jwt_signing_key")) jwt_signing_key = root["jwt_signing_key"].asString();
+                if (root.isMember("jwt_verify_keys")) {
+                    jwt_verify_keys.clear();
+                    for (const auto& item : root["jwt_verify_keys"]) {
+                        jwt_verify_keys.push_back(item.asString());
+                    }
+                }
+            } catch (const std::exception& e) {
+                error_message = std::string("配置项类型错误: ") + e.what();
+                return false;
+            }
+
+            return validate(error_message);
+        }
+
+        // 解析命令行参数，--config 指定的文件先于其他参数加载
+        bool parseArgs(int argc, char** argv, std::string& error_message) {
+            std::string config_file;
+            bool explicit_config = false;
+            for (int i = 1; i < argc; i++) {
+                if (std::string(argv[i]) == "--config" && i + 1 < argc) {
+                    config_file = argv[i + 1];
+                    explicit_config = true;
+                    break;
+                }
+            }
+
+            if (!explicit_config) {
+                std::ifstream probe(DEFAULT_SERVER_CONFIG_FILE);
+                if (probe.good()) {
+                    config_file = DEFAULT_SERVER_CONFIG_FILE;
+                }
+            }
+
+            if (!config_file.empty()) {
+                if (!loadFromFile(config_file, error_message)) {
+                    return false;
+                }
+                std::cout << "已加载服务器配置文件: " << config_file << std::endl;
+            }
+
+            for (int i = 1; i < argc; i++) {
+                std::string arg = argv[i];
+                if (i + 1 >= argc) {
+                    break;
+                }
+                std::string value = argv[i + 1];
+
+                try {
+                    if (arg == "--config") {
+                        // 已在上面处理
+                    } else if (arg == "--port") {
+                        port = static_cast<uint16_t>(std::stoi(value));
+                    } else if (arg == "--threads") {
+                        worker_threads = std::stoul(value);
+                    } else if (arg == "--queue-depth") {
+                        max_queued_requests = std::stoul(value);
+                    } else if (arg == "--keep-alive-max") {
+                        keep_alive_max_count = std::stoul(value);
+                    } else if (arg == "--keep-alive-timeout") {
+                        keep_alive_timeout_sec = std::stol(value);
+                    } else if (arg == "--read-timeout") {
+                        read_timeout_sec = std::stol(value);
+                    } else if (arg == "--write-timeout") {
+                        write_timeout_sec = std::stol(value);
+                    } else if (arg == "--max-payload") {
+                        max_payload_length = std::stoull(value);
+                    } else if (arg == "--compression") {
+                        enable_compression = (value == "1" || value == "on" || value == "true");
+                    } else if (arg == "--compression-min-size") {
+                        compression_min_size = std::stoull(value);
+                    } else if (arg == "--compression-cache") {
+                        compression_cache_bytes = std::stoull(value);
+                    } else if (arg == "--jwt-secret") {
+                        jwt_secret = value;
+                    } else if (arg == "--jwt-key") {
+                        jwt_signing_key = value;
+                    } else if (arg == "--jwt-verify-keys") {
+                        // 逗号分隔的多个文件
+                        jwt_verify_keys.clear();
+                        std::stringstream stream(value);
+                        std::string path;
+                        while (std::getline(stream, path, ',')) {
+                            if (!path.empty()) {
+                                jwt_verify_keys.push_back(path);
+                            }
+                        }
+                    } else {
+                        continue;
+                    }
+                } catch (const std::exception& e) {
+                    error_message = "无效的参数值: " + arg + " " + value;
+                    return false;
+                }
+                i++; // 跳过参数值
+            }
+
+            return validate(error_message);
+        }
+
+        // 校验配置取值
+        bool validate(std::string& error_message) const {
+            if (worker_threads == 0) {
+                error_message = "工作线程数必须大于0";
+                return false;
+            }
+            if (keep_alive_max_count == 0) {
+                error_message = "keep_alive_max_count必须大于0";
+                return false;
+            }
+            if (keep_alive_timeout_sec < 0 || read_timeout_sec <= 0 || write_timeout_sec <= 0) {
+                error_message = "超时时间配置无效";
+                return false;
+            }
+            if (max_payload_length == 0) {
+                error_message = "max_payload_length必须大于0";
+                return false;
+            }
+            if (!jwt_verify_keys.empty() && jwt_signing_key.empty()) {
+                error_message = "配置jwt_verify_keys时必须同时配置jwt_signing_key";
+                return false;
+            }
+            return true;
+        }
+
+        // 打印当前配置
+        void print() const {
+            std::cout << "服务器配置: 端口=" << port
+                      << ", 工作线程=" << worker_threads
+                      << ", 队列上限=" << max_queued_requests
+                      << ", 长连接最大请求数=" << keep_alive_max_count
+                      << ", 长连接超时=" << keep_alive_timeout_sec << "s"
+                      << ", 读超时=" << read_timeout_sec << "s"
+                      << ", 写超时=" << write_timeout_sec << "s"
+                      << ", 最大请求体=" << max_payload_length << "字节"
+                      << ", 响应压缩=" << (enable_compression ? "开启" : "关闭")
+                      << ", 压缩阈值=" << compression_min_size << "字节"
+                      << ", 压缩缓存=" << compression_cache_bytes << "字节"
+                      << ", JWT签名=" << (jwt_signing_key.empty() ? "HS256" : "非对称密钥") << std::endl;
+        }
+    };
+}
+
+#endif // SERVER_CONFIG_H
@@ -0,0 +1,74 @@
+#ifndef TASK_QUEUE_H
+#define TASK_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <functional>
+#include "../httplib/httplib.h"
+
+// 过载时负责快速返回503的线程数及其等待队列上限
+#define SHED_THREAD_COUNT 1
+#define SHED_QUEUE_DEPTH 64
+
+namespace http {
+
+    // 带过载保护的任务队列
+    // 正常连接交给有界的工作线程池处理；工作队列已满时，连接转交给单独的降级线程，
+    // 该线程只读取请求并立即返回503，避免请求无限排队。降级线程也繁忙时直接关闭连接。
+    class SheddingTaskQueue : public httplib::TaskQueue {
+    public:
+        SheddingTaskQueue(size_t worker_threads, size_t max_queued_requests)
+            : workers_(new httplib::ThreadPool(worker_threads, max_queued_requests)),
+              shedder_(new httplib::ThreadPool(SHED_THREAD_COUNT, SHED_QUEUE_DEPTH)) {}
+
+        bool enqueue(std::function<void()> fn) override {
+            if (workers_->enqueue(fn)) {
+                return true;
+            }
+
+            shedCounter()++;
+            return shedder_->enqueue([fn]() {
+                ShedScope scope;
+                fn();
+            });
+        }
+
+        void shutdown() override {
+            workers_->shutdown();
+            shedder_->shutdown();
+        }
+
+        // 当前线程是否正在处理被降级的连接
+        static bool isShedding() {
+            return shedding();
+        }
+
+        // 累计被降级的连接数
+        static size_t shedCount() {
+            return shedCounter().load();
+        }
+
+    private:
+        std::unique_ptr<httplib::ThreadPool> workers_;
+        std::unique_ptr<httplib::ThreadPool> shedder_;
+
+        // 头文件实现，计数器和标记使用函数内静态变量
+        static std::atomic<size_t>& shedCounter() {
+            static std::atomic<size_t> counter(0);
+            return counter;
+        }
+
+        static bool& shedding() {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        // 在降级线程中执行任务期间设置标记
+        struct ShedScope {
+            ShedScope() { shedding() = true; }
+            ~ShedScope() { shedding() = false; }
+        };
+    };
+}
+
+#endif // TASK_QUEUE_H
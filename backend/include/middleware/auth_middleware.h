@@ -2,6 +2,7 @@
 #define AUTH_MIDDLEWARE_H
 
 #include "../http/http_server.h"
+#include "../http/json_writer.h"
 #include "../utils/jwt.h"
 #include <string>
 #include <functional>
@@ -20,29 +21,24 @@ namespace middleware {
                 res.status_code = 401;
                 res.status_message = "Unauthorized";
                 
-                Json::Value response;
-                response["status"] = "error";
-                response["message"] = "未提供有效的认证令牌";
-                res.json(Json::writeString(Json::StreamWriterBuilder(), response));
+                res.json(http::JsonWriter::statusMessage("error", "未提供有效的认证令牌"));
                 return false;
             }
             
             // 提取令牌
             std::string token = auth_header.substr(7);
             
-            // 验证令牌
-            std::map<std::string, std::string> payload;
-            if (!JWT::verifyToken(token, payload)) {
+            // 验证令牌（命中缓存时不再重复解码和计算签名），声明随请求传给处理器
+            std::shared_ptr<const TokenClaims> claims = JWT::verifyClaims(token);
+            if (!claims) {
                 res.status_code = 401;
                 res.status_message = "Unauthorized";
                 
-                Json::Value response;
-                response["status"] = "error";
-                response["message"] = "认证令牌无效或已过期";
-                res.json(Json::writeString(Json::StreamWriterBuilder(), response));
+                res.json(http::JsonWriter::statusMessage("error", "认证令牌无效或已过期"));
                 return false;
             }
             
+            req.claims = claims;
             return true;
         }
         
@@ -53,21 +49,14 @@ namespace middleware {
                 return false;
             }
             
-            // 从请求头获取令牌
-            std::string auth_header = req.get_header("Authorization");
-            std::string token = auth_header.substr(7);
-            
             // 获取用户角色
-            int role = JWT::getUserRoleFromToken(token);
+            int role = req.claims->role;
             
             if (role < required_role) {
                 res.status_code = 403;
                 res.status_message = "Forbidden";
                 
-                Json::Value response;
-                response["status"] = "error";
-                response["message"] = "没有足够权限执行此操作";
-                res.json(Json::writeString(Json::StreamWriterBuilder(), response));
+                res.json(http::JsonWriter::statusMessage("error", "没有足够权限执行此操作"));
                 return false;
             }
             
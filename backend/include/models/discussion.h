@@ -3,7 +3,18 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <ctime>
+#include <json/json.h>
+
+// 一次回复树请求最多返回的回复数（顶层回复和各层子回复合计）
+#define REPLY_TREE_MAX_NODES 500
+
+// 回复树最多展开的子回复层数
+#define REPLY_TREE_MAX_DEPTH 2
+
+// 回复树中每条回复最多返回的子回复数
+#define REPLY_TREE_MAX_CHILDREN 20
 
 // 讨论帖子类
 class Discussion {
@@ -55,8 +66,8 @@ public:
     // 从JSON字符串加载讨论
     static Discussion fromJson(const std::string& json);
     
-    // 转换为JSON字符串
-    std::string toJson() const;
+    // 转换为JSON对象，直接嵌入响应，避免序列化后再解析
+    Json::Value toJson() const;
 };
 
 // 讨论回复类
@@ -103,8 +114,25 @@ public:
     // 从JSON字符串加载回复
     static DiscussionReply fromJson(const std::string& json);
     
-    // 转换为JSON字符串
-    std::string toJson() const;
+    // 转换为JSON对象，直接嵌入响应，避免序列化后再解析
+    Json::Value toJson() const;
+};
+
+// 回复树节点
+struct DiscussionReplyNode {
+    DiscussionReply reply;
+    int child_count = 0;                        // 子回复总数（children 可能被截断）
+    std::vector<DiscussionReplyNode> children;  // 按创建时间排序的子回复
+};
+
+// 讨论的累计互动数据，用于初始化热度排行
+struct DiscussionActivity {
+    int id = 0;
+    int problem_id = 0;
+    int views = 0;
+    int likes = 0;
+    int replies = 0;
+    std::time_t created_at = 0;
 };
 
 // 讨论数据访问对象，处理讨论相关的数据库操作
@@ -116,10 +144,16 @@ public:
     // 通过ID获取讨论
     static Discussion getDiscussionById(int id);
     
+    // 获取讨论已写回数据库的浏览量和点赞数，讨论不存在或查询失败时返回false
+    static bool getDiscussionCounters(int id, int& views, int& likes);
+    
     // 更新讨论信息
     static bool updateDiscussion(const Discussion& discussion);
     
-    // 删除讨论
+    // 批量累加浏览量（讨论ID -> 增量），一条UPDATE完成
+    static bool incrementDiscussionViews(const std::map<int, int>& increments);
+    
+    // 删除讨论，同时清理讨论及其回复的点赞记录
     static bool deleteDiscussion(int id);
     
     // 获取所有讨论
@@ -134,6 +168,14 @@ public:
     // 获取热门讨论（按浏览量或点赞数排序）
     static std::vector<Discussion> getHotDiscussions(int limit = 10);
     
+    // 按ID批量获取讨论（结果顺序不保证与ids一致，不存在的ID被忽略）
+    // 任一批查询失败时返回false，此时 discussions 不完整；with_content 为false时不读取正文
+    static bool getDiscussionsByIds(const std::vector<int>& ids, std::vector<Discussion>& discussions,
+                                    bool with_content = true);
+    
+    // 获取最近创建的讨论的浏览、点赞和回复数
+    static std::vector<DiscussionActivity> getRecentDiscussionActivity(int limit);
+    
     // 创建讨论回复
     static bool createDiscussionReply(DiscussionReply& reply);
     
@@ -152,8 +194,23 @@ public:
     // 获取回复的子回复
     static std::vector<DiscussionReply> getChildReplies(int parent_id, int offset = 0, int limit = 10);
     
+    // 加载一页顶层回复及其子回复树
+    // 每层执行一次子回复计数和一次按父回复分别 LIMIT 的查询，max_depth 为子回复层数，max_children 为每条回复保留的子回复数；
+    // 整棵树最多 REPLY_TREE_MAX_NODES 条回复，用完后不再展开后续的回复和层
+    static std::vector<DiscussionReplyNode> getReplyTree(int discussion_id, int offset = 0, int limit = 20,
+                                                         int max_depth = 1, int max_children = 10);
+    
     // 获取用户的所有回复
     static std::vector<DiscussionReply> getRepliesByUserId(int user_id, int offset = 0, int limit = 10);
+    
+    // 写入点赞记录（target_type：0-讨论，1-回复），目标不存在或已点赞时 inserted 为false
+    static bool addLike(int user_id, int target_type, int target_id, bool& inserted);
+    
+    // 删除点赞记录，未点赞时 deleted 为false
+    static bool removeLike(int user_id, int target_type, int target_id, bool& deleted);
+    
+    // 批量累加点赞数（目标ID -> 增量），一条UPDATE完成
+    static bool incrementLikes(int target_type, const std::map<int, int>& deltas);
 };
 
 #endif // DISCUSSION_H 
\ No newline at end of file
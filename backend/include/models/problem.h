@@ -6,6 +6,9 @@
 #include <ctime>
 #include <json/json.h>
 
+// 题目状态：删除中（后台正在清理关联数据，对外视为不存在）
+#define PROBLEM_STATUS_DELETING (-1)
+
 // 题目难度枚举
 enum class ProblemDifficulty {
     EASY = 0,       // 简单
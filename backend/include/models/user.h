@@ -5,6 +5,7 @@
 #include <map>
 #include <ctime>
 #include <vector>
+#include <json/json.h>
 
 // 用户状态枚举
 enum class UserStatus {
@@ -84,8 +85,8 @@ public:
         updated_at_ = last_login_;
     }
     
-    // 转换为JSON字符串（不包括敏感信息）
-    std::string toJson() const;
+    // 转换为JSON对象（不包括敏感信息）
+    Json::Value toJson() const;
     
     // 从数据库结果集创建用户对象
     static User fromDatabaseResult(void* result, int row);
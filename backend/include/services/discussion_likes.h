@@ -0,0 +1,49 @@
+#ifndef DISCUSSION_LIKES_H
+#define DISCUSSION_LIKES_H
+
+#include <string>
+
+// 点赞计数写回间隔（毫秒）
+#define LIKE_FLUSH_INTERVAL_MS 2000
+
+// 单条UPDATE语句最多合并的目标数
+#define LIKE_FLUSH_BATCH 500
+
+// 点赞目标类型，取值与 discussion_likes.target_type 一致
+enum class LikeTarget {
+    DISCUSSION = 0,
+    REPLY = 1
+};
+
+// 设置点赞状态的结果
+enum class LikeStatus {
+    OK,             // 已设置（包括状态本来就相同）
+    NOT_FOUND,      // 讨论或回复不存在
+    DB_ERROR        // 数据库错误
+};
+
+// 讨论与回复的点赞
+// 每个用户对每个目标的点赞记录在 discussion_likes 表中，(user_id, target_type, target_id) 为主键，
+// 点赞用 INSERT IGNORE、取消用 DELETE，是否真正改变由影响行数决定，重复请求天然幂等，
+// 多个实例之间、目标被删除后也不会出现不一致，因此不在内存中缓存点赞状态。
+// 只有状态确实变化时才累计计数增量，由后台线程定期批量写回 likes 列，热门帖子的点赞不再逐次锁同一行。
+class DiscussionLikes {
+public:
+    // 启动后台写回线程
+    static void start();
+
+    // 停止后台线程，并写回剩余的计数
+    static void stop();
+
+    // 设置点赞状态；changed 表示状态是否发生变化，失败时 error_message 为错误信息
+    static LikeStatus setLiked(int user_id, LikeTarget target, int target_id, bool liked, bool& changed,
+                         std::string& error_message);
+
+    // 尚未写回数据库的点赞数增量
+    static int pendingDelta(LikeTarget target, int target_id);
+
+    // 立即写回累计的点赞数增量
+    static void flush();
+};
+
+#endif // DISCUSSION_LIKES_H
@@ -0,0 +1,41 @@
+#ifndef DISCUSSION_VIEW_COUNTER_H
+#define DISCUSSION_VIEW_COUNTER_H
+
+#include <map>
+
+// 计数分片数，每个分片独立加锁
+#define VIEW_COUNTER_SHARDS 16
+
+// 后台写回间隔（毫秒）
+#define VIEW_COUNTER_FLUSH_INTERVAL_MS 5000
+
+// 单条UPDATE语句最多合并的讨论数
+#define VIEW_COUNTER_FLUSH_BATCH 500
+
+// 讨论浏览量的延迟写回计数器
+// 浏览只在内存中按讨论ID分片累加，后台线程定期取走累计值，
+// 用一条 UPDATE ... SET views = views + CASE id ... END 批量写回，热门讨论的每次浏览不再对应一次数据库写入。
+// 浏览量不计入讨论的缓存版本，写回时不更新版本号。
+class DiscussionViewCounter {
+public:
+    // 启动后台写回线程
+    static void start();
+
+    // 停止后台线程，并写回剩余的计数
+    static void stop();
+
+    // 记录一次浏览
+    static void record(int discussion_id);
+
+    // 尚未写回数据库的浏览次数
+    static int pending(int discussion_id);
+
+    // 立即写回所有累计的浏览量，写回失败的计数保留到下次重试
+    static void flush();
+
+private:
+    // 取出并清空所有分片的计数
+    static std::map<int, int> drain();
+};
+
+#endif // DISCUSSION_VIEW_COUNTER_H
@@ -0,0 +1,62 @@
+#ifndef HOT_DISCUSSIONS_H
+#define HOT_DISCUSSIONS_H
+
+#include <map>
+#include <vector>
+#include "../models/discussion.h"
+
+// 每个排行（全站或单个题目）保留的讨论数
+#define HOT_DISCUSSIONS_TOP_K 50
+
+// 热度半衰期（小时）
+#define HOT_DISCUSSIONS_HALF_LIFE_HOURS 24
+
+// 排行快照刷新间隔（毫秒）
+#define HOT_DISCUSSIONS_REFRESH_MS 10000
+
+// 启动时载入互动数据的讨论数上限（按创建时间倒序）
+#define HOT_DISCUSSIONS_SEED_LIMIT 10000
+
+// 各类互动的热度权重
+#define HOT_WEIGHT_VIEW 1.0
+#define HOT_WEIGHT_LIKE 5.0
+#define HOT_WEIGHT_REPLY 10.0
+#define HOT_WEIGHT_CREATE 10.0
+
+// 热门讨论排行
+// 热度为各次互动权重按时间指数衰减后的和。实现上采用前向衰减：互动发生在t时记入 w * e^((t - base) / tau)，
+// 随时间推移无需逐个更新旧分数，排序关系保持不变；base 过旧时统一缩放一次。
+// 分数保存在全站和按题目划分的有序集合中，浏览（经浏览量计数器批量送入）、点赞、回复时增量调整；
+// 后台线程定期取出各排行前K名生成只读快照，查询时直接读取快照。成员和顺序未变化的排行沿用上一份快照，
+// 只有新进入排行的讨论才从数据库加载（不含正文），因此快照中的浏览、点赞数是该讨论进入排行时的值。
+class HotDiscussions {
+public:
+    // 从数据库载入初始热度、生成首个快照并启动后台刷新线程
+    static void start();
+
+    // 停止后台刷新线程
+    static void stop();
+
+    // 记录一批浏览（讨论ID -> 次数）
+    static void addViews(const std::map<int, int>& views);
+
+    // 记录点赞（delta 为 +1 或 -1）
+    static void recordLike(int discussion_id, int delta);
+
+    // 记录新回复
+    static void recordReply(int discussion_id);
+
+    // 记录新讨论
+    static void recordCreated(int discussion_id, int problem_id);
+
+    // 移除已删除的讨论
+    static void remove(int discussion_id);
+
+    // 获取热门讨论，problem_id 为0时返回全站排行
+    static std::vector<Discussion> get(int problem_id, int limit);
+
+    // 立即重新生成快照
+    static void refresh();
+};
+
+#endif // HOT_DISCUSSIONS_H
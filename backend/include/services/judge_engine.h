@@ -7,6 +7,7 @@
 #include <iomanip>  // 为visualizeString添加
 #include "../models/submission.h"
 #include "../models/problem.h"
+#include "toolchain_registry.h"
 
 // 编译结果结构体
 struct CompileResult {
@@ -70,13 +71,17 @@ public:
     
 private:
     // 编译代码
-    CompileResult compileCode(const std::string& source_code, const std::string& language, const std::string& compile_dir);
+    CompileResult compileCode(const std::string& source_code, const Toolchain& toolchain, const std::string& compile_dir);
     
-    // 执行程序
-    ExecutionResult executeProgram(const std::string& executable_path, const std::string& input, int time_limit_ms, int memory_limit_kb);
+    // 执行程序，arguments 为运行命令及其参数；limit_address_space 为false时不设置RLIMIT_AS，
+    // 改为把 RLIMIT_DATA 设为内存限制加 data_reserve_kb，防止失控的运行时耗尽内存，超限按实际占用判定
+    ExecutionResult executeProgram(const std::vector<std::string>& arguments, const std::string& input, int time_limit_ms, int memory_limit_kb, bool limit_address_space, int data_reserve_kb);
+    
+    // 在常驻运行时中执行程序（见 WarmRunner），运行时不可用时返回false
+    bool executeWarmProgram(const Toolchain& toolchain, const std::string& program_path, const std::string& input, int time_limit_ms, int memory_limit_kb, ExecutionResult& result);
     
     // 执行测试用例
-    TestPointExecutionResult executeTestCase(int test_case_id, const std::string& executable_path, const TestCase& testcase, int time_limit_ms, int memory_limit_kb);
+    TestPointExecutionResult executeTestCase(int test_case_id, const Toolchain& toolchain, const std::string& dir, const TestCase& testcase, int time_limit_ms, int memory_limit_kb);
     
     // 判断输出是否正确
     bool checkOutput(const std::string& output, const std::string& expected);
@@ -88,13 +93,13 @@ private:
     std::string createTempDir(int submission_id);
     
     // 创建源代码文件
-    std::string createSourceFile(const std::string& source_code, const std::string& language, const std::string& dir);
+    std::string createSourceFile(const std::string& source_code, const Toolchain& toolchain, const std::string& dir);
     
     // 获取编译命令
-    std::string getCompileCommand(const std::string& source_file, const std::string& language);
+    std::string getCompileCommand(const Toolchain& toolchain, const std::string& dir);
     
-    // 获取执行命令
-    std::string getExecuteCommand(const std::string& executable_file, const std::string& language);
+    // 获取执行命令及参数，memory_limit_kb 为题目内存限制
+    std::vector<std::string> getExecuteCommand(const Toolchain& toolchain, const std::string& dir, int memory_limit_kb);
     
     // 获取评测结果的字符串描述
     std::string getJudgeResultString(JudgeResult result);
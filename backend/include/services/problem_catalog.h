@@ -0,0 +1,58 @@
+#ifndef PROBLEM_CATALOG_H
+#define PROBLEM_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <json/json.h>
+
+// 题目摘要，列表页只需要这些字段
+struct ProblemSummary {
+    int id;                        // 题目ID
+    std::string title;             // 标题
+    std::string difficulty;        // 难度
+    int time_limit;                // 时间限制（毫秒）
+    int memory_limit;              // 内存限制（KB）
+    int status;                    // 状态（1启用，0禁用）
+    int created_by;                // 创建者ID
+    int64_t created_at;            // 创建时间
+    int64_t updated_at;            // 更新时间
+
+    ProblemSummary() : id(0), time_limit(1000), memory_limit(65536), status(1), created_by(0),
+                       created_at(0), updated_at(0) {}
+
+    // 转换为列表项JSON
+    Json::Value toJson() const;
+};
+
+// 题目目录
+// 内存中保存全部题目的摘要（不含描述、代码模板、样例等大字段），按ID降序排列，列表和筛选请求不再查询数据库。
+// 目录是不可变的快照，读者原子地取得当前快照的指针后无锁遍历；题目创建、更新、删除时复制一份修改后原子替换，
+// 写者之间串行。提交数、通过率等统计随评测频繁变化，不放在目录中，由 ProblemStats 提供。
+class ProblemCatalog {
+public:
+    typedef std::vector<ProblemSummary> Snapshot;
+
+    // 从数据库载入全部题目摘要
+    static bool build();
+
+    // 目录是否已建立
+    static bool ready();
+
+    // 重新读取单个题目的摘要（创建、更新后调用），题目不存在时从目录中移除
+    static void refresh(int problem_id);
+
+    // 移除题目
+    static void remove(int problem_id);
+
+    // 当前快照，未建立时为空指针
+    static std::shared_ptr<const Snapshot> snapshot();
+
+    // 筛选题目，difficulty 为空、status 小于0 表示不限；search 非空时按检索结果的相关度排序。
+    // page 为当前页，total 为符合条件的总数；目录或检索索引未建立时返回false
+    static bool list(const std::string& search, const std::string& difficulty, int status, int offset, int limit,
+                     std::vector<ProblemSummary>& page, int& total);
+};
+
+#endif // PROBLEM_CATALOG_H
@@ -0,0 +1,43 @@
+#ifndef PROBLEM_DELETION_H
+#define PROBLEM_DELETION_H
+
+#include <string>
+#include <vector>
+
+// 每批删除的行数（按主键删除，单个事务只锁住这些行）
+#define PROBLEM_DELETE_BATCH 500
+
+// 批次之间的间隔（毫秒），给其他事务让出锁和IO
+#define PROBLEM_DELETE_PAUSE_MS 20
+
+// 没有新任务时检查 problem_deletions 表的间隔（毫秒）
+#define PROBLEM_DELETE_POLL_MS 60000
+
+// 题目的后台删除
+// 删除题目时只在一个事务中把题目标记为删除中（status = PROBLEM_STATUS_DELETING）并在 problem_deletions 表登记任务，
+// 题目立即从列表、检索和详情中消失。后台线程按提交记录（连同测试点结果）、讨论回复、讨论、测试用例的顺序，
+// 每次取出一批主键在单独的事务中删除，最后删除题目本身和任务记录；每个阶段完成后记录进度，重启后从未完成的阶段继续。
+// 删除提交记录的同一事务中撤销它们对 users 计数和 user_daily_stats 分桶的贡献，提交后重新统计涉及用户的排名。
+class ProblemDeletion {
+public:
+    // 启动后台线程，继续未完成的删除任务
+    static void start();
+
+    // 停止后台线程，当前批次完成后退出，剩余的任务下次启动时继续
+    static void stop();
+
+    // 标记题目为删除中并登记删除任务；题目不存在或已在删除中时返回false
+    static bool schedule(int problem_id, std::string& error_message);
+
+private:
+    // 执行一个删除任务，从 stage 阶段开始；被停止时返回false
+    static bool runJob(int problem_id, int stage);
+
+    // 删除某个阶段的一批数据，返回删除的行数，出错时返回-1
+    static long long deleteBatch(int problem_id, int stage);
+
+    // 查询一批ID
+    static bool selectIds(const std::string& sql, std::vector<int>& ids);
+};
+
+#endif // PROBLEM_DELETION_H
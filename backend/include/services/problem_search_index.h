@@ -0,0 +1,37 @@
+#ifndef PROBLEM_SEARCH_INDEX_H
+#define PROBLEM_SEARCH_INDEX_H
+
+#include <string>
+#include <vector>
+
+// 单次查询最多使用的词数，多余的词忽略
+#define PROBLEM_SEARCH_MAX_TERMS 8
+
+// 标题命中的权重，描述中每次出现计1分，最多计 PROBLEM_SEARCH_BODY_CAP 次
+#define PROBLEM_SEARCH_TITLE_WEIGHT 5
+#define PROBLEM_SEARCH_BODY_CAP 5
+
+// 题目全文检索
+// 进程内倒排索引，覆盖题目标题和描述。英文和数字按词切分（不区分大小写），查询词按前缀匹配；
+// 连续的中日韩文字按单字和相邻两字切分，查询时对两字片段求交集，三字及以上的短语再在原文中校验。
+// 多个查询词之间为“且”的关系，结果按标题/描述命中次数与词的稀有程度加权排序，同分时新题目在前。
+// 题目创建、更新、删除时同步修改索引，查询不再扫描 problems 表。
+class ProblemSearchIndex {
+public:
+    // 从数据库载入全部题目建立索引
+    static bool build();
+
+    // 索引是否已建立
+    static bool ready();
+
+    // 添加或更新题目
+    static void update(int problem_id, const std::string& title, const std::string& description);
+
+    // 移除题目
+    static void remove(int problem_id);
+
+    // 检索题目，ids 为当前页的题目ID（按相关度排序），total 为命中总数；索引未建立时返回false
+    static bool search(const std::string& query, int offset, int limit, std::vector<int>& ids, int& total);
+};
+
+#endif // PROBLEM_SEARCH_INDEX_H
\ No newline at end of file
@@ -8,8 +8,9 @@
 
 class ProblemService {
 public:
-    // 获取所有题目（带分页）
-    static std::vector<Problem> getAllProblems(int offset = 0, int limit = 10, const std::string& search = "");
+    // 获取所有题目（带分页）；total 不为空时返回符合条件的题目总数，有搜索词时取本次检索的命中数，不再重复检索
+    static std::vector<Problem> getAllProblems(int offset = 0, int limit = 10, const std::string& search = "",
+                                               int* total = nullptr);
     
     // 获取题目详情
     static Problem getProblemById(int problem_id, bool with_testcases = false);
@@ -43,6 +44,16 @@ public:
     
     // 检查用户是否有权限操作题目（创建者或管理员）
     static bool checkProblemPermission(int problem_id, int user_id, int user_role);
+    
+    // 获取题目的最后更新时间（用于生成ETag，题目不存在时返回-1）
+    static int64_t getProblemUpdatedAt(int problem_id);
+    
+private:
+    // 获取测试用例所属的题目ID
+    static int getProblemIdByTestCaseId(int testcase_id);
+    
+    // 刷新题目的更新时间并递增题目缓存版本
+    static void touchProblemUpdatedAt(int problem_id);
 };
 
 #endif // PROBLEM_SERVICE_H 
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef PROBLEM_STATS_H
+#define PROBLEM_STATS_H
+
+#include <vector>
+#include <cstdint>
+#include <json/json.h>
+#include "../models/submission.h"
+
+// 计入直方图的评测结果数（ACCEPTED 到 SYSTEM_ERROR）
+#define PROBLEM_VERDICT_KINDS 7
+
+// 计数写回间隔（毫秒）
+#define PROBLEM_STATS_FLUSH_INTERVAL_MS 5000
+
+// 单条语句最多写入的题目数
+#define PROBLEM_STATS_FLUSH_BATCH 500
+
+// 单个题目的提交统计
+struct ProblemStatsItem {
+    int submission_count;                          // 已评测的提交数
+    int solver_count;                              // 通过该题的用户数
+    int verdict_counts[PROBLEM_VERDICT_KINDS];     // 各评测结果的提交数，下标为 结果 - ACCEPTED
+
+    ProblemStatsItem() : submission_count(0), solver_count(0) {
+        for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+            verdict_counts[i] = 0;
+        }
+    }
+
+    int acceptedCount() const { return verdict_counts[0]; }
+
+    // 累加另一份统计
+    void add(const ProblemStatsItem& other);
+
+    // 减去另一份统计
+    void subtract(const ProblemStatsItem& other);
+
+    // 写入题目JSON：submission_count / accepted_count / solver_count / acceptance_rate，
+    // with_verdicts 为true时附带 verdict_counts
+    void writeJson(Json::Value& json, bool with_verdicts) const;
+};
+
+// 题目提交统计
+// 评测结束时在内存中累计增量，由后台线程定期合并写入 problem_stats 表，不再对提交记录做聚合。
+// 题目列表和详情读取内存中 problem_stats 表的副本，每次写回都在同一事务中递增 PROBLEM_STATS 缓存版本，
+// 版本变化（本实例或其他实例写回）后重新载入副本，因此同一版本号在各实例上对应相同的统计，可用于ETag。
+// 表为空时（首次部署）按已评测的提交记录在一个事务中回填；回填失败时暂停写回，由后台线程重试。
+class ProblemStats {
+public:
+    // 载入 problem_stats 表并启动后台写回线程
+    static void start();
+
+    // 停止后台线程，并写回剩余的增量
+    static void stop();
+
+    // 记录一次评测结果，first_solve 表示该用户首次通过此题
+    static void recordVerdict(int problem_id, JudgeResult result, bool first_solve);
+
+    // 获取已写回的题目统计，version 为这份统计对应的 PROBLEM_STATS 缓存版本
+    static ProblemStatsItem get(int problem_id, uint64_t& version);
+
+    // 批量获取已写回的题目统计，按 problem_ids 的顺序写入 stats，返回对应的缓存版本
+    static uint64_t get(const std::vector<int>& problem_ids, std::vector<ProblemStatsItem>& stats);
+
+    // 删除题目的统计
+    static void remove(int problem_id);
+
+    // 立即写回累计的增量
+    static void flush();
+
+private:
+    // 从提交记录回填 problem_stats 表
+    static bool backfill();
+
+    // 批量累加到 problem_stats 表，并递增缓存版本
+    static bool persistDeltas(const std::vector<std::pair<int, ProblemStatsItem>>& deltas);
+};
+
+#endif // PROBLEM_STATS_H
@@ -4,51 +4,114 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <ctime>
+#include <mysql/mysql.h>
 #include "../models/user.h"
 
+// 单页排名的最大条数
+#define RANKING_PAGE_LIMIT 100
+
+// 单条语句最多写入的排名行数
+#define RANKING_PERSIST_BATCH 500
+
+// 单用户更新的锁分段数，同一用户的重新统计按顺序执行
+#define RANKING_UPDATE_LOCKS 16
+
 // 用户排名项结构
 struct UserRankingItem {
     int user_id;                   // 用户ID
     std::string username;          // 用户名
     std::string avatar;            // 头像
     int solved_count;              // 解题数量
+    int attempted_count;           // 尝试过的题目数量
     int total_submissions;         // 总提交数
-    float acceptance_rate;         // 通过率
+    int easy_count;                // 已解决的简单题数量
+    int medium_count;              // 已解决的中等题数量
+    int hard_count;                // 已解决的困难题数量
+    float acceptance_rate;         // 通过率（已解决题目数 / 尝试过的题目数，百分比）
     int score;                     // 总分
     std::time_t last_submission;   // 最后提交时间
-    
+
     // 构造函数
-    UserRankingItem() : user_id(0), solved_count(0), total_submissions(0), 
+    UserRankingItem() : user_id(0), solved_count(0), attempted_count(0), total_submissions(0),
+                        easy_count(0), medium_count(0), hard_count(0),
                         acceptance_rate(0.0f), score(0), last_submission(0) {}
 };
 
+// 一次评测对用户统计的影响，由 user_problem_status 的写入结果确定
+struct VerdictDelta {
+    bool first_attempt;            // 首次提交该题
+    bool first_solve;              // 首次通过该题
+    std::string difficulty;        // 题目难度（首次通过时有效）
+
+    VerdictDelta() : first_attempt(false), first_solve(false) {}
+};
+
+// 排行榜
+// 总榜保存在内存中按（解题数降序，通过率降序，提交数升序，用户ID升序）排列的顺序统计树中，
+// 取分页和查询某个用户的名次都是 O(log n)；同时持久化到 user_rankings 表，启动时直接载入。
+// 评测结束后只重新统计该用户的数据并调整其在树中的位置，不再每次请求都对全部提交做聚合。
+// 日/周/月榜由 user_daily_stats 中按（日期，用户）累计的分桶求和得到，评测结束时更新当天的桶；
+// 时间段内的解题数指首次通过的题目数，通过率为通过的提交占比。
+// 评测结束时由 user_problem_status 的写入结果得知是否首次提交/首次通过，总榜和分桶都按增量调整，不再查询提交记录。
 class RankingService {
 public:
+    // 从 user_rankings 表载入排名，排名表尚未完整建立（init_markers 中无标记）或读取失败时从提交记录重建；
+    // 题目状态表和分桶表同样按标记决定是否从提交记录回填
+    static void initialize();
+
     // 获取用户排名列表
     static std::vector<UserRankingItem> getUserRankingList(int offset = 0, int limit = 10);
-    
+
     // 获取用户排名信息
     static UserRankingItem getUserRanking(int user_id);
-    
-    // 获取用户排名位置
+
+    // 获取用户排名位置（从1开始，不在排行榜中时返回0）
     static int getUserRankingPosition(int user_id);
-    
-    // 更新用户排名数据
+
+    // 参与排名的用户数
+    static int getRankedUserCount();
+
+    // 更新用户排名数据（评测结束、注册或角色变化后调用）
     static bool updateUserRanking(int user_id);
-    
+
     // 刷新所有用户排名数据
     static bool refreshAllRankings();
-    
+
+    // 按评测结果增量调整总榜，并累计到提交日期所在的分桶
+    static bool applyVerdict(int user_id, std::time_t submitted_at, bool accepted, const VerdictDelta& delta);
+
+    // 撤销一批提交对用户统计贡献时读取提交的查询，带 FOR UPDATE，需在删除这些提交的事务中执行
+    static std::string submissionRevocationQuery(const std::vector<int>& submission_ids);
+
+    // 按上面查询的结果生成撤销语句：users 的计数、user_daily_stats 的分桶，
+    // 以及首次通过时 user_problem_status 的通过状态。删除题目时与删除这些提交放在同一事务中执行；
+    // 提交需按ID升序分批传入，首次通过在最早的通过提交所在的批次撤销。user_ids 追加涉及的用户
+    static void buildSubmissionRevocation(MYSQL_RES* result, std::vector<std::string>& commands,
+                                          std::vector<int>& user_ids);
+
+    // 获取时间段排行（time_range 为 day / week / month）
+    static bool getWindowRankingList(const std::string& time_range, int offset, int limit,
+                                     std::vector<UserRankingItem>& items, int& total);
+
     // 获取排名统计信息
     static std::map<std::string, int> getRankingStats();
-    
+
 private:
-    // 计算用户分数
-    static int calculateUserScore(int user_id);
-    
+    // 从提交记录统计用户数据，ranked 为false表示用户不存在或不参与排名
+    static bool loadUserStats(int user_id, UserRankingItem& item, bool& ranked);
+
     // 更新排名表
-    static bool updateRankingTable(int user_id, int solved_count, int total_submissions, 
-                                 float acceptance_rate, int score, std::time_t last_submission);
+    static bool updateRankingTable(const std::vector<UserRankingItem>& items);
+
+    // 补全用户名和头像
+    static void fillUserInfo(std::vector<UserRankingItem>& items);
+
+    // 尚未回填过时按提交记录重建本月和本周的分桶数据
+    static bool backfillDailyStats();
+
+    // 尚未回填过时按提交记录重建用户题目状态表
+    static bool backfillProblemStatus();
 };
 
-#endif // RANKING_SERVICE_H 
\ No newline at end of file
+#endif // RANKING_SERVICE_H
\ No newline at end of file
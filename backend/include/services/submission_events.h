@@ -0,0 +1,54 @@
+#ifndef SUBMISSION_EVENTS_H
+#define SUBMISSION_EVENTS_H
+
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+// 推送流最多占用的HTTP工作线程比例（1/N），其余工作线程留给普通接口
+#define SUBMISSION_STREAM_WORKER_SHARE 2
+
+// 单个推送流的最长持续时间（秒），超时后客户端可凭 Last-Event-ID 重连
+#define SUBMISSION_STREAM_MAX_SECONDS 300
+
+// 推送流的心跳间隔（毫秒）
+#define SUBMISSION_STREAM_HEARTBEAT_MS 15000
+
+// 评测结束后事件在内存中保留的时间（秒），供晚到的订阅者回放
+#define SUBMISSION_EVENTS_RETAIN_SECONDS 60
+
+// 提交评测事件
+struct SubmissionEvent {
+    size_t seq;         // 事件序号，从1开始，对应SSE的id字段
+    std::string name;   // 事件名：status / progress / verdict
+    std::string data;   // 事件数据（紧凑JSON）
+};
+
+// 提交评测事件中心
+// 评测引擎在状态变化、每个测试点完成和得出最终结果时发布事件，
+// SSE订阅者按序号读取事件；每个提交的事件完整保留到评测结束后一段时间，重连时可从断点继续。
+class SubmissionEvents {
+public:
+    // 为即将评测的提交创建事件通道
+    static void open(int submission_id);
+
+    // 发布事件，final为true表示评测结束
+    static void publish(int submission_id, const std::string& name, const Json::Value& data, bool final = false);
+
+    // 提交是否有事件通道（评测中或刚结束）
+    static bool isTracked(int submission_id);
+
+    // 读取序号大于after_seq的事件，没有新事件时最多等待timeout_ms毫秒
+    // 返回false表示提交没有事件通道；finished表示评测已结束且事件已全部读出
+    static bool waitEvents(int submission_id, size_t after_seq, int timeout_ms,
+                           std::vector<SubmissionEvent>& events, bool& finished);
+
+    // 按HTTP工作线程数设置同时打开的推送流上限（每个流占用一个工作线程）
+    static void setStreamLimit(size_t worker_threads);
+
+    // 占用/释放一个推送流名额
+    static bool acquireStream();
+    static void releaseStream();
+};
+
+#endif // SUBMISSION_EVENTS_H
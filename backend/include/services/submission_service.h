@@ -6,6 +6,9 @@
 #include "../models/submission.h"
 #include <json/json.h>
 
+// 后台评测线程数
+#define JUDGE_WORKER_COUNT 2
+
 class SubmissionService {
 public:
     // 创建提交
@@ -59,6 +62,12 @@ public:
     static void stopJudgeThread();
 
 private:
+    // 评测单个提交（评测线程或同步模式下调用）
+    static void runJudge(int submission_id);
+    
+    // 重新排队上次运行时未评测完的提交（状态为等待评测或评测中）
+    static void requeueUnfinished();
+    
     // 验证提交数据
     static bool validateSubmission(const Submission& submission, std::string& error_message);
     
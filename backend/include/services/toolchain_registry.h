@@ -0,0 +1,70 @@
+#ifndef TOOLCHAIN_REGISTRY_H
+#define TOOLCHAIN_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include "../models/submission.h"
+
+// 工具链缓存目录（JVM类数据共享归档等预热产物）
+#define TOOLCHAIN_CACHE_DIR "/tmp/judge_engine/toolchains"
+
+// 语言工具链
+// 命令模板中的占位符：{dir} 评测工作目录，{src} 源文件，{exe} 编译产物，{cache} 缓存目录，
+// {mem_mb} 题目内存限制（MB），{warm} 预热成功时替换为 warm_options，否则为空
+struct Toolchain {
+    Language language;
+    std::string name;                  // 语言名称，与 Submission::getLanguageStr 一致
+    std::string source_file;           // 源文件名
+    std::string artifact;              // 编译产物文件名，运行命令中的 {exe}
+    std::string compile_command;       // 编译命令，解释型语言用于语法检查和预编译
+    std::string run_command;           // 运行命令，按空格切分为参数
+    std::string probe_command;         // 检查编译器/解释器是否已安装
+    std::string prepare_command;       // 启动时执行一次的预热命令，为空表示无需预热
+    std::string warm_options;          // 预热成功后加入运行命令的选项
+    std::string runner_command;        // 常驻运行时的启动命令，为空表示每个测试点冷启动，见 WarmRunner
+    std::string oom_marker;            // 运行时报告内存不足时错误输出中的标志，用于区分内存超限和运行错误
+    double time_multiplier;            // 时间限制倍数
+    int time_extra_ms;                 // 时间限制附加值（毫秒）
+    int memory_extra_kb;               // 内存限制附加值（KB），抵消运行时自身的常驻内存
+    bool limit_address_space;          // 是否用 RLIMIT_AS 限制内存；JVM和V8预留大量虚拟地址，改用堆参数限制并按实际占用判定
+    int data_reserve_kb;               // 不限制地址空间时，RLIMIT_DATA 在换算后的内存限制之上为运行时预留的量（KB）
+    bool available;                    // 编译器/解释器是否已安装
+    bool warmed;                       // 预热是否成功
+
+    Toolchain() : language(Language::CPP), time_multiplier(1.0), time_extra_ms(0), memory_extra_kb(0),
+                  limit_address_space(true), data_reserve_kb(0), available(false), warmed(false) {}
+
+    // 按倍数和附加值换算后的时间限制
+    int effectiveTimeLimit(int time_limit_ms) const;
+
+    // 换算后的内存限制
+    int effectiveMemoryLimit(int memory_limit_kb) const;
+};
+
+// 评测语言工具链注册表
+// 每种语言的编译、运行命令，时间/内存换算和预热方式集中登记在这里，评测引擎不再按语言硬编码。
+// 启动时检查各工具链是否已安装并执行一次预热（如生成JVM类数据共享归档），未安装的语言提交后返回系统错误。
+class ToolchainRegistry {
+public:
+    // 检查工具链并预热，只执行一次
+    static void initialize();
+
+    // 查找语言的工具链，未登记时返回nullptr
+    static const Toolchain* find(Language language);
+
+    // 全部工具链
+    static const std::vector<Toolchain>& all();
+
+    // 展开命令模板
+    static std::string expand(const std::string& command, const Toolchain& toolchain,
+                              const std::string& dir, int memory_limit_kb);
+
+    // 运行命令的参数列表
+    static std::vector<std::string> runArguments(const Toolchain& toolchain, const std::string& dir,
+                                                 int memory_limit_kb);
+
+    // 常驻运行时启动命令的参数列表
+    static std::vector<std::string> runnerArguments(const Toolchain& toolchain);
+};
+
+#endif // TOOLCHAIN_REGISTRY_H
@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include "../models/user.h"
+#include "ranking_service.h"
 #include <json/json.h>
 
 class UserService {
@@ -48,8 +49,8 @@ public:
                               int current_user_id, Json::Value& leaderboard_data, 
                               int& total, std::string& error_message);
     
-    // 更新用户排行榜统计信息
-    static bool updateUserLeaderboardStats(int user_id, int problem_id, bool is_accepted);
+    // 更新用户排行榜统计信息，delta 返回本次评测是否为首次提交/首次通过
+    static bool updateUserLeaderboardStats(int user_id, int problem_id, bool is_accepted, VerdictDelta& delta);
     
     // ===== 管理员用户管理相关服务方法 =====
     
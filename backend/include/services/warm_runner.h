@@ -0,0 +1,37 @@
+#ifndef WARM_RUNNER_H
+#define WARM_RUNNER_H
+
+#include <string>
+#include "toolchain_registry.h"
+
+// 是否启用常驻运行时，设为0时解释型语言的每个测试点都冷启动解释器
+#define WARM_RUNNER_ENABLED 1
+
+// 常驻运行时执行一个测试点的结果
+struct WarmRunStatus {
+    bool exited;            // 正常退出（否则被信号终止）
+    int code;               // 退出码或终止信号
+    int time_used_ms;       // 用户态CPU时间（毫秒），不含解释器启动
+    int wall_time_ms;       // 墙钟时间（毫秒）
+    int memory_used_kb;     // 最大常驻内存（KB）
+
+    WarmRunStatus() : exited(false), code(0), time_used_ms(0), wall_time_ms(0), memory_used_kb(0) {}
+};
+
+// 常驻运行时池
+// 解释器启动（初始化运行时、导入常用标准库模块）只在常驻进程启动时做一次。每个测试点由常驻进程fork出子进程，
+// 在子进程中重定向输入输出、设置资源限制后执行编译产物，子进程之间互不影响；子进程的资源统计从fork开始，
+// 测得的时间不含解释器启动，和原生程序一致。每个评测线程用完归还，池中的进程数不超过同时评测的线程数。
+// JVM和V8是多线程的运行时，fork后不能安全继续运行，仍按冷启动方式执行（见 ToolchainRegistry 中的预热选项）。
+class WarmRunner {
+public:
+    // 在常驻运行时中执行 program_path，输入输出为已创建的文件；运行时不可用或通信失败时返回false，调用方改为冷启动
+    static bool run(const Toolchain& toolchain, const std::string& program_path,
+                    const std::string& input_path, const std::string& output_path, const std::string& error_path,
+                    int time_limit_ms, int memory_limit_kb, WarmRunStatus& status);
+
+    // 结束所有常驻进程
+    static void stop();
+};
+
+#endif // WARM_RUNNER_H
@@ -0,0 +1,32 @@
+#ifndef CACHE_VERSION_H
+#define CACHE_VERSION_H
+
+#include <string>
+#include <cstdint>
+
+// 从数据库重新读取版本号的间隔（毫秒），其他实例的变更最迟在这段时间后反映到本实例的ETag
+#define CACHE_VERSION_REFRESH_MS 1000
+
+// 缓存版本计数器
+// 各类数据发生变更时递增对应计数器，用于生成ETag。版本号保存在 cache_versions 表中，
+// 多个后端实例和重启前后生成的ETag一致，客户端和CDN的缓存在实例之间可以互相验证
+class CacheVersion {
+public:
+    enum Scope {
+        PROBLEMS = 0,       // 题目及测试用例
+        DISCUSSIONS = 1,    // 讨论及回复
+        PROBLEM_STATS = 2,  // 题目提交统计，每次写回 problem_stats 表时递增
+        SCOPE_COUNT
+    };
+
+    // 获取当前版本号
+    static uint64_t get(Scope scope);
+
+    // 数据变更后递增版本号
+    static void bump(Scope scope);
+
+    // 递增版本号的语句，与数据变更放在同一事务中执行
+    static std::string bumpStatement(Scope scope);
+};
+
+#endif // CACHE_VERSION_H
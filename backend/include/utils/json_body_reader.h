@@ -0,0 +1,80 @@
+#ifndef JSON_BODY_READER_H
+#define JSON_BODY_READER_H
+
+#include <string>
+#include <set>
+#include <functional>
+#include <cstdint>
+#include "../models/problem.h"
+#include "../models/submission.h"
+#include "../models/discussion.h"
+
+// 流式JSON读取器
+// 顺序扫描请求体，不构建Json::Value DOM，由调用方按字段名把值直接读入目标结构
+class JsonBodyReader {
+public:
+    explicit JsonBodyReader(const std::string& body);
+
+    // 遍历对象的各个字段
+    // handler返回true表示已读取该字段的值，返回false表示不关心该字段，由读取器跳过
+    bool readObject(const std::function<bool(const std::string& key)>& handler);
+
+    // 遍历数组的各个元素，handler语义同readObject
+    bool readArray(const std::function<bool()>& handler);
+
+    // 读取基本类型的值（数字和字符串之间做与jsoncpp一致的宽松转换）
+    bool readString(std::string& out);
+    bool readInt(int& out);
+    bool readInt64(int64_t& out);
+    bool readBool(bool& out);
+
+    // 跳过任意一个值
+    bool skipValue();
+
+    // 确认值之后只剩空白字符
+    bool finish();
+
+    bool hasError() const { return !error_.empty(); }
+    const std::string& getError() const { return error_; }
+
+private:
+    const char* cur_;
+    const char* end_;
+    int depth_;
+    std::string error_;
+
+    void skipWhitespace();
+    bool fail(const std::string& message);
+    bool expect(char c);
+    bool matchLiteral(const char* literal);
+    bool readNumberToken(std::string& token);
+    bool readStringToken(std::string& out);
+    bool readHex4(unsigned int& code);
+};
+
+// 请求体解析器，把请求体中已知字段直接解析到模型对象
+// 请求体大小由HTTP服务器按 ServerConfig::max_payload_length 限制，超出时直接返回413，不会进入解析
+// fields 返回请求体中出现过的字段名，供控制器判断必填字段和部分更新
+class RequestBodyParser {
+public:
+    // 解析题目（包含可选的testcases数组）
+    static bool parseProblem(const std::string& body, Problem& problem, std::set<std::string>& fields, std::string& error_message);
+
+    // 解析测试用例
+    static bool parseTestCase(const std::string& body, TestCase& testcase, std::set<std::string>& fields, std::string& error_message);
+
+    // 解析代码提交（problem_id、code、language）
+    static bool parseSubmission(const std::string& body, Submission& submission, std::set<std::string>& fields, std::string& error_message);
+
+    // 解析讨论（title、content、problem_id）
+    static bool parseDiscussion(const std::string& body, Discussion& discussion, std::set<std::string>& fields, std::string& error_message);
+
+    // 解析讨论回复（content、parent_id）
+    static bool parseDiscussionReply(const std::string& body, DiscussionReply& reply, std::set<std::string>& fields, std::string& error_message);
+
+private:
+    static bool readTestCase(JsonBodyReader& reader, TestCase& testcase, std::set<std::string>* fields);
+    static bool finishParse(JsonBodyReader& reader, bool ok, std::string& error_message);
+};
+
+#endif // JSON_BODY_READER_H
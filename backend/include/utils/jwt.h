@@ -3,21 +3,32 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <ctime>
+
+// 验证通过的令牌声明
+struct TokenClaims {
+    int user_id = -1;
+    int role = -1;
+    std::string username;
+    std::time_t exp = 0;                        // 过期时间，0表示不过期
+    std::map<std::string, std::string> payload; // 完整负载
+};
 
 class JWT {
 private:
     static std::string secret_key;
     
-    // 编码Base64
-    static std::string base64_encode(const std::string& data);
-    
-    // 解码Base64
-    static std::string base64_decode(const std::string& data);
-    
-    // 创建签名
-    static std::string create_signature(const std::string& header, const std::string& payload);
+    // 计算 "header.payload" 的 HMAC-SHA256 签名（32字节）
+    static bool create_signature(const char* data, size_t length, unsigned char* signature);
 
 public:
+    // base64url编码（不带填充），结果追加到out
+    static void base64_encode(const unsigned char* data, size_t length, std::string& out);
+    
+    // base64url解码，遇到非法字符时返回false
+    static bool base64_decode(const char* data, size_t length, std::string& out);
+    
     // 设置密钥
     static void setSecretKey(const std::string& key);
     
@@ -27,6 +38,9 @@ public:
     // 验证JWT令牌
     static bool verifyToken(const std::string& token, std::map<std::string, std::string>& payload);
     
+    // 验证令牌并返回解析后的声明，结果经过缓存，同一令牌在有效期内只验证一次；无效时返回空指针
+    static std::shared_ptr<const TokenClaims> verifyClaims(const std::string& token);
+    
     // 从令牌中获取用户ID
     static int getUserIdFromToken(const std::string& token);
     
@@ -0,0 +1,49 @@
+#ifndef JWT_KEYS_H
+#define JWT_KEYS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <openssl/evp.h>
+#include <json/json.h>
+
+// JWT非对称密钥
+struct JwtKey {
+    std::string kid;                // 密钥ID，取自密钥文件名（不含扩展名）
+    std::string alg;                // ES256 或 EdDSA
+    std::shared_ptr<EVP_PKEY> pkey; // OpenSSL密钥
+    bool has_private = false;       // 是否可用于签名
+    Json::Value jwk;                // 公钥的JWK表示
+};
+
+// JWT非对称密钥集合
+// 配置签名私钥后，令牌改用ES256（P-256）或EdDSA（Ed25519）签名，头部带kid；
+// 验证时按kid查找公钥，轮换期间旧公钥继续用于验证，公钥集合通过JWKS接口对外发布，
+// 网关等服务只需公钥即可独立验证令牌。未配置时沿用HS256共享密钥。
+class JwtKeyStore {
+public:
+    // 加载密钥：signing_key_file 为当前签名私钥（PEM），verify_key_files 为仍需接受的旧公钥或私钥（PEM）
+    // 可重复调用以轮换密钥，新的密钥集合原子替换旧集合
+    static bool load(const std::string& signing_key_file, const std::vector<std::string>& verify_key_files,
+                     std::string& error_message);
+
+    // 是否启用非对称签名
+    static bool enabled();
+
+    // 当前签名密钥
+    static std::shared_ptr<const JwtKey> signingKey();
+
+    // 按kid查找验证密钥
+    static std::shared_ptr<const JwtKey> findKey(const std::string& kid);
+
+    // 公钥集合（JWKS格式）
+    static Json::Value jwks();
+
+    // 签名，ES256输出64字节的 R||S，EdDSA输出64字节签名
+    static bool sign(const JwtKey& key, const char* data, size_t length, std::string& signature);
+
+    // 验证签名
+    static bool verify(const JwtKey& key, const char* data, size_t length, const std::string& signature);
+};
+
+#endif // JWT_KEYS_H
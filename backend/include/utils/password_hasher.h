@@ -0,0 +1,57 @@
+#ifndef PASSWORD_HASHER_H
+#define PASSWORD_HASHER_H
+
+#include <string>
+
+// 哈希线程数，登录高峰时最多占用这么多CPU核心
+#define PASSWORD_HASH_THREADS 2
+
+// 同时在哈希的请求（执行中和排队中）最多占用的HTTP工作线程比例（1/N），超过后直接返回繁忙
+#define PASSWORD_HASH_WORKER_SHARE 4
+
+// scrypt参数：N = 2^15，r = 8，p = 1（每次约占用32MB内存）
+#define PASSWORD_SCRYPT_LOG_N 15
+#define PASSWORD_SCRYPT_R 8
+#define PASSWORD_SCRYPT_P 1
+
+// OpenSSL不支持scrypt时使用的PBKDF2-SHA256迭代次数
+#define PASSWORD_PBKDF2_ITERATIONS 600000
+
+// 哈希队列已满时返回的错误信息
+#define PASSWORD_HASHER_BUSY_MESSAGE "服务器繁忙，请稍后重试"
+
+// 密码验证结果
+struct PasswordCheck {
+    bool matched = false;     // 密码是否正确
+    std::string rehash;       // 存储格式过时需要升级时，新的哈希值（否则为空）
+    std::string rehash_salt;  // 与 rehash 对应的新盐
+};
+
+// 密码哈希
+// 存储格式为 $scrypt$ln=15,r=8,p=1$<十六进制摘要>，OpenSSL不支持scrypt时为 $pbkdf2-sha256$i=600000$<十六进制摘要>；
+// 旧版本的 SHA256(密码+盐) 十六进制摘要仍可验证，验证通过后返回新格式的哈希供调用方写回。
+// 哈希计算在独立的有界线程池中执行，发起请求的HTTP工作线程等待结果；同时在哈希的请求数限制在
+// HTTP工作线程数的一部分，登录请求集中到来时其余工作线程照常处理其他接口，超出时立即返回 PASSWORD_HASHER_BUSY_MESSAGE。
+class PasswordHasher {
+public:
+    // 按HTTP工作线程数设置同时在哈希的请求上限
+    static void setConcurrencyLimit(size_t worker_threads);
+
+    // 生成新的盐和哈希（在哈希线程池中执行）
+    static bool hashPassword(const std::string& password, std::string& password_hash, std::string& salt,
+                             std::string& error_message);
+
+    // 验证密码（在哈希线程池中执行），密码正确且存储格式过时时同时计算新哈希
+    static bool verifyPassword(const std::string& password, const std::string& salt, const std::string& stored_hash,
+                               PasswordCheck& check, std::string& error_message);
+
+    // 在当前线程中计算，供不经过HTTP请求的场景使用
+    static std::string computeHash(const std::string& password, const std::string& salt);
+    static bool checkHash(const std::string& password, const std::string& salt, const std::string& stored_hash,
+                          bool& needs_rehash);
+
+    // 生成随机盐（32位十六进制）
+    static std::string generateSalt();
+};
+
+#endif // PASSWORD_HASHER_H
@@ -0,0 +1,58 @@
+#ifndef PERIODIC_FLUSHER_H
+#define PERIODIC_FLUSHER_H
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <functional>
+#include <condition_variable>
+
+// 定期执行任务的后台线程
+// 计数类服务（浏览量、点赞数、题目统计等）在内存中累计增量，由它定期调用写回函数；
+// run_on_stop 为true时，线程在停止前再执行一次任务，保证剩余的增量被写回。
+class PeriodicFlusher {
+public:
+    PeriodicFlusher(int interval_ms, const std::function<void()>& task, bool run_on_stop = true);
+
+    // 启动后台线程，已在运行时返回false
+    bool start();
+
+    // 唤醒并等待后台线程退出，未在运行时返回false
+    bool stop();
+
+private:
+    int interval_ms;
+    std::function<void()> task;
+    bool run_on_stop;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread worker;
+    std::atomic<bool> running;
+};
+
+// 按 batch_size 分批写回增量，write 返回false的批次交给 requeue 放回待写回的增量，下次重试
+// Batch 为 std::map 或 std::vector<std::pair<...>>，元素类型与 deltas 一致；有批次写入成功时返回true
+template <typename Batch, typename Deltas, typename Write, typename Requeue>
+bool flushInBatches(const Deltas& deltas, size_t batch_size, Write write, Requeue requeue) {
+    bool written = false;
+    Batch batch;
+    for (auto it = deltas.begin(); it != deltas.end();) {
+        batch.insert(batch.end(), *it);
+        ++it;
+        if (batch.size() < batch_size && it != deltas.end()) {
+            continue;
+        }
+
+        if (write(batch)) {
+            written = true;
+        } else {
+            requeue(batch);
+        }
+        batch.clear();
+    }
+    return written;
+}
+
+#endif // PERIODIC_FLUSHER_H
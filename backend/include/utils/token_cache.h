@@ -0,0 +1,29 @@
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <string>
+#include <memory>
+#include "jwt.h"
+
+// 分片数量，每个分片独立加锁
+#define TOKEN_CACHE_SHARDS 16
+
+// 缓存的令牌总数上限
+#define TOKEN_CACHE_CAPACITY 8192
+
+// 已验证令牌缓存
+// 以完整令牌为键缓存验证通过后的声明，按令牌哈希分片以减少锁竞争，每个分片按LRU淘汰；
+// 条目在令牌的exp到期后失效，因此缓存命中与重新验证的结果始终一致。
+class TokenCache {
+public:
+    // 查找令牌，未命中或已过期时返回空指针
+    static std::shared_ptr<const TokenClaims> get(const std::string& token);
+
+    // 写入验证通过的令牌
+    static void put(const std::string& token, const std::shared_ptr<const TokenClaims>& claims);
+
+    // 清空缓存（更换密钥时调用）
+    static void clear();
+};
+
+#endif // TOKEN_CACHE_H
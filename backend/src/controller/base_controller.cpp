@@ -15,30 +15,63 @@ Json::Value parseRequestBody(const std::string& body) {
     return root;
 }
 
-// 将JSON对象序列化为字符串（使用UTF-8编码）
-std::string jsonToString(const Json::Value& value) {
-    Json::StreamWriterBuilder builder;
-    // 启用UTF-8直接输出
-    builder["emitUTF8"] = true;
-    // 使用制表符缩进，美化输出
-    builder["indentation"] = "\t";
-    return Json::writeString(builder, value);
+// 将JSON对象序列化为字符串（使用UTF-8编码，默认紧凑输出）
+std::string jsonToString(const Json::Value& value, bool pretty) {
+    return http::JsonWriter::toString(value, pretty);
 }
 
 // 成功响应辅助方法
+// 紧凑模式下直接把外层字段和data的成员依次写入响应体，不再将data深拷贝到新的JSON对象中
 void BaseController::sendSuccessResponse(http::Response& res, const std::string& message, const Json::Value& data) {
-    Json::Value response;
-    response["status"] = "ok";
-    response["message"] = message;
-    
-    // 如果提供了数据，添加到响应中
-    if (!data.isNull()) {
-        for (const auto& key : data.getMemberNames()) {
-            response[key] = data[key];
+    bool has_data = data.isObject() && !data.empty();
+    
+    // 调试用的美化输出：沿用合并对象的方式，保证缩进正确
+    if (res.pretty_json) {
+        Json::Value response;
+        response["status"] = "ok";
+        response["message"] = message;
+        if (has_data) {
+            for (const auto& key : data.getMemberNames()) {
+                response[key] = data[key];
+            }
+        }
+        res.json(jsonToString(response, true));
+        return;
+    }
+    
+    std::string& out = res.body;
+    out.clear();
+    
+    // data中的同名字段会覆盖默认的status/message（与合并对象的行为一致）
+    out += "{\"status\":";
+    if (has_data && data.isMember("status")) {
+        http::JsonWriter::write(data["status"], out);
+    } else {
+        out += "\"ok\"";
+    }
+    out += ",\"message\":";
+    if (has_data && data.isMember("message")) {
+        http::JsonWriter::write(data["message"], out);
+    } else {
+        http::JsonWriter::writeString(message, out);
+    }
+    
+    // 如果提供了数据，逐个成员写入响应
+    if (has_data) {
+        for (Json::Value::const_iterator it = data.begin(); it != data.end(); ++it) {
+            std::string key = it.name();
+            if (key == "status" || key == "message") {
+                continue;
+            }
+            out += ",";
+            http::JsonWriter::writeString(key, out);
+            out += ":";
+            http::JsonWriter::write(*it, out);
         }
     }
     
-    res.json(jsonToString(response));
+    out += "}";
+    res.set_content_type("application/json");
 }
 
 // 错误响应辅助方法
@@ -46,11 +79,53 @@ void BaseController::sendErrorResponse(http::Response& res, const std::string& m
     res.status_code = statusCode;
     res.status_message = statusCode == 401 ? "Unauthorized" : 
                          statusCode == 403 ? "Forbidden" :
-                         statusCode == 404 ? "Not Found" : "Bad Request";
+                         statusCode == 404 ? "Not Found" :
+                         statusCode == 413 ? "Payload Too Large" : "Bad Request";
+    
+    res.json(http::JsonWriter::statusMessage("error", message));
+}
+
+// 去掉ETag的弱校验前缀，If-None-Match 按弱比较规则匹配
+static std::string stripWeakPrefix(const std::string& tag) {
+    if (tag.size() > 2 && tag[0] == 'W' && tag[1] == '/') {
+        return tag.substr(2);
+    }
+    return tag;
+}
+
+// 条件请求辅助方法
+bool BaseController::checkNotModified(const http::Request& req, http::Response& res, const std::string& etag,
+                                      const std::string& cache_control) {
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", cache_control);
+    
+    std::string if_none_match = req.get_header("If-None-Match");
+    if (if_none_match.empty()) {
+        return false;
+    }
     
-    Json::Value response;
-    response["status"] = "error";
-    response["message"] = message;
+    std::string expected = stripWeakPrefix(etag);
+    bool matched = false;
+    size_t start = 0;
+    while (start < if_none_match.size() && !matched) {
+        size_t end = if_none_match.find(',', start);
+        if (end == std::string::npos) {
+            end = if_none_match.size();
+        }
+        std::string candidate = if_none_match.substr(start, end - start);
+        size_t first = candidate.find_first_not_of(" \t");
+        size_t last = candidate.find_last_not_of(" \t");
+        if (first != std::string::npos) {
+            candidate = candidate.substr(first, last - first + 1);
+            matched = candidate == "*" || stripWeakPrefix(candidate) == expected;
+        }
+        start = end + 1;
+    }
     
-    res.json(jsonToString(response));
-} 
\ No newline at end of file
+    if (matched) {
+        res.status_code = 304;
+        res.status_message = "Not Modified";
+        res.body.clear();
+    }
+    return matched;
+}
\ No newline at end of file
@@ -1,8 +1,14 @@
 #include "../../include/controller/discussion_controller.h"
+#include "../../include/utils/json_body_reader.h"
+#include "../../include/utils/cache_version.h"
+#include "../../include/services/discussion_view_counter.h"
+#include "../../include/services/hot_discussions.h"
+#include "../../include/services/discussion_likes.h"
 #include <json/json.h>
 #include <iostream>
-#include <regex>
 #include <sstream>
+#include <set>
+#include <algorithm>
 
 // 注册路由
 void DiscussionController::registerRoutes(http::HttpServer* server) {
@@ -12,12 +18,17 @@ void DiscussionController::registerRoutes(http::HttpServer* server) {
     });
     
     // 获取题目相关讨论
-    server->get("/api/problems/[0-9]+/discussions", [this](const http::Request& req, http::Response& res) {
+    server->get("/api/problems/:id/discussions", [this](const http::Request& req, http::Response& res) {
         this->handleGetProblemDiscussions(req, res);
     });
     
+    // 获取热门讨论（静态路径优先于 :id 匹配）
+    server->get("/api/discussions/hot", [this](const http::Request& req, http::Response& res) {
+        this->handleGetHotDiscussions(req, res);
+    });
+    
     // 获取讨论详情
-    server->get("/api/discussions/[0-9]+", [this](const http::Request& req, http::Response& res) {
+    server->get("/api/discussions/:id", [this](const http::Request& req, http::Response& res) {
         this->handleGetDiscussionDetail(req, res);
     });
     
@@ -27,29 +38,49 @@ void DiscussionController::registerRoutes(http::HttpServer* server) {
     }));
     
     // 更新讨论
-    server->put("/api/discussions/[0-9]+", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->put("/api/discussions/:id", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleUpdateDiscussion(req, res);
     }));
     
     // 删除讨论
-    server->del("/api/discussions/[0-9]+", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->del("/api/discussions/:id", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleDeleteDiscussion(req, res);
     }));
     
     // 获取讨论回复
-    server->get("/api/discussions/[0-9]+/replies", [this](const http::Request& req, http::Response& res) {
+    server->get("/api/discussions/:id/replies", [this](const http::Request& req, http::Response& res) {
         this->handleGetReplies(req, res);
     });
     
     // 创建回复
-    server->post("/api/discussions/[0-9]+/replies", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->post("/api/discussions/:id/replies", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleCreateReply(req, res);
     }));
     
     // 删除回复
-    server->del("/api/replies/[0-9]+", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->del("/api/replies/:id", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleDeleteReply(req, res);
     }));
+    
+    // 点赞讨论
+    server->post("/api/discussions/:id/like", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+        this->handleSetLike(req, res, LikeTarget::DISCUSSION, true);
+    }));
+    
+    // 取消点赞讨论
+    server->del("/api/discussions/:id/like", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+        this->handleSetLike(req, res, LikeTarget::DISCUSSION, false);
+    }));
+    
+    // 点赞回复
+    server->post("/api/replies/:id/like", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+        this->handleSetLike(req, res, LikeTarget::REPLY, true);
+    }));
+    
+    // 取消点赞回复
+    server->del("/api/replies/:id/like", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+        this->handleSetLike(req, res, LikeTarget::REPLY, false);
+    }));
 }
 
 // 解析查询参数
@@ -71,6 +102,23 @@ std::map<std::string, std::string> parseQueryParams(const std::string& query_str
     return params;
 }
 
+// 回复树节点转为JSON，子回复放在 child_replies 中
+static Json::Value replyNodeToJson(const DiscussionReplyNode& node) {
+    Json::Value replyJson = node.reply.toJson();
+    
+    if (!node.children.empty()) {
+        Json::Value childRepliesJson(Json::arrayValue);
+        for (const auto& child : node.children) {
+            childRepliesJson.append(replyNodeToJson(child));
+        }
+        replyJson["child_replies"] = childRepliesJson;
+    }
+    if (node.child_count > 0) {
+        replyJson["child_count"] = node.child_count;
+    }
+    return replyJson;
+}
+
 // 获取所有讨论
 void DiscussionController::handleGetAllDiscussions(const http::Request& req, http::Response& res) {
     // 解析分页参数
@@ -105,15 +153,19 @@ void DiscussionController::handleGetAllDiscussions(const http::Request& req, htt
         }
     }
     
+    // 讨论版本未变化时直接返回304；列表中的浏览量不计入版本，因此使用弱ETag
+    std::string etag = "W/\"dl-" + std::to_string(CacheVersion::get(CacheVersion::DISCUSSIONS)) + "\"";
+    if (checkNotModified(req, res, etag)) {
+        return;
+    }
+    
     // 获取讨论列表
     std::vector<Discussion> discussions = DiscussionDAO::getAllDiscussions(offset, limit);
     
     // 构建响应
     Json::Value discussionsJson(Json::arrayValue);
     for (const auto& discussion : discussions) {
-        Json::Value discussionJson;
-        Json::Reader reader;
-        reader.parse(discussion.toJson(), discussionJson);
+        Json::Value discussionJson = discussion.toJson();
         discussionsJson.append(discussionJson);
     }
     
@@ -129,7 +181,7 @@ void DiscussionController::handleGetAllDiscussions(const http::Request& req, htt
 // 获取题目相关讨论
 void DiscussionController::handleGetProblemDiscussions(const http::Request& req, http::Response& res) {
     // 从URL中提取题目ID
-    int problem_id = getIdFromPath(req.path, "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         sendErrorResponse(res, "无效的题目ID", 400);
         return;
@@ -167,15 +219,19 @@ void DiscussionController::handleGetProblemDiscussions(const http::Request& req,
         }
     }
     
+    std::string etag = "W/\"dlp" + std::to_string(problem_id) + "-" +
+                       std::to_string(CacheVersion::get(CacheVersion::DISCUSSIONS)) + "\"";
+    if (checkNotModified(req, res, etag)) {
+        return;
+    }
+    
     // 获取题目相关讨论
     std::vector<Discussion> discussions = DiscussionDAO::getDiscussionsByProblemId(problem_id, offset, limit);
     
     // 构建响应
     Json::Value discussionsJson(Json::arrayValue);
     for (const auto& discussion : discussions) {
-        Json::Value discussionJson;
-        Json::Reader reader;
-        reader.parse(discussion.toJson(), discussionJson);
+        Json::Value discussionJson = discussion.toJson();
         discussionsJson.append(discussionJson);
     }
     
@@ -189,15 +245,57 @@ void DiscussionController::handleGetProblemDiscussions(const http::Request& req,
     sendSuccessResponse(res, "获取题目讨论成功", data);
 }
 
+// 获取热门讨论，problem_id 为空时返回全站排行
+void DiscussionController::handleGetHotDiscussions(const http::Request& req, http::Response& res) {
+    int problem_id = 0, limit = 10;
+    try {
+        if (req.has_param("problem_id")) {
+            problem_id = std::stoi(req.get_param("problem_id"));
+        }
+        if (req.has_param("limit")) {
+            limit = std::max(1, std::min(HOT_DISCUSSIONS_TOP_K, std::stoi(req.get_param("limit"))));
+        }
+    } catch (std::exception& e) {
+        // 忽略无效参数
+    }
+    
+    // 排行来自内存快照，无需查询数据库
+    std::vector<Discussion> discussions = HotDiscussions::get(problem_id, limit);
+    
+    Json::Value discussionsJson(Json::arrayValue);
+    for (const auto& discussion : discussions) {
+        discussionsJson.append(discussion.toJson());
+    }
+    
+    Json::Value data;
+    data["discussions"] = discussionsJson;
+    data["problem_id"] = problem_id;
+    
+    sendSuccessResponse(res, "获取热门讨论成功", data);
+}
+
 // 获取讨论详情
 void DiscussionController::handleGetDiscussionDetail(const http::Request& req, http::Response& res) {
     // 从URL中提取讨论ID
-    int discussion_id = getIdFromPath(req.path, "/api/discussions/");
+    int discussion_id = req.get_path_id("id");
     if (discussion_id <= 0) {
         sendErrorResponse(res, "无效的讨论ID", 400);
         return;
     }
     
+    // 内容和已写回的浏览、点赞数都未变化时返回304，浏览量照常累计
+    // 内存中的增量每次写回后标签随之变化，客户端看到的计数最多落后一个写回周期
+    int persisted_views = 0, persisted_likes = 0;
+    if (DiscussionDAO::getDiscussionCounters(discussion_id, persisted_views, persisted_likes)) {
+        std::string etag = "W/\"d" + std::to_string(discussion_id) + "-" +
+                           std::to_string(CacheVersion::get(CacheVersion::DISCUSSIONS)) + "-" +
+                           std::to_string(persisted_views) + "-" + std::to_string(persisted_likes) + "\"";
+        if (checkNotModified(req, res, etag)) {
+            DiscussionViewCounter::record(discussion_id);
+            return;
+        }
+    }
+    
     // 获取讨论详情
     Discussion discussion = DiscussionDAO::getDiscussionById(discussion_id);
     
@@ -206,14 +304,13 @@ void DiscussionController::handleGetDiscussionDetail(const http::Request& req, h
         return;
     }
     
-    // 增加浏览量
-    discussion.incrementViews();
-    DiscussionDAO::updateDiscussion(discussion);
+    // 增加浏览量（内存累加，后台批量写回），返回值包含尚未写回的浏览和点赞
+    DiscussionViewCounter::record(discussion_id);
+    discussion.setViews(discussion.getViews() + DiscussionViewCounter::pending(discussion_id));
+    discussion.setLikes(discussion.getLikes() + DiscussionLikes::pendingDelta(LikeTarget::DISCUSSION, discussion_id));
     
     // 转换为JSON
-    Json::Value discussionJson;
-    Json::Reader reader;
-    reader.parse(discussion.toJson(), discussionJson);
+    Json::Value discussionJson = discussion.toJson();
     
     // 构建响应
     Json::Value data;
@@ -224,38 +321,35 @@ void DiscussionController::handleGetDiscussionDetail(const http::Request& req, h
 
 // 创建讨论
 void DiscussionController::handleCreateDiscussion(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
+    // 用户ID来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，直接填充讨论对象
+    Discussion discussion(user_id, "", "", 0);
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseDiscussion(req.body, discussion, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
-    if (!reqJson.isMember("title") || !reqJson.isMember("content")) {
+    if (!fields.count("title") || !fields.count("content")) {
         sendErrorResponse(res, "请提供标题和内容", 400);
         return;
     }
     
-    // 创建讨论对象
-    std::string title = reqJson["title"].asString();
-    std::string content = reqJson["content"].asString();
-    int problem_id = reqJson.isMember("problem_id") ? reqJson["problem_id"].asInt() : 0;
-    
-    Discussion discussion(user_id, title, content, problem_id);
-    
     // 保存讨论
     if (DiscussionDAO::createDiscussion(discussion)) {
+        HotDiscussions::recordCreated(discussion.getId(), discussion.getProblemId());
+        
         // 构建响应
         Json::Value data;
-        Json::Value discussionJson;
-        Json::Reader reader;
-        reader.parse(discussion.toJson(), discussionJson);
+        Json::Value discussionJson = discussion.toJson();
         data["discussion"] = discussionJson;
         
         sendSuccessResponse(res, "创建讨论成功", data);
@@ -267,17 +361,15 @@ void DiscussionController::handleCreateDiscussion(const http::Request& req, http
 // 更新讨论
 void DiscussionController::handleUpdateDiscussion(const http::Request& req, http::Response& res) {
     // 从URL中提取讨论ID
-    int discussion_id = getIdFromPath(req.path, "/api/discussions/");
+    int discussion_id = req.get_path_id("id");
     if (discussion_id <= 0) {
         sendErrorResponse(res, "无效的讨论ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -298,16 +390,22 @@ void DiscussionController::handleUpdateDiscussion(const http::Request& req, http
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，只覆盖请求中出现的标题和内容
+    Discussion changes;
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseDiscussion(req.body, changes, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
     // 更新讨论对象
-    if (reqJson.isMember("title")) {
-        discussion.setTitle(reqJson["title"].asString());
+    if (fields.count("title")) {
+        discussion.setTitle(changes.getTitle());
     }
     
-    if (reqJson.isMember("content")) {
-        discussion.setContent(reqJson["content"].asString());
+    if (fields.count("content")) {
+        discussion.setContent(changes.getContent());
     }
     
     // 更新时间
@@ -317,9 +415,7 @@ void DiscussionController::handleUpdateDiscussion(const http::Request& req, http
     if (DiscussionDAO::updateDiscussion(discussion)) {
         // 构建响应
         Json::Value data;
-        Json::Value discussionJson;
-        Json::Reader reader;
-        reader.parse(discussion.toJson(), discussionJson);
+        Json::Value discussionJson = discussion.toJson();
         data["discussion"] = discussionJson;
         
         sendSuccessResponse(res, "更新讨论成功", data);
@@ -331,17 +427,15 @@ void DiscussionController::handleUpdateDiscussion(const http::Request& req, http
 // 删除讨论
 void DiscussionController::handleDeleteDiscussion(const http::Request& req, http::Response& res) {
     // 从URL中提取讨论ID
-    int discussion_id = getIdFromPath(req.path, "/api/discussions/");
+    int discussion_id = req.get_path_id("id");
     if (discussion_id <= 0) {
         sendErrorResponse(res, "无效的讨论ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -364,6 +458,7 @@ void DiscussionController::handleDeleteDiscussion(const http::Request& req, http
     
     // 删除讨论
     if (DiscussionDAO::deleteDiscussion(discussion_id)) {
+        HotDiscussions::remove(discussion_id);
         sendSuccessResponse(res, "删除讨论成功");
     } else {
         sendErrorResponse(res, "删除讨论失败", 500);
@@ -373,7 +468,7 @@ void DiscussionController::handleDeleteDiscussion(const http::Request& req, http
 // 获取讨论回复
 void DiscussionController::handleGetReplies(const http::Request& req, http::Response& res) {
     // 从URL中提取讨论ID
-    int discussion_id = getIdFromPath(req.path, "/api/discussions/");
+    int discussion_id = req.get_path_id("id");
     if (discussion_id <= 0) {
         sendErrorResponse(res, "无效的讨论ID", 400);
         return;
@@ -381,6 +476,7 @@ void DiscussionController::handleGetReplies(const http::Request& req, http::Resp
     
     // 解析分页参数
     int offset = 0, limit = 20;
+    int depth = 1, child_limit = 10;
     
     // 解析查询参数
     size_t query_pos = req.path.find('?');
@@ -409,31 +505,41 @@ void DiscussionController::handleGetReplies(const http::Request& req, http::Resp
                 // 忽略无效参数
             }
         }
+        
+        // 子回复层数
+        auto depth_it = params.find("depth");
+        if (depth_it != params.end()) {
+            try {
+                depth = std::max(0, std::min(REPLY_TREE_MAX_DEPTH, std::stoi(depth_it->second)));
+            } catch (std::exception& e) {
+                // 忽略无效参数
+            }
+        }
+        
+        // 每条回复返回的子回复数，整棵树的回复总数另由 REPLY_TREE_MAX_NODES 限制
+        auto child_limit_it = params.find("child_limit");
+        if (child_limit_it != params.end()) {
+            try {
+                child_limit = std::max(0, std::min(REPLY_TREE_MAX_CHILDREN, std::stoi(child_limit_it->second)));
+            } catch (std::exception& e) {
+                // 忽略无效参数
+            }
+        }
     }
     
-    // 获取回复
-    std::vector<DiscussionReply> replies = DiscussionDAO::getRepliesByDiscussionId(discussion_id, offset, limit);
+    std::string etag = "W/\"dr" + std::to_string(discussion_id) + "-" +
+                       std::to_string(CacheVersion::get(CacheVersion::DISCUSSIONS)) + "\"";
+    if (checkNotModified(req, res, etag)) {
+        return;
+    }
+    
+    // 一页顶层回复及子回复树，每层一次计数和一次子回复查询
+    std::vector<DiscussionReplyNode> replies = DiscussionDAO::getReplyTree(discussion_id, offset, limit, depth, child_limit);
     
     // 构建响应
     Json::Value repliesJson(Json::arrayValue);
-    for (const auto& reply : replies) {
-        Json::Value replyJson;
-        Json::Reader reader;
-        reader.parse(reply.toJson(), replyJson);
-        
-        // 获取子回复
-        std::vector<DiscussionReply> childReplies = DiscussionDAO::getChildReplies(reply.getId(), 0, 10);
-        if (!childReplies.empty()) {
-            Json::Value childRepliesJson(Json::arrayValue);
-            for (const auto& childReply : childReplies) {
-                Json::Value childReplyJson;
-                reader.parse(childReply.toJson(), childReplyJson);
-                childRepliesJson.append(childReplyJson);
-            }
-            replyJson["child_replies"] = childRepliesJson;
-        }
-        
-        repliesJson.append(replyJson);
+    for (const auto& node : replies) {
+        repliesJson.append(replyNodeToJson(node));
     }
     
     Json::Value data;
@@ -446,43 +552,41 @@ void DiscussionController::handleGetReplies(const http::Request& req, http::Resp
 // 创建回复
 void DiscussionController::handleCreateReply(const http::Request& req, http::Response& res) {
     // 从URL中提取讨论ID
-    int discussion_id = getIdFromPath(req.path, "/api/discussions/");
+    int discussion_id = req.get_path_id("id");
     if (discussion_id <= 0) {
         sendErrorResponse(res, "无效的讨论ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
+    // 用户ID来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，直接填充回复对象
+    DiscussionReply reply(discussion_id, user_id, "", 0);
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseDiscussionReply(req.body, reply, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
-    if (!reqJson.isMember("content")) {
+    if (!fields.count("content")) {
         sendErrorResponse(res, "请提供回复内容", 400);
         return;
     }
     
-    // 创建回复对象
-    std::string content = reqJson["content"].asString();
-    int parent_id = reqJson.isMember("parent_id") ? reqJson["parent_id"].asInt() : 0;
-    
-    DiscussionReply reply(discussion_id, user_id, content, parent_id);
-    
     // 保存回复
     if (DiscussionDAO::createDiscussionReply(reply)) {
+        HotDiscussions::recordReply(discussion_id);
+        
         // 构建响应
         Json::Value data;
-        Json::Value replyJson;
-        Json::Reader reader;
-        reader.parse(reply.toJson(), replyJson);
+        Json::Value replyJson = reply.toJson();
         data["reply"] = replyJson;
         
         sendSuccessResponse(res, "创建回复成功", data);
@@ -494,17 +598,15 @@ void DiscussionController::handleCreateReply(const http::Request& req, http::Res
 // 删除回复
 void DiscussionController::handleDeleteReply(const http::Request& req, http::Response& res) {
     // 从URL中提取回复ID
-    int reply_id = getIdFromPath(req.path, "/api/replies/");
+    int reply_id = req.get_path_id("id");
     if (reply_id <= 0) {
         sendErrorResponse(res, "无效的回复ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -533,18 +635,31 @@ void DiscussionController::handleDeleteReply(const http::Request& req, http::Res
     }
 }
 
-// 从URL路径获取ID
-int DiscussionController::getIdFromPath(const std::string& path, const std::string& prefix) {
-    std::regex pattern(prefix + "([0-9]+)");
-    std::smatch matches;
-    
-    if (std::regex_search(path, matches, pattern) && matches.size() > 1) {
-        try {
-            return std::stoi(matches[1].str());
-        } catch (std::exception& e) {
-            return -1;
-        }
+// 点赞或取消点赞，重复请求返回成功且 changed 为false
+void DiscussionController::handleSetLike(const http::Request& req, http::Response& res, LikeTarget target, bool liked) {
+    int target_id = req.get_path_id("id");
+    if (target_id <= 0) {
+        sendErrorResponse(res, target == LikeTarget::DISCUSSION ? "无效的讨论ID" : "无效的回复ID", 400);
+        return;
+    }
+    
+    // 用户ID来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    if (user_id <= 0) {
+        sendErrorResponse(res, "无效的用户ID", 401);
+        return;
     }
     
-    return -1;
-} 
\ No newline at end of file
+    bool changed = false;
+    std::string error_message;
+    LikeStatus status = DiscussionLikes::setLiked(user_id, target, target_id, liked, changed, error_message);
+    if (status != LikeStatus::OK) {
+        sendErrorResponse(res, error_message, status == LikeStatus::NOT_FOUND ? 404 : 500);
+        return;
+    }
+    
+    Json::Value data;
+    data["liked"] = liked;
+    data["changed"] = changed;
+    sendSuccessResponse(res, liked ? "点赞成功" : "取消点赞成功", data);
+}
\ No newline at end of file
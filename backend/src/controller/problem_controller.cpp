@@ -1,11 +1,18 @@
 #include "../../include/controller/problem_controller.h"
 #include "../../include/services/submission_service.h"
+#include "../../include/services/submission_events.h"
+#include "../../include/services/problem_catalog.h"
+#include "../../include/services/problem_stats.h"
 #include "../../include/models/submission.h"
 #include "../../include/models/submission_repository.h"
+#include "../../include/utils/json_body_reader.h"
+#include "../../include/utils/cache_version.h"
 #include <json/json.h>
 #include <iostream>
-#include <regex>
 #include <sstream>
+#include <set>
+#include <memory>
+#include <ctime>
 
 // 辅助函数：从查询字符串解析参数
 std::map<std::string, std::string> parseQueryParameters(const std::string& query_string) {
@@ -34,7 +41,7 @@ void ProblemController::registerRoutes(http::HttpServer* server) {
     });
     
     // 题目详情路由
-    server->get("/api/problems/[0-9]+", [this](const http::Request& req, http::Response& res) {
+    server->get("/api/problems/:id", [this](const http::Request& req, http::Response& res) {
         this->handleGetProblemDetail(req, res);
     });
     
@@ -44,39 +51,39 @@ void ProblemController::registerRoutes(http::HttpServer* server) {
     }, 2)); // 角色2为管理员
     
     // 更新题目路由 - 需要管理员权限
-    server->put("/api/problems/[0-9]+", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
+    server->put("/api/problems/:id", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
         this->handleUpdateProblem(req, res);
     }, 2));
     
     // 删除题目路由 - 需要管理员权限
-    server->del("/api/problems/[0-9]+", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
+    server->del("/api/problems/:id", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
         this->handleDeleteProblem(req, res);
     }, 2));
     
     // 测试用例相关路由
     
     // 获取题目的测试用例
-    server->get("/api/problems/[0-9]+/testcases", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
+    server->get("/api/problems/:id/testcases", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
         this->handleGetTestCases(req, res);
     }, 2));
     
     // 添加测试用例
-    server->post("/api/problems/[0-9]+/testcases", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
+    server->post("/api/problems/:id/testcases", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
         this->handleAddTestCase(req, res);
     }, 2));
     
     // 更新测试用例
-    server->put("/api/testcases/[0-9]+", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
+    server->put("/api/testcases/:id", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
         this->handleUpdateTestCase(req, res);
     }, 2));
     
     // 删除测试用例
-    server->del("/api/testcases/[0-9]+", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
+    server->del("/api/testcases/:id", middleware::AuthMiddleware::protectWithRole([this](const http::Request& req, http::Response& res) {
         this->handleDeleteTestCase(req, res);
     }, 2));
     
     // 获取题目的提交记录
-    server->get("/api/problems/[0-9]+/submissions", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->get("/api/problems/:id/submissions", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleGetProblemSubmissions(req, res);
     }));
     
@@ -91,12 +98,17 @@ void ProblemController::registerRoutes(http::HttpServer* server) {
     }));
     
     // 获取单个提交详情
-    server->get("/api/submissions/[0-9]+", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->get("/api/submissions/:id", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleGetSubmissionDetail(req, res);
     }));
     
+    // 订阅提交评测状态推送
+    server->get("/api/submissions/:id/events", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+        this->handleSubmissionEvents(req, res);
+    }));
+    
     // 重新提交代码
-    server->post("/api/submissions/resubmit/[0-9]+", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
+    server->post("/api/submissions/resubmit/:id", middleware::AuthMiddleware::protect([this](const http::Request& req, http::Response& res) {
         this->handleResubmitCode(req, res);
     }));
     
@@ -107,10 +119,16 @@ void ProblemController::registerRoutes(http::HttpServer* server) {
         std::cout << "API状态检查: " << req.path << std::endl;
         
         res.status_code = 200;
-        res.body = "{\"status\":\"ok\",\"message\":\"API is running\"}";
+        res.json(http::JsonWriter::statusMessage("ok", "API is running"));
     });
 }
 
+// 题目列表的ETag：题目版本加上题目统计的版本
+// 统计版本在每次写回时递增，各实例按同一版本载入相同的统计，ETag在实例之间一致
+static std::string problemListETag(const std::string& version, uint64_t stats_version) {
+    return "\"pl-" + version + "-" + std::to_string(stats_version) + "\"";
+}
+
 // 获取题目列表
 void ProblemController::handleGetProblems(const http::Request& req, http::Response& res) {
     std::cout << "Handling GET Problems request..." << std::endl;
@@ -182,19 +200,74 @@ void ProblemController::handleGetProblems(const http::Request& req, http::Respon
         std::cout << "No query parameters found in path." << std::endl;
     }
     
-    // 获取题目列表
+    // 题目版本需在查询前读取，避免并发修改后缓存旧内容
+    std::string version = std::to_string(CacheVersion::get(CacheVersion::PROBLEMS));
+    
+    // 状态参数为空或非数字时不按状态筛选
+    int status_filter = -1;
+    if (!status.empty()) {
+        try {
+            status_filter = std::stoi(status);
+        } catch (std::exception& e) {
+            std::cout << "Invalid status parameter: " << status << std::endl;
+        }
+    }
+    
+    // 优先从内存中的题目目录读取摘要，不查询数据库也不加载描述等大字段
+    std::vector<ProblemSummary> summaries;
+    int catalog_total = 0;
+    if (ProblemCatalog::list(search, difficulty, status_filter, offset, limit, summaries, catalog_total)) {
+        std::vector<int> problem_ids;
+        for (const auto& summary : summaries) {
+            problem_ids.push_back(summary.id);
+        }
+        std::vector<ProblemStatsItem> stats;
+        uint64_t stats_version = ProblemStats::get(problem_ids, stats);
+        if (checkNotModified(req, res, problemListETag(version, stats_version))) {
+            return;
+        }
+        
+        Json::Value problemsJson(Json::arrayValue);
+        for (size_t i = 0; i < summaries.size(); i++) {
+            Json::Value problemJson = summaries[i].toJson();
+            stats[i].writeJson(problemJson, false);
+            problemsJson.append(problemJson);
+        }
+        
+        Json::Value data;
+        data["problems"] = problemsJson;
+        data["total"] = catalog_total;
+        data["offset"] = offset;
+        data["limit"] = limit;
+        
+        sendSuccessResponse(res, "获取题目列表成功", data);
+        return;
+    }
+    
+    // 目录未建立时回退到数据库查询
     std::cout << "Retrieving problems with offset=" << offset << ", limit=" << limit << ", search=\"" << search << "\"" << std::endl;
-    std::vector<Problem> problems = ProblemService::getAllProblems(offset, limit, search);
+    // 总数与本页一起取得，有搜索词时只检索一次
+    int total = 0;
+    std::vector<Problem> problems = ProblemService::getAllProblems(offset, limit, search, &total);
     std::cout << "Retrieved " << problems.size() << " problems" << std::endl;
-    
-    // 获取总数
-    int total = ProblemService::countProblems(search);
     std::cout << "Total problem count: " << total << std::endl;
     
+    std::vector<int> problem_ids;
+    for (const auto& problem : problems) {
+        problem_ids.push_back(problem.getId());
+    }
+    std::vector<ProblemStatsItem> stats;
+    uint64_t stats_version = ProblemStats::get(problem_ids, stats);
+    if (checkNotModified(req, res, problemListETag(version, stats_version))) {
+        return;
+    }
+    
     // 构建响应
     Json::Value problemsJson(Json::arrayValue);
-    for (const auto& problem : problems) {
-        problemsJson.append(problem.toJson());
+    for (size_t i = 0; i < problems.size(); i++) {
+        Json::Value problemJson = problems[i].toJson();
+        stats[i].writeJson(problemJson, false);
+        problemsJson.append(problemJson);
     }
     
     Json::Value data;
@@ -212,7 +285,7 @@ void ProblemController::handleGetProblemDetail(const http::Request& req, http::R
     // 从URL中提取题目ID
     std::cout << "开始处理获取题目详情请求，路径: " << req.path << std::endl;
     
-    int problem_id = getIdFromPath(req.path, "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         std::cerr << "错误: 从路径 " << req.path << " 提取的题目ID无效: " << problem_id << std::endl;
         sendErrorResponse(res, "无效的题目ID", 400);
@@ -223,6 +296,23 @@ void ProblemController::handleGetProblemDetail(const http::Request& req, http::R
     
     // 获取题目详情（包括示例测试用例）
     try {
+        // 先用更新时间和题目统计的版本生成ETag，未变化时无需加载题目和测试用例
+        uint64_t version = CacheVersion::get(CacheVersion::PROBLEMS);
+        uint64_t stats_version = 0;
+        ProblemStatsItem stats = ProblemStats::get(problem_id, stats_version);
+        int64_t updated_at = ProblemService::getProblemUpdatedAt(problem_id);
+        if (updated_at < 0) {
+            std::cerr << "错误: 题目ID " << problem_id << " 不存在" << std::endl;
+            sendErrorResponse(res, "题目不存在", 404);
+            return;
+        }
+        
+        std::string etag = "\"p" + std::to_string(problem_id) + "-" + std::to_string(updated_at) + "-" +
+                           std::to_string(version) + "-" + std::to_string(stats_version) + "\"";
+        if (checkNotModified(req, res, etag)) {
+            return;
+        }
+        
         Problem problem = ProblemService::getProblemById(problem_id, true);
         
         if (problem.getId() == 0) {
@@ -234,6 +324,7 @@ void ProblemController::handleGetProblemDetail(const http::Request& req, http::R
         // 构建响应
         Json::Value data;
         data["problem"] = problem.toJson();
+        stats.writeJson(data["problem"], true);
         
         std::cout << "成功获取题目详情，题目ID: " << problem_id << ", 标题: " << problem.getTitle() << std::endl;
         
@@ -251,26 +342,28 @@ void ProblemController::handleGetProblemDetail(const http::Request& req, http::R
 
 // 创建题目
 void ProblemController::handleCreateProblem(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
+    // 用户ID来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，直接填充题目对象
+    Problem problem;
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseProblem(req.body, problem, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
-    if (!reqJson.isMember("title") || !reqJson.isMember("description")) {
+    if (!fields.count("title") || !fields.count("description")) {
         sendErrorResponse(res, "请提供标题和描述", 400);
         return;
     }
     
-    // 创建题目对象
-    Problem problem = Problem::fromJson(reqJson);
     problem.setCreatedBy(user_id);
     
     // 保存题目
@@ -289,17 +382,15 @@ void ProblemController::handleCreateProblem(const http::Request& req, http::Resp
 // 更新题目
 void ProblemController::handleUpdateProblem(const http::Request& req, http::Response& res) {
     // 从URL中提取题目ID
-    int problem_id = getIdFromPath(req.path, "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         sendErrorResponse(res, "无效的题目ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID和角色
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -319,11 +410,15 @@ void ProblemController::handleUpdateProblem(const http::Request& req, http::Resp
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，直接填充更新后的题目对象
+    Problem updatedProblem;
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseProblem(req.body, updatedProblem, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
-    // 更新题目对象
-    Problem updatedProblem = Problem::fromJson(reqJson);
     updatedProblem.setId(problem_id);
     updatedProblem.setCreatedBy(existingProblem.getCreatedBy());
     updatedProblem.setCreatedAt(existingProblem.getCreatedAt());
@@ -344,7 +439,7 @@ void ProblemController::handleUpdateProblem(const http::Request& req, http::Resp
 // 删除题目
 void ProblemController::handleDeleteProblem(const http::Request& req, http::Response& res) {
     // 从URL中提取题目ID
-    int problem_id = getIdFromPath(req.path, "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         sendErrorResponse(res, "无效的题目ID", 400);
         return;
@@ -352,17 +447,9 @@ void ProblemController::handleDeleteProblem(const http::Request& req, http::Resp
     
     std::cout << "尝试删除题目 ID: " << problem_id << std::endl;
     
-    // 从请求头获取令牌获取用户ID和角色
-    std::string auth_header = req.get_header("Authorization");
-    if (auth_header.empty() || auth_header.length() <= 7) {
-        std::cout << "删除题目失败: 无效的Authorization头" << std::endl;
-        sendErrorResponse(res, "无效的认证信息", 401);
-        return;
-    }
-    
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     std::cout << "删除题目请求来自用户ID: " << user_id << ", 角色: " << user_role << std::endl;
     
@@ -393,17 +480,15 @@ void ProblemController::handleDeleteProblem(const http::Request& req, http::Resp
 // 获取测试用例
 void ProblemController::handleGetTestCases(const http::Request& req, http::Response& res) {
     // 从URL中提取题目ID
-    int problem_id = getIdFromPath(req.path, "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         sendErrorResponse(res, "无效的题目ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID和角色
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -435,17 +520,15 @@ void ProblemController::handleGetTestCases(const http::Request& req, http::Respo
 // 添加测试用例
 void ProblemController::handleAddTestCase(const http::Request& req, http::Response& res) {
     // 从URL中提取题目ID
-    int problem_id = getIdFromPath(req.path, "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         sendErrorResponse(res, "无效的题目ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID和角色
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -458,20 +541,22 @@ void ProblemController::handleAddTestCase(const http::Request& req, http::Respon
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，输入和期望输出直接读入测试用例，不再构建中间JSON对象
+    TestCase testcase = TestCase();
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseTestCase(req.body, testcase, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
-    if (!reqJson.isMember("input") || !reqJson.isMember("expected_output")) {
+    if (!fields.count("input") || !fields.count("expected_output")) {
         sendErrorResponse(res, "请提供输入和期望输出", 400);
         return;
     }
     
-    // 创建测试用例
-    TestCase testcase;
+    testcase.id = 0;
     testcase.problem_id = problem_id;
-    testcase.input = reqJson["input"].asString();
-    testcase.expected_output = reqJson["expected_output"].asString();
-    testcase.is_example = reqJson.isMember("is_example") ? reqJson["is_example"].asBool() : false;
     
     // 保存测试用例
     std::string error_message;
@@ -485,26 +570,27 @@ void ProblemController::handleAddTestCase(const http::Request& req, http::Respon
 // 更新测试用例
 void ProblemController::handleUpdateTestCase(const http::Request& req, http::Response& res) {
     // 从URL中提取测试用例ID
-    int testcase_id = getIdFromPath(req.path, "/api/testcases/");
+    int testcase_id = req.get_path_id("id");
     if (testcase_id <= 0) {
         sendErrorResponse(res, "无效的测试用例ID", 400);
         return;
     }
     
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
+    // 流式解析请求体，输入和期望输出直接读入测试用例
+    TestCase testcase = TestCase();
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseTestCase(req.body, testcase, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
+        return;
+    }
     
-    if (!reqJson.isMember("input") || !reqJson.isMember("expected_output")) {
+    if (!fields.count("input") || !fields.count("expected_output")) {
         sendErrorResponse(res, "请提供输入和期望输出", 400);
         return;
     }
     
-    // 创建测试用例
-    TestCase testcase;
     testcase.id = testcase_id;
-    testcase.input = reqJson["input"].asString();
-    testcase.expected_output = reqJson["expected_output"].asString();
-    testcase.is_example = reqJson.isMember("is_example") ? reqJson["is_example"].asBool() : false;
     
     // 保存测试用例
     std::string error_message;
@@ -518,7 +604,7 @@ void ProblemController::handleUpdateTestCase(const http::Request& req, http::Res
 // 删除测试用例
 void ProblemController::handleDeleteTestCase(const http::Request& req, http::Response& res) {
     // 从URL中提取测试用例ID
-    int testcase_id = getIdFromPath(req.path, "/api/testcases/");
+    int testcase_id = req.get_path_id("id");
     if (testcase_id <= 0) {
         sendErrorResponse(res, "无效的测试用例ID", 400);
         return;
@@ -536,22 +622,15 @@ void ProblemController::handleDeleteTestCase(const http::Request& req, http::Res
 // 获取题目的提交记录
 void ProblemController::handleGetProblemSubmissions(const http::Request& req, http::Response& res) {
     // 从URL中提取题目ID
-    int problem_id = getIdFromPath(req.get_base_path(), "/api/problems/");
+    int problem_id = req.get_path_id("id");
     if (problem_id <= 0) {
         sendErrorResponse(res, "无效的题目ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    if (auth_header.empty() || auth_header.length() <= 7) {
-        sendErrorResponse(res, "未授权访问", 401);
-        return;
-    }
-    
-    std::string token = auth_header.substr(7); // 去掉"Bearer "前缀
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -626,16 +705,9 @@ void ProblemController::handleGetProblemSubmissions(const http::Request& req, ht
 
 // 获取所有提交记录
 void ProblemController::handleGetAllSubmissions(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    if (auth_header.empty() || auth_header.length() <= 7) {
-        sendErrorResponse(res, "未授权访问", 401);
-        return;
-    }
-    
-    std::string token = auth_header.substr(7); // 去掉"Bearer "前缀
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -737,36 +809,29 @@ void ProblemController::handleGetAllSubmissions(const http::Request& req, http::
 
 // 提交代码处理
 void ProblemController::handleSubmitCode(const http::Request& req, http::Response& res) {
-    // 解析请求体
-    Json::Value reqJson = parseRequestBody(req.body);
-    
-    if (!reqJson.isMember("problem_id") || !reqJson.isMember("code") || !reqJson.isMember("language")) {
-        sendErrorResponse(res, "请提供题目ID、代码和语言", 400);
+    // 流式解析请求体，题目ID、代码和语言直接读入提交对象
+    Submission submission;
+    std::set<std::string> fields;
+    std::string parse_error;
+    if (!RequestBodyParser::parseSubmission(req.body, submission, fields, parse_error)) {
+        sendErrorResponse(res, parse_error, 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    if (auth_header.empty() || auth_header.length() <= 7) {
-        sendErrorResponse(res, "未授权访问", 401);
+    if (!fields.count("problem_id") || !fields.count("code") || !fields.count("language")) {
+        sendErrorResponse(res, "请提供题目ID、代码和语言", 400);
         return;
     }
     
-    std::string token = auth_header.substr(7); // 去掉"Bearer "前缀
-    int user_id = JWT::getUserIdFromToken(token);
+    // 用户ID来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
         return;
     }
     
-    // 获取提交的题目ID、代码和语言
-    int problem_id = reqJson["problem_id"].asInt();
-    std::string code = reqJson["code"].asString();
-    std::string language_str = reqJson["language"].asString();
-    
-    // 创建提交对象
-    Submission submission(user_id, problem_id, code, Submission::convertStringToLanguage(language_str));
+    submission.setUserId(user_id);
     
     // 设置初始状态
     submission.setResult(JudgeResult::PENDING);
@@ -788,36 +853,19 @@ void ProblemController::handleSubmitCode(const http::Request& req, http::Respons
     }
 }
 
-// 从路径参数中获取ID
-int ProblemController::getIdFromPath(const std::string& path, const std::string& prefix) {
-    std::regex pattern(prefix + "([0-9]+)");
-    std::smatch matches;
-    
-    if (std::regex_search(path, matches, pattern) && matches.size() > 1) {
-        try {
-            return std::stoi(matches[1].str());
-        } catch (std::exception& e) {
-            return -1;
-        }
-    }
-    
-    return -1;
-}
 
 // 获取单个提交详情
 void ProblemController::handleGetSubmissionDetail(const http::Request& req, http::Response& res) {
     // 从URL中提取提交ID
-    int submission_id = getIdFromPath(req.path, "/api/submissions/");
+    int submission_id = req.get_path_id("id");
     if (submission_id <= 0) {
         sendErrorResponse(res, "无效的提交ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
-    int user_role = JWT::getUserRoleFromToken(token);
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -845,19 +893,123 @@ void ProblemController::handleGetSubmissionDetail(const http::Request& req, http
     sendSuccessResponse(res, "获取提交详情成功", data);
 }
 
+// 将评测事件格式化为SSE消息
+static void appendSseEvent(std::string& out, size_t seq, const std::string& name, const std::string& data) {
+    out += "id: " + std::to_string(seq) + "\n";
+    out += "event: " + name + "\n";
+    out += "data: " + data + "\n\n";
+}
+
+// 订阅提交评测状态（Server-Sent Events）
+// 评测中的提交按顺序推送 status / progress / verdict 事件，收到 verdict 后服务端结束响应；
+// 已经评测结束的提交直接推送一次数据库中的最终结果
+void ProblemController::handleSubmissionEvents(const http::Request& req, http::Response& res) {
+    int submission_id = req.get_path_id("id");
+    if (submission_id <= 0) {
+        sendErrorResponse(res, "无效的提交ID", 400);
+        return;
+    }
+    
+    // 用户ID和角色来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
+    int user_role = req.claims->role;
+    
+    if (user_id <= 0) {
+        sendErrorResponse(res, "无效的用户ID", 401);
+        return;
+    }
+    
+    // 检查权限
+    if (!SubmissionService::checkSubmissionPermission(submission_id, user_id) && user_role < 2) {
+        sendErrorResponse(res, "没有权限查看此提交", 403);
+        return;
+    }
+    
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Accel-Buffering", "no"); // 关闭反向代理缓冲
+    
+    // 不在评测中的提交：推送数据库中的当前状态后结束
+    if (!SubmissionEvents::isTracked(submission_id)) {
+        Submission submission = SubmissionService::getSubmissionInfo(submission_id);
+        if (submission.getId() == 0) {
+            sendErrorResponse(res, "提交记录不存在", 404);
+            return;
+        }
+        
+        Json::Value data;
+        data["submission"] = submission.toJson();
+        bool judged = submission.getResult() != JudgeResult::PENDING && submission.getResult() != JudgeResult::JUDGING;
+        
+        std::string body;
+        appendSseEvent(body, 1, judged ? "verdict" : "status", http::JsonWriter::toString(data));
+        res.status_code = 200;
+        res.body = std::move(body);
+        res.set_content_type("text/event-stream");
+        return;
+    }
+    
+    // 每个推送流占用一个工作线程，超过上限时让客户端退回轮询
+    if (!SubmissionEvents::acquireStream()) {
+        res.set_header("Retry-After", "5");
+        sendErrorResponse(res, "订阅连接过多，请稍后重试", 503);
+        return;
+    }
+    
+    // 客户端重连时从 Last-Event-ID 之后继续推送
+    size_t last_seq = 0;
+    std::string last_event_id = req.get_header("Last-Event-ID");
+    if (!last_event_id.empty()) {
+        try {
+            last_seq = std::stoul(last_event_id);
+        } catch (const std::exception& e) {
+            last_seq = 0;
+        }
+    }
+    
+    std::shared_ptr<size_t> cursor = std::make_shared<size_t>(last_seq);
+    std::time_t deadline = std::time(nullptr) + SUBMISSION_STREAM_MAX_SECONDS;
+    
+    res.status_code = 200;
+    res.stream("text/event-stream", [submission_id, cursor, deadline](size_t offset, httplib::DataSink& sink) {
+        std::vector<SubmissionEvent> events;
+        bool finished = false;
+        bool tracked = SubmissionEvents::waitEvents(submission_id, *cursor, SUBMISSION_STREAM_HEARTBEAT_MS, events, finished);
+        
+        std::string chunk;
+        if (offset == 0) {
+            chunk += "retry: 3000\n\n";
+        }
+        for (const auto& event : events) {
+            appendSseEvent(chunk, event.seq, event.name, event.data);
+            *cursor = event.seq;
+        }
+        if (chunk.empty()) {
+            chunk = ": keep-alive\n\n"; // 心跳注释，同时用于探测客户端是否断开
+        }
+        
+        if (!sink.write(chunk.data(), chunk.size())) {
+            return false;
+        }
+        if (!tracked || finished || std::time(nullptr) >= deadline) {
+            sink.done();
+        }
+        return true;
+    }, [](bool) {
+        SubmissionEvents::releaseStream();
+    });
+}
+
 // 重新提交代码
 void ProblemController::handleResubmitCode(const http::Request& req, http::Response& res) {
     // 从URL中提取提交ID
-    int submission_id = getIdFromPath(req.path, "/api/submissions/resubmit/");
+    int submission_id = req.get_path_id("id");
     if (submission_id <= 0) {
         sendErrorResponse(res, "无效的提交ID", 400);
         return;
     }
     
-    // 从请求头获取令牌获取用户ID
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int user_id = JWT::getUserIdFromToken(token);
+    // 用户ID来自认证中间件已验证的令牌声明
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -1,4 +1,6 @@
 #include "../../include/controller/system_controller.h"
+#include "../../include/utils/jwt_keys.h"
+#include "../../include/http/json_writer.h"
 
 void SystemController::registerRoutes(http::HttpServer* server) {
     // 根路径 - 健康检查
@@ -10,6 +12,11 @@ void SystemController::registerRoutes(http::HttpServer* server) {
     server->get("/api/db_test", [this](const http::Request& req, http::Response& res) {
         this->handleDbTest(req, res);
     });
+    
+    // JWT公钥集合，供网关等服务独立验证令牌
+    server->get("/.well-known/jwks.json", [this](const http::Request& req, http::Response& res) {
+        this->handleJwks(req, res);
+    });
 }
 
 // 健康检查处理
@@ -28,4 +35,13 @@ void SystemController::handleDbTest(const http::Request& req, http::Response& re
     } else {
         sendErrorResponse(res, "数据库连接异常", 500);
     }
+}
+
+// 发布JWT验证公钥集合（JWKS）
+// 直接输出标准JWKS格式而不包装为统一响应结构，未启用非对称签名时返回空集合
+void SystemController::handleJwks(const http::Request& req, http::Response& res) {
+    res.status_code = 200;
+    res.set_content_type("application/json");
+    res.set_header("Cache-Control", "public, max-age=300");
+    res.body = http::JsonWriter::toString(JwtKeyStore::jwks());
 } 
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "../../include/controller/user_controller.h"
+#include "../../include/utils/password_hasher.h"
+#include "../../include/services/ranking_service.h"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -99,7 +101,7 @@ void UserController::handleLogin(const http::Request& req, http::Response& res)
     std::string token = UserService::login(username, password, error_message);
     
     if (token.empty()) {
-        sendErrorResponse(res, error_message, 401);
+        sendPasswordErrorResponse(res, error_message, 401);
     } else {
         Json::Value data;
         data["token"] = token;
@@ -126,18 +128,14 @@ void UserController::handleRegister(const http::Request& req, http::Response& re
     if (success) {
         sendSuccessResponse(res, "注册成功，请登录");
     } else {
-        sendErrorResponse(res, error_message, 400);
+        sendPasswordErrorResponse(res, error_message, 400);
     }
 }
 
 // 获取用户信息处理
 void UserController::handleGetProfile(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    
-    // 获取用户ID
-    int user_id = JWT::getUserIdFromToken(token);
+    // 获取用户ID（来自认证中间件已验证的令牌声明）
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -153,7 +151,7 @@ void UserController::handleGetProfile(const http::Request& req, http::Response&
     }
     
     // 将用户信息添加到响应中
-    Json::Value userJson = parseRequestBody(user.toJson());
+    Json::Value userJson = user.toJson();
     Json::Value data;
     data["user"] = userJson;
     
@@ -162,12 +160,8 @@ void UserController::handleGetProfile(const http::Request& req, http::Response&
 
 // 更新用户信息处理
 void UserController::handleUpdateProfile(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    
-    // 获取用户ID
-    int user_id = JWT::getUserIdFromToken(token);
+    // 获取用户ID（来自认证中间件已验证的令牌声明）
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -193,7 +187,7 @@ void UserController::handleUpdateProfile(const http::Request& req, http::Respons
         User user = UserService::getUserInfo(user_id);
         
         // 将用户信息添加到响应中
-        Json::Value userJson = parseRequestBody(user.toJson());
+        Json::Value userJson = user.toJson();
         Json::Value data;
         data["user"] = userJson;
         
@@ -205,12 +199,8 @@ void UserController::handleUpdateProfile(const http::Request& req, http::Respons
 
 // 修改密码处理
 void UserController::handleChangePassword(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    
-    // 获取用户ID
-    int user_id = JWT::getUserIdFromToken(token);
+    // 获取用户ID（来自认证中间件已验证的令牌声明）
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -235,7 +225,7 @@ void UserController::handleChangePassword(const http::Request& req, http::Respon
     if (success) {
         sendSuccessResponse(res, "密码更改成功");
     } else {
-        sendErrorResponse(res, error_message, 400);
+        sendPasswordErrorResponse(res, error_message, 400);
     }
 }
 
@@ -252,16 +242,16 @@ void UserController::handleVerifyToken(const http::Request& req, http::Response&
     // 提取令牌
     std::string token = auth_header.substr(7);
     
-    // 验证令牌
-    std::map<std::string, std::string> payload;
-    if (!JWT::verifyToken(token, payload)) {
+    // 验证令牌（只解析一次，结果经过缓存）
+    std::shared_ptr<const TokenClaims> claims = JWT::verifyClaims(token);
+    if (!claims) {
         sendErrorResponse(res, "认证令牌无效或已过期", 401);
         return;
     }
     
     // 获取用户ID和角色
-    int user_id = JWT::getUserIdFromToken(token);
-    int role = JWT::getUserRoleFromToken(token);
+    int user_id = claims->user_id;
+    int role = claims->role;
     
     // 获取用户信息
     User user = UserService::getUserInfo(user_id);
@@ -316,12 +306,8 @@ void UserController::handleGetLeaderboard(const http::Request& req, http::Respon
         }
     }
     
-    // 从请求头获取令牌
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    
-    // 获取当前用户ID
-    int current_user_id = JWT::getUserIdFromToken(token);
+    // 获取当前用户ID（来自认证中间件已验证的令牌声明）
+    int current_user_id = req.claims->user_id;
     
     // 获取排行榜数据
     Json::Value leaderboard_data;
@@ -335,6 +321,11 @@ void UserController::handleGetLeaderboard(const http::Request& req, http::Respon
         data["leaderboard"] = leaderboard_data;
         data["total"] = total;
         
+        // 总榜附带当前用户的名次（0表示未上榜）
+        if (time_range == "all") {
+            data["current_user_rank"] = RankingService::getUserRankingPosition(current_user_id);
+        }
+        
         sendSuccessResponse(res, "获取排行榜成功", data);
     } else {
         sendErrorResponse(res, error_message, 400);
@@ -343,12 +334,8 @@ void UserController::handleGetLeaderboard(const http::Request& req, http::Respon
 
 // 获取用户题目状态处理
 void UserController::handleGetProblemStatus(const http::Request& req, http::Response& res) {
-    // 从请求头获取令牌
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    
-    // 获取当前用户ID
-    int user_id = JWT::getUserIdFromToken(token);
+    // 获取当前用户ID（来自认证中间件已验证的令牌声明）
+    int user_id = req.claims->user_id;
     
     if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 401);
@@ -484,32 +471,15 @@ void UserController::handleCreateUser(const http::Request& req, http::Response&
     if (success) {
         sendSuccessResponse(res, "创建用户成功");
     } else {
-        sendErrorResponse(res, error_message, 400);
+        sendPasswordErrorResponse(res, error_message, 400);
     }
 }
 
 // 更新用户信息（管理员）
 void UserController::handleUpdateUser(const http::Request& req, http::Response& res) {
-    // 从URL路径获取用户ID
-    std::string path = req.path;
-    size_t last_slash_pos = path.find_last_of('/');
-    
-    if (last_slash_pos == std::string::npos || last_slash_pos == path.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_str = path.substr(last_slash_pos + 1);
-    // 从ID字符串中移除查询参数（如果有）
-    size_t query_pos = id_str.find('?');
-    if (query_pos != std::string::npos) {
-        id_str = id_str.substr(0, query_pos);
-    }
-    
-    int user_id;
-    try {
-        user_id = std::stoi(id_str);
-    } catch (...) {
+    // 从路由参数获取用户ID
+    int user_id = req.get_path_id("id");
+    if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 400);
         return;
     }
@@ -526,7 +496,7 @@ void UserController::handleUpdateUser(const http::Request& req, http::Response&
         User user = UserService::getUserInfo(user_id);
         
         // 将用户信息添加到响应中
-        Json::Value userJson = parseRequestBody(user.toJson());
+        Json::Value userJson = user.toJson();
         Json::Value data;
         data["user"] = userJson;
         
@@ -538,34 +508,15 @@ void UserController::handleUpdateUser(const http::Request& req, http::Response&
 
 // 删除用户（管理员）
 void UserController::handleDeleteUser(const http::Request& req, http::Response& res) {
-    // 从URL路径获取用户ID
-    std::string path = req.path;
-    size_t last_slash_pos = path.find_last_of('/');
-    
-    if (last_slash_pos == std::string::npos || last_slash_pos == path.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_str = path.substr(last_slash_pos + 1);
-    // 从ID字符串中移除查询参数（如果有）
-    size_t query_pos = id_str.find('?');
-    if (query_pos != std::string::npos) {
-        id_str = id_str.substr(0, query_pos);
-    }
-    
-    int user_id;
-    try {
-        user_id = std::stoi(id_str);
-    } catch (...) {
+    // 从路由参数获取用户ID
+    int user_id = req.get_path_id("id");
+    if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 400);
         return;
     }
     
     // 获取当前操作用户ID以确保不删除自己
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int current_user_id = JWT::getUserIdFromToken(token);
+    int current_user_id = req.claims->user_id;
     
     if (user_id == current_user_id) {
         sendErrorResponse(res, "不能删除自己的账户", 400);
@@ -585,36 +536,15 @@ void UserController::handleDeleteUser(const http::Request& req, http::Response&
 
 // 更改用户角色（管理员）
 void UserController::handleChangeUserRole(const http::Request& req, http::Response& res) {
-    // 从URL路径获取用户ID
-    std::string path = req.path;
-    size_t last_slash_pos = path.find_last_of('/');
-    
-    if (last_slash_pos == std::string::npos || last_slash_pos == path.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_part = path.substr(0, last_slash_pos);
-    size_t user_id_pos = id_part.find_last_of('/');
-    
-    if (user_id_pos == std::string::npos || user_id_pos == id_part.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_str = id_part.substr(user_id_pos + 1);
-    int user_id;
-    try {
-        user_id = std::stoi(id_str);
-    } catch (...) {
+    // 从路由参数获取用户ID
+    int user_id = req.get_path_id("id");
+    if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 400);
         return;
     }
     
     // 获取当前操作用户ID以确保不更改自己的角色
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int current_user_id = JWT::getUserIdFromToken(token);
+    int current_user_id = req.claims->user_id;
     
     if (user_id == current_user_id) {
         sendErrorResponse(res, "不能更改自己的角色", 400);
@@ -648,36 +578,15 @@ void UserController::handleChangeUserRole(const http::Request& req, http::Respon
 
 // 更改用户状态（管理员）
 void UserController::handleChangeUserStatus(const http::Request& req, http::Response& res) {
-    // 从URL路径获取用户ID
-    std::string path = req.path;
-    size_t last_slash_pos = path.find_last_of('/');
-    
-    if (last_slash_pos == std::string::npos || last_slash_pos == path.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_part = path.substr(0, last_slash_pos);
-    size_t user_id_pos = id_part.find_last_of('/');
-    
-    if (user_id_pos == std::string::npos || user_id_pos == id_part.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_str = id_part.substr(user_id_pos + 1);
-    int user_id;
-    try {
-        user_id = std::stoi(id_str);
-    } catch (...) {
+    // 从路由参数获取用户ID
+    int user_id = req.get_path_id("id");
+    if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 400);
         return;
     }
     
     // 获取当前操作用户ID以确保不更改自己的状态
-    std::string auth_header = req.get_header("Authorization");
-    std::string token = auth_header.substr(7);
-    int current_user_id = JWT::getUserIdFromToken(token);
+    int current_user_id = req.claims->user_id;
     
     if (user_id == current_user_id) {
         sendErrorResponse(res, "不能更改自己的状态", 400);
@@ -711,28 +620,9 @@ void UserController::handleChangeUserStatus(const http::Request& req, http::Resp
 
 // 重置用户密码（管理员）
 void UserController::handleResetUserPassword(const http::Request& req, http::Response& res) {
-    // 从URL路径获取用户ID
-    std::string path = req.path;
-    size_t last_slash_pos = path.find_last_of('/');
-    
-    if (last_slash_pos == std::string::npos || last_slash_pos == path.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_part = path.substr(0, last_slash_pos);
-    size_t user_id_pos = id_part.find_last_of('/');
-    
-    if (user_id_pos == std::string::npos || user_id_pos == id_part.length() - 1) {
-        sendErrorResponse(res, "无效的用户ID", 400);
-        return;
-    }
-    
-    std::string id_str = id_part.substr(user_id_pos + 1);
-    int user_id;
-    try {
-        user_id = std::stoi(id_str);
-    } catch (...) {
+    // 从路由参数获取用户ID
+    int user_id = req.get_path_id("id");
+    if (user_id <= 0) {
         sendErrorResponse(res, "无效的用户ID", 400);
         return;
     }
@@ -754,6 +644,16 @@ void UserController::handleResetUserPassword(const http::Request& req, http::Res
     if (success) {
         sendSuccessResponse(res, "用户密码重置成功");
     } else {
-        sendErrorResponse(res, error_message, 400);
+        sendPasswordErrorResponse(res, error_message, 400);
+    }
+}
+
+// 发送涉及密码哈希的错误响应，哈希线程池繁忙时返回503
+void UserController::sendPasswordErrorResponse(http::Response& res, const std::string& error_message, int status_code) {
+    if (error_message == PASSWORD_HASHER_BUSY_MESSAGE) {
+        res.set_header("Retry-After", "1");
+        sendErrorResponse(res, error_message, 503);
+        return;
     }
+    sendErrorResponse(res, error_message, status_code);
 } 
\ No newline at end of file
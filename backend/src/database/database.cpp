@@ -105,6 +105,146 @@ bool Database::executeCommand(const std::string& command) {
     return result;
 }
 
+bool Database::executeCommand(const std::string& command, unsigned long long& affected_rows) {
+    affected_rows = 0;
+    if (!initialized) {
+        std::cerr << "数据库连接池未初始化" << std::endl;
+        return false;
+    }
+    
+    auto pool = DatabasePool::getInstance();
+    auto conn = pool->getConnection();
+    
+    if (!conn) {
+        std::cerr << "无法获取数据库连接" << std::endl;
+        return false;
+    }
+    
+    bool result = conn->executeCommand(command);
+    if (result) {
+        affected_rows = conn->getAffectedRows();
+    } else {
+        std::cerr << "命令执行失败" << std::endl;
+    }
+    
+    pool->releaseConnection(conn);
+    return result;
+}
+
+bool Database::executeInsert(const std::string& command, unsigned long long& insert_id) {
+    insert_id = 0;
+    if (!initialized) {
+        std::cerr << "数据库连接池未初始化" << std::endl;
+        return false;
+    }
+    
+    auto pool = DatabasePool::getInstance();
+    auto conn = pool->getConnection();
+    
+    if (!conn) {
+        std::cerr << "无法获取数据库连接" << std::endl;
+        return false;
+    }
+    
+    bool result = conn->executeCommand(command);
+    if (result) {
+        insert_id = conn->getLastInsertId();
+    } else {
+        std::cerr << "命令执行失败" << std::endl;
+    }
+    
+    pool->releaseConnection(conn);
+    return result;
+}
+
+bool Database::executeTransaction(const std::vector<std::string>& commands, unsigned long long& affected_rows) {
+    affected_rows = 0;
+    if (!initialized) {
+        std::cerr << "数据库连接池未初始化" << std::endl;
+        return false;
+    }
+    
+    auto pool = DatabasePool::getInstance();
+    auto conn = pool->getConnection();
+    
+    if (!conn) {
+        std::cerr << "无法获取数据库连接" << std::endl;
+        return false;
+    }
+    
+    // 事务中的语句必须在同一连接上执行，不能逐条借用连接池
+    bool result = conn->executeCommand("START TRANSACTION");
+    for (size_t i = 0; result && i < commands.size(); i++) {
+        result = conn->executeCommand(commands[i]);
+        if (result) {
+            affected_rows += conn->getAffectedRows();
+        } else {
+            std::cerr << "事务中的命令执行失败: " << commands[i] << std::endl;
+        }
+    }
+    if (result) {
+        result = conn->executeCommand("COMMIT");
+    }
+    if (!result) {
+        conn->executeCommand("ROLLBACK");
+        affected_rows = 0;
+    }
+    
+    pool->releaseConnection(conn);
+    return result;
+}
+
+bool Database::executeTransaction(const std::string& query,
+                                  const std::function<bool(MYSQL_RES*, std::vector<std::string>&)>& build,
+                                  const std::vector<std::string>& commands, unsigned long long& affected_rows) {
+    affected_rows = 0;
+    if (!initialized) {
+        std::cerr << "数据库连接池未初始化" << std::endl;
+        return false;
+    }
+    
+    auto pool = DatabasePool::getInstance();
+    auto conn = pool->getConnection();
+    
+    if (!conn) {
+        std::cerr << "无法获取数据库连接" << std::endl;
+        return false;
+    }
+    
+    // 查询在事务内执行，读到的行在提交前不会被其他事务修改
+    std::vector<std::string> all_commands;
+    bool result = conn->executeCommand("START TRANSACTION");
+    if (result) {
+        MYSQL_RES* res = conn->executeQuery(query);
+        result = res != nullptr && build(res, all_commands);
+        if (res) {
+            mysql_free_result(res);
+        }
+        if (!result) {
+            std::cerr << "事务中的查询执行失败: " << query << std::endl;
+        }
+    }
+    all_commands.insert(all_commands.end(), commands.begin(), commands.end());
+    for (size_t i = 0; result && i < all_commands.size(); i++) {
+        result = conn->executeCommand(all_commands[i]);
+        if (result) {
+            affected_rows += conn->getAffectedRows();
+        } else {
+            std::cerr << "事务中的命令执行失败: " << all_commands[i] << std::endl;
+        }
+    }
+    if (result) {
+        result = conn->executeCommand("COMMIT");
+    }
+    if (!result) {
+        conn->executeCommand("ROLLBACK");
+        affected_rows = 0;
+    }
+    
+    pool->releaseConnection(conn);
+    return result;
+}
+
 unsigned long long Database::getAffectedRows() {
     if (!initialized) {
         return 0;
@@ -118,18 +118,94 @@ CREATE TABLE IF NOT EXISTS `discussion_replies` (
   KEY `parent_id` (`parent_id`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='讨论回复表';
 
--- 用户排名表（预计算的排名）
+-- 点赞记录表（每个用户对每个讨论或回复最多一条）
+CREATE TABLE IF NOT EXISTS `discussion_likes` (
+  `user_id` INT UNSIGNED NOT NULL COMMENT '用户ID',
+  `target_type` TINYINT NOT NULL COMMENT '目标类型：0-讨论，1-回复',
+  `target_id` INT UNSIGNED NOT NULL COMMENT '讨论ID或回复ID',
+  `created_at` BIGINT NOT NULL COMMENT '点赞时间',
+  PRIMARY KEY (`user_id`, `target_type`, `target_id`),
+  KEY `target` (`target_type`, `target_id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='点赞记录表';
+
+-- 用户排名表（总排行榜的持久化结果，由后端在评测后按用户更新）
 CREATE TABLE IF NOT EXISTS `user_rankings` (
   `user_id` INT UNSIGNED NOT NULL COMMENT '用户ID',
   `solved_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '解决题目数',
+  `attempted_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '尝试题目数',
   `total_submissions` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '总提交数',
-  `acceptance_rate` FLOAT NOT NULL DEFAULT 0 COMMENT '通过率',
+  `easy_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '解决简单题数',
+  `medium_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '解决中等题数',
+  `hard_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '解决困难题数',
   `score` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '总分',
-  `last_submission_at` TIMESTAMP NULL DEFAULT NULL COMMENT '最后提交时间',
-  `updated_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+  `acceptance_rate` FLOAT NOT NULL DEFAULT 0 COMMENT '通过率',
+  `last_submission` BIGINT NOT NULL DEFAULT 0 COMMENT '最后提交时间',
+  `updated_at` BIGINT NOT NULL COMMENT '更新时间',
   PRIMARY KEY (`user_id`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='用户排名表';
 
+-- 用户题目状态表（每个用户提交过的题目，评测时由写入结果判断是否首次提交/首次通过）
+CREATE TABLE IF NOT EXISTS `user_problem_status` (
+  `user_id` INT UNSIGNED NOT NULL COMMENT '用户ID',
+  `problem_id` INT UNSIGNED NOT NULL COMMENT '题目ID',
+  `solved` TINYINT NOT NULL DEFAULT 0 COMMENT '是否已通过',
+  `solved_at` BIGINT NOT NULL DEFAULT 0 COMMENT '首次通过时间',
+  PRIMARY KEY (`user_id`, `problem_id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='用户题目状态表';
+
+-- 每日排名统计表（日/周/月榜按日期范围对分桶求和）
+CREATE TABLE IF NOT EXISTS `user_daily_stats` (
+  `day` INT UNSIGNED NOT NULL COMMENT '日期，格式 yyyymmdd',
+  `user_id` INT UNSIGNED NOT NULL COMMENT '用户ID',
+  `submission_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '已评测的提交数',
+  `accepted_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '通过的提交数',
+  `solved_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '首次通过的题目数',
+  `easy_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '首次通过的简单题数',
+  `medium_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '首次通过的中等题数',
+  `hard_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '首次通过的困难题数',
+  `score` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '得分',
+  PRIMARY KEY (`day`, `user_id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='每日排名统计表';
+
+-- 题目提交统计表（评测结束时在内存中累加，定期写回）
+CREATE TABLE IF NOT EXISTS `problem_stats` (
+  `problem_id` INT UNSIGNED NOT NULL COMMENT '题目ID',
+  `submission_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '已评测的提交数',
+  `solver_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '通过该题的用户数',
+  `accepted_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '通过的提交数',
+  `wrong_answer_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '答案错误的提交数',
+  `time_limit_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '超时的提交数',
+  `memory_limit_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '内存超限的提交数',
+  `runtime_error_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '运行时错误的提交数',
+  `compile_error_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '编译错误的提交数',
+  `system_error_count` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '系统错误的提交数',
+  `updated_at` BIGINT NOT NULL DEFAULT 0 COMMENT '最后写回时间',
+  PRIMARY KEY (`problem_id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='题目提交统计表';
+
+-- 题目删除任务表（关联数据由后台分批删除，重启后从记录的阶段继续）
+CREATE TABLE IF NOT EXISTS `problem_deletions` (
+  `problem_id` INT UNSIGNED NOT NULL COMMENT '题目ID',
+  `stage` TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '删除阶段（0-提交记录，1-讨论回复，2-讨论，3-测试用例，4-题目）',
+  `created_at` BIGINT NOT NULL COMMENT '登记时间',
+  `updated_at` BIGINT NOT NULL COMMENT '最后进度时间',
+  PRIMARY KEY (`problem_id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='题目删除任务表';
+
+-- 缓存版本表
+CREATE TABLE IF NOT EXISTS `cache_versions` (
+  `scope` INT NOT NULL COMMENT '作用域（0-题目，1-讨论，2-题目统计）',
+  `version` BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '版本号，数据变更时递增，用于生成ETag',
+  PRIMARY KEY (`scope`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='缓存版本表';
+
+-- 初始化标记表（排行、用户题目状态、每日统计等表从提交记录完整建立后写入，启动时据此决定是否重建）
+CREATE TABLE IF NOT EXISTS `init_markers` (
+  `name` VARCHAR(64) NOT NULL COMMENT '标记名（user_rankings / user_problem_status / user_daily_stats）',
+  `created_at` BIGINT NOT NULL COMMENT '建立时间',
+  PRIMARY KEY (`name`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='初始化标记表';
+
 -- 初始化管理员用户（密码为admin的MD5哈希）
 INSERT INTO `users` (`username`, `password`, `email`, `role`, `status`)
 VALUES ('admin', '21232f297a57a5a743894a0e4a801fc3', 'admin@example.com', 1, 1); 
\ No newline at end of file
@@ -5,43 +5,78 @@
 #include <csignal>
 #include "../include/database/database.h"
 #include "../include/http/http_server.h"
+#include "../include/http/server_config.h"
 #include "../include/utils/jwt.h"
+#include "../include/utils/jwt_keys.h"
+#include "../include/utils/password_hasher.h"
 #include "../include/controller/controller_manager.h"
 #include "../include/services/submission_service.h"
+#include "../include/services/submission_events.h"
+#include "../include/services/discussion_view_counter.h"
+#include "../include/services/hot_discussions.h"
+#include "../include/services/discussion_likes.h"
+#include "../include/services/ranking_service.h"
+#include "../include/services/problem_search_index.h"
+#include "../include/services/problem_catalog.h"
+#include "../include/services/problem_stats.h"
+#include "../include/services/problem_deletion.h"
+#include "../include/services/toolchain_registry.h"
 #include <json/json.h>
 
 // 全局HTTP服务器实例
 http::HttpServer* server = nullptr;
 
+// 收到的终止信号，由主线程在监听返回后输出
+volatile sig_atomic_t received_signal = 0;
+
 // 信号处理函数，用于优雅地关闭服务器
+// 只记录信号并停止监听（关闭监听套接字），不能在这里加锁、写回数据或等待线程，
+// 监听返回后由主线程执行 stopServices()
 void signal_handler(int signal) {
-    std::cout << "接收到信号 " << signal << "，正在关闭服务器..." << std::endl;
-    
-    // 停止评测线程
-    SubmissionService::stopJudgeThread();
-    
+    received_signal = signal;
     if (server) {
         server->stop();
     }
-    exit(0);
+}
+
+// 停止后台线程，写回尚未保存的浏览量、点赞数和题目统计
+static void stopServices() {
+    SubmissionService::stopJudgeThread();
+    DiscussionViewCounter::stop();
+    DiscussionLikes::stop();
+    ProblemStats::stop();
+    ProblemDeletion::stop();
+    HotDiscussions::stop();
 }
 
 int main(int argc, char** argv) {
     std::cout << "启动在线评测系统后端..." << std::endl;
     
-    // 解析命令行参数
-    uint16_t port = 8080; // 默认端口
-    for (int i = 1; i < argc; i++) {
-        std::string arg = argv[i];
-        if (arg == "--port" && i + 1 < argc) {
-            port = static_cast<uint16_t>(std::stoi(argv[i + 1]));
-            i++; // 跳过下一个参数
+    // 解析服务器配置（配置文件 + 命令行参数）
+    http::ServerConfig config;
+    std::string config_error;
+    if (!config.parseArgs(argc, argv, config_error)) {
+        std::cerr << "服务器配置错误: " << config_error << std::endl;
+        return 1;
+    }
+    config.print();
+    uint16_t port = config.port;
+    
+    // 初始化JWT密钥
+    if (!config.jwt_secret.empty()) {
+        JWT::setSecretKey(config.jwt_secret);
+    }
+    if (!config.jwt_signing_key.empty()) {
+        std::string key_error;
+        if (!JwtKeyStore::load(config.jwt_signing_key, config.jwt_verify_keys, key_error)) {
+            std::cerr << "JWT密钥加载失败: " << key_error << std::endl;
+            return 1;
         }
     }
     
-    // 注册信号处理器，以便正确处理Ctrl+C等信号
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
+    // 推送流和等待密码哈希的请求各自最多占用一部分HTTP工作线程
+    SubmissionEvents::setStreamLimit(config.worker_threads);
+    PasswordHasher::setConcurrencyLimit(config.worker_threads);
     
     // 初始化数据库连接
     Database* db = Database::getInstance();
@@ -60,12 +95,15 @@ int main(int argc, char** argv) {
     
     std::cout << "数据库连接成功" << std::endl;
     
-    // 启动评测线程
-    SubmissionService::ensureJudgeThreadRunning();
-    std::cout << "评测服务初始化完成" << std::endl;
+    // 检查各语言的编译器和解释器并预热（如生成JVM类数据共享归档）
+    ToolchainRegistry::initialize();
+    
+    // 启动浏览量和点赞数写回线程
+    DiscussionViewCounter::start();
+    DiscussionLikes::start();
     
     // 创建HTTP服务器，使用httplib实现，监听指定端口
-    server = new http::HttpServer(port);
+    server = new http::HttpServer(config);
     
     // 使用控制器管理器注册所有路由
     ControllerManager controllerManager;
@@ -223,6 +261,145 @@ int main(int argc, char** argv) {
         std::cout << "讨论回复表已就绪" << std::endl;
     }
     
+    // 创建点赞记录表
+    std::string create_discussion_likes_table = 
+        "CREATE TABLE IF NOT EXISTS discussion_likes ("
+        "user_id INT NOT NULL,"
+        "target_type TINYINT NOT NULL," // 0-讨论, 1-回复
+        "target_id INT NOT NULL,"
+        "created_at BIGINT NOT NULL,"
+        "PRIMARY KEY (user_id, target_type, target_id),"
+        "KEY idx_discussion_likes_target (target_type, target_id)"
+        ")";
+    
+    if (!db->executeCommand(create_discussion_likes_table)) {
+        std::cerr << "创建点赞记录表失败" << std::endl;
+    } else {
+        std::cout << "点赞记录表已就绪" << std::endl;
+    }
+    
+    // 创建用户排名表（总排行榜的持久化结果）
+    std::string create_user_rankings_table = 
+        "CREATE TABLE IF NOT EXISTS user_rankings ("
+        "user_id INT PRIMARY KEY,"
+        "solved_count INT NOT NULL DEFAULT 0,"
+        "attempted_count INT NOT NULL DEFAULT 0,"
+        "total_submissions INT NOT NULL DEFAULT 0,"
+        "easy_count INT NOT NULL DEFAULT 0,"
+        "medium_count INT NOT NULL DEFAULT 0,"
+        "hard_count INT NOT NULL DEFAULT 0,"
+        "score INT NOT NULL DEFAULT 0,"
+        "acceptance_rate FLOAT NOT NULL DEFAULT 0,"
+        "last_submission BIGINT NOT NULL DEFAULT 0,"
+        "updated_at BIGINT NOT NULL"
+        ")";
+    
+    if (!db->executeCommand(create_user_rankings_table)) {
+        std::cerr << "创建用户排名表失败" << std::endl;
+    } else {
+        std::cout << "用户排名表已就绪" << std::endl;
+    }
+    
+    // 创建用户题目状态表（每个用户提交过的题目及是否通过）
+    std::string create_user_problem_status_table = 
+        "CREATE TABLE IF NOT EXISTS user_problem_status ("
+        "user_id INT NOT NULL,"
+        "problem_id INT NOT NULL,"
+        "solved TINYINT NOT NULL DEFAULT 0,"
+        "solved_at BIGINT NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (user_id, problem_id)"
+        ")";
+    
+    if (!db->executeCommand(create_user_problem_status_table)) {
+        std::cerr << "创建用户题目状态表失败" << std::endl;
+    } else {
+        std::cout << "用户题目状态表已就绪" << std::endl;
+    }
+    
+    // 创建每日排名统计表（日/周/月榜的分桶，day 为 yyyymmdd）
+    std::string create_user_daily_stats_table = 
+        "CREATE TABLE IF NOT EXISTS user_daily_stats ("
+        "day INT NOT NULL,"
+        "user_id INT NOT NULL,"
+        "submission_count INT NOT NULL DEFAULT 0,"
+        "accepted_count INT NOT NULL DEFAULT 0,"
+        "solved_count INT NOT NULL DEFAULT 0," // 首次通过的题目数
+        "easy_count INT NOT NULL DEFAULT 0,"
+        "medium_count INT NOT NULL DEFAULT 0,"
+        "hard_count INT NOT NULL DEFAULT 0,"
+        "score INT NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (day, user_id)"
+        ")";
+    
+    if (!db->executeCommand(create_user_daily_stats_table)) {
+        std::cerr << "创建每日排名统计表失败" << std::endl;
+    } else {
+        std::cout << "每日排名统计表已就绪" << std::endl;
+    }
+    
+    // 创建题目提交统计表（提交数、通过人数和各评测结果的计数）
+    std::string create_problem_stats_table = 
+        "CREATE TABLE IF NOT EXISTS problem_stats ("
+        "problem_id INT PRIMARY KEY,"
+        "submission_count INT NOT NULL DEFAULT 0,"
+        "solver_count INT NOT NULL DEFAULT 0,"
+        "accepted_count INT NOT NULL DEFAULT 0,"
+        "wrong_answer_count INT NOT NULL DEFAULT 0,"
+        "time_limit_count INT NOT NULL DEFAULT 0,"
+        "memory_limit_count INT NOT NULL DEFAULT 0,"
+        "runtime_error_count INT NOT NULL DEFAULT 0,"
+        "compile_error_count INT NOT NULL DEFAULT 0,"
+        "system_error_count INT NOT NULL DEFAULT 0,"
+        "updated_at BIGINT NOT NULL DEFAULT 0"
+        ")";
+    
+    if (!db->executeCommand(create_problem_stats_table)) {
+        std::cerr << "创建题目统计表失败" << std::endl;
+    } else {
+        std::cout << "题目统计表已就绪" << std::endl;
+    }
+    
+    // 创建题目删除任务表（stage 为已进行到的删除阶段，重启后从该阶段继续）
+    std::string create_problem_deletions_table = 
+        "CREATE TABLE IF NOT EXISTS problem_deletions ("
+        "problem_id INT PRIMARY KEY,"
+        "stage TINYINT NOT NULL DEFAULT 0,"
+        "created_at BIGINT NOT NULL,"
+        "updated_at BIGINT NOT NULL"
+        ")";
+    
+    if (!db->executeCommand(create_problem_deletions_table)) {
+        std::cerr << "创建题目删除任务表失败" << std::endl;
+    } else {
+        std::cout << "题目删除任务表已就绪" << std::endl;
+    }
+    
+    // 创建缓存版本表（ETag使用的版本号，多实例共享、重启后保留）
+    std::string create_cache_versions_table = 
+        "CREATE TABLE IF NOT EXISTS cache_versions ("
+        "scope INT PRIMARY KEY,"
+        "version BIGINT UNSIGNED NOT NULL DEFAULT 0"
+        ")";
+    
+    if (!db->executeCommand(create_cache_versions_table)) {
+        std::cerr << "创建缓存版本表失败" << std::endl;
+    } else {
+        std::cout << "缓存版本表已就绪" << std::endl;
+    }
+    
+    // 创建初始化标记表（记录排行、用户题目状态等表已从提交记录完整建立）
+    std::string create_init_markers_table = 
+        "CREATE TABLE IF NOT EXISTS init_markers ("
+        "name VARCHAR(64) PRIMARY KEY,"
+        "created_at BIGINT NOT NULL"
+        ")";
+    
+    if (!db->executeCommand(create_init_markers_table)) {
+        std::cerr << "创建初始化标记表失败" << std::endl;
+    } else {
+        std::cout << "初始化标记表已就绪" << std::endl;
+    }
+    
     // 修改MySQL索引创建语法，去掉IF NOT EXISTS
     std::string create_discussions_index = 
         "CREATE INDEX idx_discussions_problem_id ON discussions(problem_id)";
@@ -243,34 +420,87 @@ int main(int argc, char** argv) {
         std::cerr << "创建讨论回复表索引2失败，索引可能已存在" << std::endl;
     }
     
+    // 回复树按讨论ID和父回复ID分层加载，联合索引覆盖过滤和排序
+    std::string create_discussion_replies_index3 = 
+        "CREATE INDEX idx_discussion_replies_thread ON discussion_replies(discussion_id, parent_id, created_at)";
+    if (!db->executeCommand(create_discussion_replies_index3)) {
+        std::cerr << "创建讨论回复表索引3失败，索引可能已存在" << std::endl;
+    }
+    
+    // 评测后按用户重新统计排名数据
+    std::string create_submissions_user_index = 
+        "CREATE INDEX idx_submissions_user_problem ON submissions(user_id, problem_id, result)";
+    if (!db->executeCommand(create_submissions_user_index)) {
+        std::cerr << "创建提交记录表索引失败，索引可能已存在" << std::endl;
+    }
+    
+    // 删除题目时按题目分批取出提交记录、测试用例，按提交删除测试点结果
+    std::string create_submissions_problem_index = 
+        "CREATE INDEX idx_submissions_problem ON submissions(problem_id)";
+    if (!db->executeCommand(create_submissions_problem_index)) {
+        std::cerr << "创建提交记录表题目索引失败，索引可能已存在" << std::endl;
+    }
+    
+    std::string create_testcases_problem_index = 
+        "CREATE INDEX idx_testcases_problem ON testcases(problem_id)";
+    if (!db->executeCommand(create_testcases_problem_index)) {
+        std::cerr << "创建测试用例表索引失败，索引可能已存在" << std::endl;
+    }
+    
+    std::string create_test_point_results_index = 
+        "CREATE INDEX idx_test_point_results_submission ON test_point_results(submission_id)";
+    if (!db->executeCommand(create_test_point_results_index)) {
+        std::cerr << "创建测试点结果表索引失败，索引可能已存在" << std::endl;
+    }
+    
     // 添加示例管理员帐户
     if (!db->executeCommand("INSERT IGNORE INTO `cplus`.`users` (`id`, `username`, `email`, `password_hash`, `salt`, `avatar`, `role`, `status`, `created_at`, `updated_at`, `last_login`, `solved_count`, `submission_count`, `score`, `easy_count`, `medium_count`, `hard_count`) VALUES (2, 'admin', 'admin@c.cc', '75d369ed5cb43aa6cbb62c405dd582a0e8b43aa985c4cbc230515b1247365446', '81a275083037c1df028f804739fb445e', NULL, 2, 0, 1743239731, 1743392154, 1743392154, 0, 0, 0, 0, 0, 0)")) {
         std::cerr << "无法插入示例管理员帐户" << std::endl;
     }
     
+    // 载入总排行榜
+    RankingService::initialize();
+    
+    // 建立题目检索索引
+    ProblemSearchIndex::build();
+    
+    // 载入题目目录，列表页直接从内存读取
+    ProblemCatalog::build();
+    
+    // 载入题目提交统计并启动写回线程（依赖上面创建的统计表）
+    ProblemStats::start();
+    
+    // 启动题目删除线程，继续上次未完成的删除任务
+    ProblemDeletion::start();
+    
+    // 载入热门讨论排行（依赖上面创建的讨论表）
+    HotDiscussions::start();
+    
+    // 最后启动评测线程：重新入队的未完成提交会写入排行、统计等表，
+    // 必须在建表、排行和统计的载入与回填都完成之后才能开始评测
+    SubmissionService::ensureJudgeThreadRunning();
+    std::cout << "评测服务初始化完成" << std::endl;
+    
     std::cout << "系统初始化完成，准备监听端口 " << port << std::endl;
+    std::cout << "按Ctrl+C终止服务器..." << std::endl;
+    
+    // 注册信号处理器，以便正确处理Ctrl+C等信号（初始化期间收到信号时按默认方式终止）
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
     
-    // 启动服务器
-    if (!server->start()) {
+    // 启动服务器，阻塞直到信号处理函数停止监听
+    bool listened = received_signal != 0 || server->start();
+    if (!listened) {
         std::cerr << "HTTP服务器启动失败，端口 " << port << " 可能已被占用" << std::endl;
-        // 停止评测线程
-        SubmissionService::stopJudgeThread();
-        delete server;
-        server = nullptr;
-        // 关闭数据库连接
-        db->close();
-        return 1;
+    } else {
+        if (received_signal != 0) {
+            std::cout << "接收到信号 " << received_signal << "，正在关闭服务器..." << std::endl;
+        }
+        std::cout << "服务器已停止，正在进行清理..." << std::endl;
     }
     
-    std::cout << "HTTP服务器已启动，监听端口: " << port << std::endl;
-    std::cout << "后端服务器正在运行..." << std::endl;
-    std::cout << "按Ctrl+C终止服务器..." << std::endl;
-    
     // 服务器停止后的清理工作
-    std::cout << "服务器已停止，正在进行清理..." << std::endl;
-
-    // 停止评测线程（以防信号处理函数没有被调用）
-    SubmissionService::stopJudgeThread();
+    stopServices();
     
     delete server;
     server = nullptr;
@@ -278,5 +508,5 @@ int main(int argc, char** argv) {
     // 关闭数据库连接
     db->close();
     
-    return 0;
+    return listened ? 0 : 1;
 }
\ No newline at end of file
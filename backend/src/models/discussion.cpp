@@ -1,9 +1,12 @@
 #include "../../include/models/discussion.h"
 #include "../../include/database/database.h"
+#include "../../include/utils/cache_version.h"
 #include <json/json.h>
 #include <iostream>
 #include <vector>
 #include <ctime>
+#include <map>
+#include <algorithm>
 
 // 讨论类的实现
 
@@ -59,8 +62,8 @@ Discussion Discussion::fromJson(const std::string& json_str) {
     return discussion;
 }
 
-// 转换为JSON字符串
-std::string Discussion::toJson() const {
+// 转换为JSON对象
+Json::Value Discussion::toJson() const {
     Json::Value root;
     root["id"] = id;
     root["problem_id"] = problem_id;
@@ -71,9 +74,7 @@ std::string Discussion::toJson() const {
     root["likes"] = likes;
     root["created_at"] = static_cast<Json::Int64>(created_at);
     root["updated_at"] = static_cast<Json::Int64>(updated_at);
-    
-    Json::FastWriter writer;
-    return writer.write(root);
+    return root;
 }
 
 // 讨论回复类的实现
@@ -125,8 +126,8 @@ DiscussionReply DiscussionReply::fromJson(const std::string& json_str) {
     return reply;
 }
 
-// 转换为JSON字符串
-std::string DiscussionReply::toJson() const {
+// 转换为JSON对象
+Json::Value DiscussionReply::toJson() const {
     Json::Value root;
     root["id"] = id;
     root["discussion_id"] = discussion_id;
@@ -136,9 +137,7 @@ std::string DiscussionReply::toJson() const {
     root["likes"] = likes;
     root["created_at"] = static_cast<Json::Int64>(created_at);
     root["updated_at"] = static_cast<Json::Int64>(updated_at);
-    
-    Json::FastWriter writer;
-    return writer.write(root);
+    return root;
 }
 
 // 讨论数据访问对象的实现
@@ -165,6 +164,7 @@ bool DiscussionDAO::createDiscussion(Discussion& discussion) {
         
         // 获取自增ID
         discussion.setId(db->getLastInsertId());
+        CacheVersion::bump(CacheVersion::DISCUSSIONS);
         
         return true;
     } catch (const std::exception& e) {
@@ -214,6 +214,114 @@ Discussion DiscussionDAO::getDiscussionById(int id) {
     return discussion;
 }
 
+bool DiscussionDAO::getDiscussionCounters(int id, int& views, int& likes) {
+    try {
+        Database* db = Database::getInstance();
+        
+        std::string sql = "SELECT views, likes FROM discussions WHERE id = " + std::to_string(id);
+        MYSQL_RES* result = db->executeQuery(sql);
+        if (result == nullptr) {
+            std::cerr << "查询讨论计数失败" << std::endl;
+            return false;
+        }
+        
+        MYSQL_ROW row = mysql_fetch_row(result);
+        bool found = row != nullptr;
+        if (found) {
+            views = row[0] ? std::stoi(row[0]) : 0;
+            likes = row[1] ? std::stoi(row[1]) : 0;
+        }
+        mysql_free_result(result);
+        return found;
+    } catch (const std::exception& e) {
+        std::cerr << "获取讨论计数失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// 按ID批量获取讨论，每批一条 IN 查询
+bool DiscussionDAO::getDiscussionsByIds(const std::vector<int>& ids, std::vector<Discussion>& discussions,
+                                        bool with_content) {
+    const size_t batch_size = 500;
+    
+    try {
+        Database* db = Database::getInstance();
+        
+        for (size_t start = 0; start < ids.size(); start += batch_size) {
+            std::string id_list;
+            for (size_t i = start; i < ids.size() && i < start + batch_size; i++) {
+                if (!id_list.empty()) id_list += ",";
+                id_list += std::to_string(ids[i]);
+            }
+            
+            std::string sql = std::string("SELECT id, problem_id, user_id, title, ") +
+                              (with_content ? "content" : "''") + ", views, likes, created_at, updated_at "
+                              "FROM discussions WHERE id IN (" + id_list + ")";
+            MYSQL_RES* result = db->executeQuery(sql);
+            if (result == nullptr) {
+                std::cerr << "批量查询讨论失败" << std::endl;
+                return false;
+            }
+            
+            MYSQL_ROW row;
+            while ((row = mysql_fetch_row(result))) {
+                Discussion discussion;
+                discussion.setId(std::stoi(row[0]));
+                discussion.setProblemId(row[1] ? std::stoi(row[1]) : 0);
+                discussion.setUserId(std::stoi(row[2]));
+                discussion.setTitle(row[3] ? row[3] : "");
+                discussion.setContent(row[4] ? row[4] : "");
+                discussion.setViews(row[5] ? std::stoi(row[5]) : 0);
+                discussion.setLikes(row[6] ? std::stoi(row[6]) : 0);
+                discussion.setCreatedAt(std::stoll(row[7]));
+                discussion.setUpdatedAt(std::stoll(row[8]));
+                discussions.push_back(discussion);
+            }
+            mysql_free_result(result);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "批量获取讨论失败: " << e.what() << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+// 获取最近创建的讨论的互动数据
+std::vector<DiscussionActivity> DiscussionDAO::getRecentDiscussionActivity(int limit) {
+    std::vector<DiscussionActivity> activities;
+    
+    try {
+        Database* db = Database::getInstance();
+        
+        std::string sql = "SELECT d.id, d.problem_id, d.views, d.likes, COUNT(r.id), d.created_at "
+                        "FROM discussions d LEFT JOIN discussion_replies r ON r.discussion_id = d.id "
+                        "GROUP BY d.id ORDER BY d.created_at DESC LIMIT " + std::to_string(limit);
+        MYSQL_RES* result = db->executeQuery(sql);
+        if (result == nullptr) {
+            std::cerr << "查询讨论互动数据失败" << std::endl;
+            return activities;
+        }
+        
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(result))) {
+            DiscussionActivity activity;
+            activity.id = std::stoi(row[0]);
+            activity.problem_id = row[1] ? std::stoi(row[1]) : 0;
+            activity.views = row[2] ? std::stoi(row[2]) : 0;
+            activity.likes = row[3] ? std::stoi(row[3]) : 0;
+            activity.replies = row[4] ? std::stoi(row[4]) : 0;
+            activity.created_at = std::stoll(row[5]);
+            activities.push_back(activity);
+        }
+        mysql_free_result(result);
+    } catch (const std::exception& e) {
+        std::cerr << "获取讨论互动数据失败: " << e.what() << std::endl;
+    }
+    
+    return activities;
+}
+
 bool DiscussionDAO::updateDiscussion(const Discussion& discussion) {
     try {
         // 使用数据库实例直接执行命令
@@ -234,6 +342,7 @@ bool DiscussionDAO::updateDiscussion(const Discussion& discussion) {
             std::cerr << "更新讨论失败" << std::endl;
             return false;
         }
+        CacheVersion::bump(CacheVersion::DISCUSSIONS);
         
         // 检查影响的行数
         return db->getAffectedRows() > 0;
@@ -243,22 +352,65 @@ bool DiscussionDAO::updateDiscussion(const Discussion& discussion) {
     }
 }
 
+bool DiscussionDAO::incrementDiscussionViews(const std::map<int, int>& increments) {
+    if (increments.empty()) {
+        return true;
+    }
+    
+    try {
+        Database* db = Database::getInstance();
+        
+        // 原子累加浏览量，不修改updated_at，也不影响讨论的缓存版本
+        std::string cases;
+        std::string ids;
+        for (const auto& item : increments) {
+            cases += " WHEN " + std::to_string(item.first) + " THEN " + std::to_string(item.second);
+            if (!ids.empty()) ids += ",";
+            ids += std::to_string(item.first);
+        }
+        std::string sql = "UPDATE discussions SET views = views + CASE id" + cases + " ELSE 0 END WHERE id IN (" + ids + ")";
+        
+        if (!db->executeCommand(sql)) {
+            std::cerr << "更新浏览量失败" << std::endl;
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "更新浏览量失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool DiscussionDAO::deleteDiscussion(int id) {
     try {
         // 使用数据库实例直接执行命令
         Database* db = Database::getInstance();
         
+        // 删除讨论前先通过回复表清理该讨论下回复的点赞记录
+        std::string reply_likes_sql = "DELETE dl FROM discussion_likes dl "
+                                      "JOIN discussion_replies r ON dl.target_type = 1 AND dl.target_id = r.id "
+                                      "WHERE r.discussion_id = " + std::to_string(id);
+        if (!db->executeCommand(reply_likes_sql)) {
+            std::cerr << "清理回复点赞记录失败" << std::endl;
+            return false;
+        }
+        
         // 构建SQL语句
         std::string sql = "DELETE FROM discussions WHERE id = " + std::to_string(id);
         
         // 执行删除
-        if (!db->executeCommand(sql)) {
+        unsigned long long affected_rows = 0;
+        if (!db->executeCommand(sql, affected_rows)) {
             std::cerr << "删除讨论失败" << std::endl;
             return false;
         }
+        CacheVersion::bump(CacheVersion::DISCUSSIONS);
+        
+        // 清理讨论本身的点赞记录
+        db->executeCommand("DELETE FROM discussion_likes WHERE target_type = 0 AND target_id = " + std::to_string(id));
         
         // 检查影响的行数
-        return db->getAffectedRows() > 0;
+        return affected_rows > 0;
     } catch (const std::exception& e) {
         std::cerr << "删除讨论失败: " << e.what() << std::endl;
         return false;
@@ -380,6 +532,7 @@ bool DiscussionDAO::createDiscussionReply(DiscussionReply& reply) {
         
         // 获取自增ID
         reply.setId(db->getLastInsertId());
+        CacheVersion::bump(CacheVersion::DISCUSSIONS);
         
         return true;
     } catch (const std::exception& e) {
@@ -477,6 +630,137 @@ std::vector<DiscussionReply> DiscussionDAO::getChildReplies(int parent_id, int o
     return replies;
 }
 
+// 从查询结果行构造回复（列顺序：id, discussion_id, user_id, parent_id, content, likes, created_at, updated_at）
+static DiscussionReply replyFromRow(MYSQL_ROW row) {
+    DiscussionReply reply;
+    reply.setId(std::stoi(row[0]));
+    reply.setDiscussionId(std::stoi(row[1]));
+    reply.setUserId(std::stoi(row[2]));
+    reply.setParentId(std::stoi(row[3]));
+    reply.setContent(row[4] ? row[4] : "");
+    reply.setLikes(row[5] ? std::stoi(row[5]) : 0);
+    reply.setCreatedAt(std::stoll(row[6]));
+    reply.setUpdatedAt(std::stoll(row[7]));
+    return reply;
+}
+
+// 加载回复树
+std::vector<DiscussionReplyNode> DiscussionDAO::getReplyTree(int discussion_id, int offset, int limit,
+                                                             int max_depth, int max_children) {
+    std::vector<DiscussionReplyNode> roots;
+    
+    try {
+        Database* db = Database::getInstance();
+        
+        // 顶层回复
+        std::string sql = "SELECT id, discussion_id, user_id, parent_id, content, likes, created_at, updated_at "
+                        "FROM discussion_replies WHERE discussion_id = " + std::to_string(discussion_id) + 
+                        " AND parent_id = 0 ORDER BY created_at ASC, id ASC LIMIT " +
+                        std::to_string(std::min(limit, REPLY_TREE_MAX_NODES)) + 
+                        " OFFSET " + std::to_string(offset);
+        MYSQL_RES* result = db->executeQuery(sql);
+        if (result == nullptr) {
+            std::cerr << "查询讨论回复失败" << std::endl;
+            return roots;
+        }
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(result))) {
+            DiscussionReplyNode node;
+            node.reply = replyFromRow(row);
+            roots.push_back(node);
+        }
+        mysql_free_result(result);
+        
+        // 逐层加载子回复，level 中保存当前层节点的指针
+        // 子节点在本层处理完之前不会再追加，指针保持有效
+        std::vector<DiscussionReplyNode*> level;
+        for (auto& node : roots) {
+            level.push_back(&node);
+        }
+        
+        // 剩余可加载的回复数，用完后停止展开
+        int budget = REPLY_TREE_MAX_NODES - static_cast<int>(roots.size());
+        
+        for (int depth = 0; depth < max_depth && !level.empty(); depth++) {
+            std::map<int, DiscussionReplyNode*> parents;
+            std::string ids;
+            std::string per_parent;
+            int expanded = 0;
+            for (DiscussionReplyNode* node : level) {
+                parents[node->reply.getId()] = node;
+                if (!ids.empty()) ids += ",";
+                ids += std::to_string(node->reply.getId());
+                
+                // 每条子回复至少占用一个名额，只展开前 budget 条回复
+                if (expanded >= budget) {
+                    continue;
+                }
+                expanded++;
+                
+                // 每条回复只取前 max_children 条子回复，各自带 LIMIT，合并为一条语句
+                if (!per_parent.empty()) per_parent += " UNION ALL ";
+                per_parent += "(SELECT id, discussion_id, user_id, parent_id, content, likes, created_at, updated_at "
+                              "FROM discussion_replies WHERE discussion_id = " + std::to_string(discussion_id) +
+                              " AND parent_id = " + std::to_string(node->reply.getId()) +
+                              " ORDER BY created_at ASC, id ASC LIMIT " + std::to_string(max_children) + ")";
+            }
+            
+            // 子回复总数单独统计（带上 discussion_id 条件以便使用讨论ID索引）
+            sql = "SELECT parent_id, COUNT(*) FROM discussion_replies WHERE discussion_id = " +
+                  std::to_string(discussion_id) + " AND parent_id IN (" + ids + ") GROUP BY parent_id";
+            result = db->executeQuery(sql);
+            if (result == nullptr) {
+                std::cerr << "统计子回复失败" << std::endl;
+                break;
+            }
+            while ((row = mysql_fetch_row(result))) {
+                auto it = parents.find(std::stoi(row[0]));
+                if (it != parents.end()) {
+                    it->second->child_count = std::stoi(row[1]);
+                }
+            }
+            mysql_free_result(result);
+            
+            if (max_children <= 0 || budget <= 0) {
+                break;
+            }
+            // 按本层回复的顺序取前 budget 条，名额不足时排在后面的回复不再返回子回复
+            result = db->executeQuery(per_parent + " ORDER BY FIELD(parent_id, " + ids + "), created_at ASC, id ASC "
+                                      "LIMIT " + std::to_string(budget));
+            if (result == nullptr) {
+                std::cerr << "查询子回复失败" << std::endl;
+                break;
+            }
+            
+            // 结果按父回复分组，组内按创建时间排序
+            while ((row = mysql_fetch_row(result))) {
+                budget--;
+                DiscussionReply reply = replyFromRow(row);
+                auto it = parents.find(reply.getParentId());
+                if (it == parents.end()) {
+                    continue;
+                }
+                DiscussionReplyNode child;
+                child.reply = reply;
+                it->second->children.push_back(child);
+            }
+            mysql_free_result(result);
+            
+            std::vector<DiscussionReplyNode*> next_level;
+            for (DiscussionReplyNode* node : level) {
+                for (auto& child : node->children) {
+                    next_level.push_back(&child);
+                }
+            }
+            level.swap(next_level);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "获取回复树失败: " << e.what() << std::endl;
+    }
+    
+    return roots;
+}
+
 // 获取回复详情
 DiscussionReply DiscussionDAO::getDiscussionReplyById(int id) {
     DiscussionReply reply;
@@ -528,15 +812,102 @@ bool DiscussionDAO::deleteDiscussionReply(int id) {
         std::string sql = "DELETE FROM discussion_replies WHERE id = " + std::to_string(id);
         
         // 执行删除
-        if (!db->executeCommand(sql)) {
+        unsigned long long affected_rows = 0;
+        if (!db->executeCommand(sql, affected_rows)) {
             std::cerr << "删除回复失败" << std::endl;
             return false;
         }
+        CacheVersion::bump(CacheVersion::DISCUSSIONS);
+        
+        // 清理点赞记录
+        db->executeCommand("DELETE FROM discussion_likes WHERE target_type = 1 AND target_id = " + std::to_string(id));
         
         // 检查影响的行数
-        return db->getAffectedRows() > 0;
+        return affected_rows > 0;
     } catch (const std::exception& e) {
         std::cerr << "删除回复失败: " << e.what() << std::endl;
         return false;
     }
+}
+
+// 点赞目标对应的表
+static const char* likeTargetTable(int target_type) {
+    return target_type == 0 ? "discussions" : "discussion_replies";
+}
+
+bool DiscussionDAO::addLike(int user_id, int target_type, int target_id, bool& inserted) {
+    inserted = false;
+    try {
+        Database* db = Database::getInstance();
+        
+        // 通过 SELECT 确保目标存在，主键冲突（已点赞）时忽略
+        std::string sql = "INSERT IGNORE INTO discussion_likes (user_id, target_type, target_id, created_at) "
+                          "SELECT " + std::to_string(user_id) + ", " + std::to_string(target_type) + ", id, " +
+                          std::to_string(std::time(nullptr)) + " FROM " + likeTargetTable(target_type) +
+                          " WHERE id = " + std::to_string(target_id);
+        unsigned long long affected_rows = 0;
+        if (!db->executeCommand(sql, affected_rows)) {
+            std::cerr << "写入点赞记录失败" << std::endl;
+            return false;
+        }
+        inserted = affected_rows > 0;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "写入点赞记录失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool DiscussionDAO::removeLike(int user_id, int target_type, int target_id, bool& deleted) {
+    deleted = false;
+    try {
+        Database* db = Database::getInstance();
+        
+        std::string sql = "DELETE FROM discussion_likes WHERE user_id = " + std::to_string(user_id) +
+                          " AND target_type = " + std::to_string(target_type) +
+                          " AND target_id = " + std::to_string(target_id);
+        unsigned long long affected_rows = 0;
+        if (!db->executeCommand(sql, affected_rows)) {
+            std::cerr << "删除点赞记录失败" << std::endl;
+            return false;
+        }
+        deleted = affected_rows > 0;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "删除点赞记录失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool DiscussionDAO::incrementLikes(int target_type, const std::map<int, int>& deltas) {
+    std::string cases;
+    std::string ids;
+    for (const auto& item : deltas) {
+        if (item.second == 0) {
+            continue;
+        }
+        cases += " WHEN " + std::to_string(item.first) + " THEN " + std::to_string(item.second);
+        if (!ids.empty()) ids += ",";
+        ids += std::to_string(item.first);
+    }
+    if (ids.empty()) {
+        return true;
+    }
+    
+    try {
+        Database* db = Database::getInstance();
+        
+        // 点赞数不计入讨论的缓存版本；likes 可能是无符号列，先转为有符号再相加，避免减到负数时报错
+        std::string sql = std::string("UPDATE ") + likeTargetTable(target_type) +
+                          " SET likes = GREATEST(CAST(likes AS SIGNED) + CASE id" + cases + " ELSE 0 END, 0)"
+                          " WHERE id IN (" + ids + ")";
+        if (!db->executeCommand(sql)) {
+            std::cerr << "更新点赞数失败" << std::endl;
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "更新点赞数失败: " << e.what() << std::endl;
+        return false;
+    }
 } 
\ No newline at end of file
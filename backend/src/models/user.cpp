@@ -1,13 +1,10 @@
 #include "../../include/models/user.h"
-#include <openssl/sha.h>
-#include <openssl/rand.h>
-#include <sstream>
-#include <iomanip>
+#include "../../include/utils/password_hasher.h"
 #include <mysql/mysql.h>
 #include <json/json.h>
 
-// 转换为JSON字符串（不包括敏感信息）
-std::string User::toJson() const {
+// 转换为JSON对象（不包括敏感信息）
+Json::Value User::toJson() const {
     Json::Value root;
     root["id"] = id_;
     root["username"] = username_;
@@ -20,9 +17,7 @@ std::string User::toJson() const {
     root["last_login"] = static_cast<Json::Int64>(last_login_);
     
     // 不包含敏感信息如密码哈希和盐
-    
-    Json::StreamWriterBuilder writer;
-    return Json::writeString(writer, root);
+    return root;
 }
 
 // 从数据库结果集创建用户对象
@@ -59,56 +54,14 @@ User User::fromDatabaseResult(void* result, int row) {
     return user;
 }
 
-// 生成随机盐
-static std::string generateSalt(size_t length = 16) {
-    std::vector<unsigned char> salt(length);
-    RAND_bytes(salt.data(), length);
-    
-    std::stringstream ss;
-    for (auto byte : salt) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
-    }
-    
-    return ss.str();
-}
-
 // 生成密码哈希
 std::pair<std::string, std::string> User::generatePasswordHash(const std::string& password) {
-    std::string salt = generateSalt();
-    
-    // 将密码和盐组合
-    std::string salted_password = password + salt;
-    
-    // 计算SHA-256哈希
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256(reinterpret_cast<const unsigned char*>(salted_password.c_str()), 
-           salted_password.length(), hash);
-    
-    // 转换为十六进制字符串
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
-    }
-    
-    return {ss.str(), salt};
+    std::string salt = PasswordHasher::generateSalt();
+    return {PasswordHasher::computeHash(password, salt), salt};
 }
 
 // 检查密码是否匹配
 bool User::checkPassword(const std::string& password) const {
-    // 将输入的密码和存储的盐组合
-    std::string salted_password = password + salt_;
-    
-    // 计算SHA-256哈希
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256(reinterpret_cast<const unsigned char*>(salted_password.c_str()), 
-           salted_password.length(), hash);
-    
-    // 转换为十六进制字符串
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
-    }
-    
-    // 比较哈希值
-    return ss.str() == password_hash_;
+    bool needs_rehash = false;
+    return PasswordHasher::checkHash(password, salt_, password_hash_, needs_rehash);
 } 
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "../../include/services/discussion_likes.h"
+#include "../../include/services/hot_discussions.h"
+#include "../../include/models/discussion.h"
+#include "../../include/utils/periodic_flusher.h"
+#include <map>
+#include <mutex>
+#include <iostream>
+
+namespace {
+    const int TARGET_TYPES = 2;
+
+    // 等待写回的点赞数增量，按目标类型分开
+    std::mutex delta_mutex;
+    std::map<int, int> pending_deltas[TARGET_TYPES];
+
+    PeriodicFlusher flusher(LIKE_FLUSH_INTERVAL_MS, &DiscussionLikes::flush);
+
+    // 同一时间只允许一次写回
+    std::mutex flush_mutex;
+
+    bool targetExists(LikeTarget target, int target_id) {
+        if (target == LikeTarget::DISCUSSION) {
+            return DiscussionDAO::getDiscussionById(target_id).getId() != 0;
+        }
+        return DiscussionDAO::getDiscussionReplyById(target_id).getId() != 0;
+    }
+}
+
+void DiscussionLikes::start() {
+    if (!flusher.start()) {
+        return;
+    }
+    std::cout << "点赞计数写回线程已启动，间隔: " << LIKE_FLUSH_INTERVAL_MS << "ms" << std::endl;
+}
+
+void DiscussionLikes::stop() {
+    if (!flusher.stop()) {
+        return;
+    }
+    std::cout << "点赞计数写回线程已停止" << std::endl;
+}
+
+LikeStatus DiscussionLikes::setLiked(int user_id, LikeTarget target, int target_id, bool liked, bool& changed,
+                                     std::string& error_message) {
+    changed = false;
+    int target_type = static_cast<int>(target);
+    bool ok = liked ? DiscussionDAO::addLike(user_id, target_type, target_id, changed)
+                    : DiscussionDAO::removeLike(user_id, target_type, target_id, changed);
+    if (!ok) {
+        error_message = "点赞操作失败，数据库错误";
+        return LikeStatus::DB_ERROR;
+    }
+
+    // 状态未变化时区分重复请求和目标不存在（删除目标时点赞记录一并删除）
+    if (!changed && !targetExists(target, target_id)) {
+        error_message = target == LikeTarget::DISCUSSION ? "讨论不存在" : "回复不存在";
+        return LikeStatus::NOT_FOUND;
+    }
+
+    if (changed) {
+        int delta = liked ? 1 : -1;
+        {
+            std::lock_guard<std::mutex> delta_lock(delta_mutex);
+            pending_deltas[target_type][target_id] += delta;
+        }
+        if (target == LikeTarget::DISCUSSION) {
+            HotDiscussions::recordLike(target_id, delta);
+        }
+    }
+    return LikeStatus::OK;
+}
+
+int DiscussionLikes::pendingDelta(LikeTarget target, int target_id) {
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    const std::map<int, int>& deltas = pending_deltas[static_cast<int>(target)];
+    auto it = deltas.find(target_id);
+    return it != deltas.end() ? it->second : 0;
+}
+
+void DiscussionLikes::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+
+    for (int target_type = 0; target_type < TARGET_TYPES; target_type++) {
+        std::map<int, int> deltas;
+        {
+            std::lock_guard<std::mutex> lock(delta_mutex);
+            deltas.swap(pending_deltas[target_type]);
+        }
+
+        flushInBatches<std::map<int, int>>(deltas, LIKE_FLUSH_BATCH,
+            [target_type](const std::map<int, int>& batch) {
+                return DiscussionDAO::incrementLikes(target_type, batch);
+            },
+            [target_type](const std::map<int, int>& batch) {
+                std::lock_guard<std::mutex> lock(delta_mutex);
+                for (const auto& item : batch) {
+                    pending_deltas[target_type][item.first] += item.second;
+                }
+            });
+    }
+}
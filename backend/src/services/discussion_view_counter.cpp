@@ -0,0 +1,94 @@
+#include "../../include/services/discussion_view_counter.h"
+#include "../../include/models/discussion.h"
+#include "../../include/services/hot_discussions.h"
+#include "../../include/utils/periodic_flusher.h"
+#include <mutex>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<int, int> counts;
+    };
+
+    Shard shards[VIEW_COUNTER_SHARDS];
+
+    Shard& shardFor(int discussion_id) {
+        return shards[static_cast<unsigned>(discussion_id) % VIEW_COUNTER_SHARDS];
+    }
+
+    PeriodicFlusher flusher(VIEW_COUNTER_FLUSH_INTERVAL_MS, &DiscussionViewCounter::flush);
+
+    // 同一时间只允许一次写回，避免后台线程和stop()同时写回
+    std::mutex flush_mutex;
+
+    // 写回失败、等待下次重试的计数（受 flush_mutex 保护）
+    std::map<int, int> retry_counts;
+}
+
+void DiscussionViewCounter::start() {
+    if (!flusher.start()) {
+        return;
+    }
+    std::cout << "浏览量写回线程已启动，间隔: " << VIEW_COUNTER_FLUSH_INTERVAL_MS << "ms" << std::endl;
+}
+
+void DiscussionViewCounter::stop() {
+    if (!flusher.stop()) {
+        return;
+    }
+    std::cout << "浏览量写回线程已停止" << std::endl;
+}
+
+void DiscussionViewCounter::record(int discussion_id) {
+    Shard& shard = shardFor(discussion_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.counts[discussion_id]++;
+}
+
+int DiscussionViewCounter::pending(int discussion_id) {
+    Shard& shard = shardFor(discussion_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.counts.find(discussion_id);
+    return it != shard.counts.end() ? it->second : 0;
+}
+
+std::map<int, int> DiscussionViewCounter::drain() {
+    std::map<int, int> increments;
+    for (auto& shard : shards) {
+        std::unordered_map<int, int> counts;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            counts.swap(shard.counts);
+        }
+        increments.insert(counts.begin(), counts.end());
+    }
+    return increments;
+}
+
+void DiscussionViewCounter::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+
+    std::map<int, int> increments = drain();
+
+    // 新的浏览计入热度排行，重试的计数已计入过，不再重复
+    if (!increments.empty()) {
+        HotDiscussions::addViews(increments);
+    }
+    for (const auto& item : retry_counts) {
+        increments[item.first] += item.second;
+    }
+    retry_counts.clear();
+    if (increments.empty()) {
+        return;
+    }
+
+    // 分批写回，每批一条UPDATE，失败的计数保留到下次写回时重试
+    flushInBatches<std::map<int, int>>(increments, VIEW_COUNTER_FLUSH_BATCH, &DiscussionDAO::incrementDiscussionViews,
+        [](const std::map<int, int>& batch) {
+            for (const auto& item : batch) {
+                retry_counts[item.first] += item.second;
+            }
+        });
+}
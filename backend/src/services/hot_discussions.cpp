@@ -0,0 +1,371 @@
+#include "../../include/services/hot_discussions.h"
+#include "../../include/utils/periodic_flusher.h"
+#include <set>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+    // 衰减时间常数（秒），半衰期 = tau * ln2
+    const double DECAY_TAU = HOT_DISCUSSIONS_HALF_LIFE_HOURS * 3600.0 / std::log(2.0);
+
+    // base 距今超过该倍数的 tau 时统一缩放，避免指数过大损失精度
+    const double REBASE_THRESHOLD = 20.0;
+
+    // 未知题目ID（由浏览等事件首次加入，等待刷新时从数据库补全）
+    const int UNKNOWN_PROBLEM = -1;
+
+    typedef std::set<std::pair<double, int>> Ranking;
+
+    struct Entry {
+        int problem_id = UNKNOWN_PROBLEM;
+        double score = 0;
+    };
+
+    // 可变的排行状态
+    std::mutex state_mutex;
+    std::unordered_map<int, Entry> entries;
+    Ranking global_ranking;
+    std::unordered_map<int, Ranking> problem_rankings;
+    double base_time = static_cast<double>(std::time(nullptr));
+
+    // 只读快照
+    struct Snapshot {
+        std::vector<Discussion> global;
+        std::unordered_map<int, std::vector<Discussion>> by_problem;
+    };
+
+    std::mutex snapshot_mutex;
+    std::shared_ptr<const Snapshot> current_snapshot;
+
+    // 定期刷新快照，停止时不需要再刷新
+    std::atomic<bool> started(false);
+    PeriodicFlusher refresher(HOT_DISCUSSIONS_REFRESH_MS, &HotDiscussions::refresh, false);
+
+    // 同一时间只允许一次刷新
+    std::mutex refresh_mutex;
+
+    double decayFactor(double at) {
+        return std::exp((at - base_time) / DECAY_TAU);
+    }
+
+    // 以下函数调用方持有 state_mutex
+    void unlinkEntry(int discussion_id, const Entry& entry) {
+        global_ranking.erase(std::make_pair(entry.score, discussion_id));
+        if (entry.problem_id > 0) {
+            auto it = problem_rankings.find(entry.problem_id);
+            if (it != problem_rankings.end()) {
+                it->second.erase(std::make_pair(entry.score, discussion_id));
+                if (it->second.empty()) {
+                    problem_rankings.erase(it);
+                }
+            }
+        }
+    }
+
+    void linkEntry(int discussion_id, const Entry& entry) {
+        global_ranking.insert(std::make_pair(entry.score, discussion_id));
+        if (entry.problem_id > 0) {
+            problem_rankings[entry.problem_id].insert(std::make_pair(entry.score, discussion_id));
+        }
+    }
+
+    void adjustScore(int discussion_id, int problem_id, double weight, double at) {
+        auto it = entries.find(discussion_id);
+        if (it == entries.end()) {
+            it = entries.insert(std::make_pair(discussion_id, Entry())).first;
+        } else {
+            unlinkEntry(discussion_id, it->second);
+        }
+
+        Entry& entry = it->second;
+        if (problem_id != UNKNOWN_PROBLEM) {
+            entry.problem_id = problem_id;
+        }
+        entry.score = std::max(0.0, entry.score + weight * decayFactor(at));
+        linkEntry(discussion_id, entry);
+    }
+
+    // 把所有分数换算到新的 base，排序不变
+    void rebase(double now) {
+        double factor = std::exp((base_time - now) / DECAY_TAU);
+        base_time = now;
+
+        global_ranking.clear();
+        problem_rankings.clear();
+        for (auto it = entries.begin(); it != entries.end();) {
+            it->second.score *= factor;
+            // 长期没有互动的讨论热度已接近0，直接丢弃
+            if (it->second.score < 1e-6) {
+                it = entries.erase(it);
+                continue;
+            }
+            linkEntry(it->first, it->second);
+            ++it;
+        }
+    }
+
+    void appendTop(const Ranking& ranking, std::vector<int>& ids) {
+        int count = 0;
+        for (auto it = ranking.rbegin(); it != ranking.rend() && count < HOT_DISCUSSIONS_TOP_K; ++it, ++count) {
+            ids.push_back(it->second);
+        }
+    }
+
+    // 快照中的排行与当前前K名的成员和顺序是否一致
+    bool sameMembers(const std::vector<Discussion>* ranking, const std::vector<int>& ids) {
+        if (ranking == nullptr || ranking->size() != ids.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < ids.size(); i++) {
+            if ((*ranking)[i].getId() != ids[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 把快照中没有的讨论加入待加载列表
+    void appendUnknown(const std::vector<int>& ids, const std::unordered_map<int, const Discussion*>& known,
+                       std::vector<int>& load_ids) {
+        for (int id : ids) {
+            if (known.find(id) == known.end()) {
+                load_ids.push_back(id);
+            }
+        }
+    }
+
+    // 按排行顺序组装快照，优先使用本次加载的数据，其余复用上一份快照；本次加载时已不存在的讨论被跳过
+    void buildRanking(const std::vector<int>& ids, const std::unordered_map<int, Discussion>& loaded,
+                      const std::unordered_map<int, const Discussion*>& known, std::vector<Discussion>& ranking) {
+        for (int id : ids) {
+            auto loaded_it = loaded.find(id);
+            if (loaded_it != loaded.end()) {
+                ranking.push_back(loaded_it->second);
+                continue;
+            }
+            auto known_it = known.find(id);
+            if (known_it != known.end()) {
+                ranking.push_back(*known_it->second);
+            }
+        }
+    }
+
+    void seed() {
+        std::vector<DiscussionActivity> activities = DiscussionDAO::getRecentDiscussionActivity(HOT_DISCUSSIONS_SEED_LIMIT);
+
+        std::lock_guard<std::mutex> lock(state_mutex);
+        for (const auto& activity : activities) {
+            // 历史互动的发生时间未知，统一按讨论创建时间计入
+            double weight = activity.views * HOT_WEIGHT_VIEW + activity.likes * HOT_WEIGHT_LIKE +
+                            activity.replies * HOT_WEIGHT_REPLY + HOT_WEIGHT_CREATE;
+            adjustScore(activity.id, activity.problem_id, weight, static_cast<double>(activity.created_at));
+        }
+        std::cout << "热门讨论排行已载入，讨论数: " << activities.size() << std::endl;
+    }
+}
+
+void HotDiscussions::start() {
+    if (started.exchange(true)) {
+        return;
+    }
+
+    seed();
+    refresh();
+    refresher.start();
+}
+
+void HotDiscussions::stop() {
+    if (started.exchange(false)) {
+        refresher.stop();
+    }
+}
+
+void HotDiscussions::addViews(const std::map<int, int>& views) {
+    double now = static_cast<double>(std::time(nullptr));
+    std::lock_guard<std::mutex> lock(state_mutex);
+    for (const auto& item : views) {
+        adjustScore(item.first, UNKNOWN_PROBLEM, item.second * HOT_WEIGHT_VIEW, now);
+    }
+}
+
+void HotDiscussions::recordLike(int discussion_id, int delta) {
+    double now = static_cast<double>(std::time(nullptr));
+    std::lock_guard<std::mutex> lock(state_mutex);
+    adjustScore(discussion_id, UNKNOWN_PROBLEM, delta * HOT_WEIGHT_LIKE, now);
+}
+
+void HotDiscussions::recordReply(int discussion_id) {
+    double now = static_cast<double>(std::time(nullptr));
+    std::lock_guard<std::mutex> lock(state_mutex);
+    adjustScore(discussion_id, UNKNOWN_PROBLEM, HOT_WEIGHT_REPLY, now);
+}
+
+void HotDiscussions::recordCreated(int discussion_id, int problem_id) {
+    double now = static_cast<double>(std::time(nullptr));
+    std::lock_guard<std::mutex> lock(state_mutex);
+    adjustScore(discussion_id, problem_id, HOT_WEIGHT_CREATE, now);
+}
+
+void HotDiscussions::remove(int discussion_id) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    auto it = entries.find(discussion_id);
+    if (it != entries.end()) {
+        unlinkEntry(discussion_id, it->second);
+        entries.erase(it);
+    }
+}
+
+std::vector<Discussion> HotDiscussions::get(int problem_id, int limit) {
+    std::shared_ptr<const Snapshot> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        snapshot = current_snapshot;
+    }
+
+    std::vector<Discussion> result;
+    if (!snapshot) {
+        return result;
+    }
+
+    const std::vector<Discussion>* ranking = &snapshot->global;
+    if (problem_id > 0) {
+        auto it = snapshot->by_problem.find(problem_id);
+        if (it == snapshot->by_problem.end()) {
+            return result;
+        }
+        ranking = &it->second;
+    }
+
+    size_t count = std::min(ranking->size(), static_cast<size_t>(std::max(limit, 0)));
+    result.assign(ranking->begin(), ranking->begin() + count);
+    return result;
+}
+
+void HotDiscussions::refresh() {
+    std::lock_guard<std::mutex> refresh_lock(refresh_mutex);
+
+    // 取出各排行的前K名和尚未确定题目的讨论
+    std::vector<int> global_ids;
+    std::vector<std::pair<int, std::vector<int>>> problem_ids;
+    std::vector<int> load_ids;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        double now = static_cast<double>(std::time(nullptr));
+        if (now - base_time > REBASE_THRESHOLD * DECAY_TAU) {
+            rebase(now);
+        }
+
+        appendTop(global_ranking, global_ids);
+        for (const auto& item : problem_rankings) {
+            std::vector<int> ids;
+            appendTop(item.second, ids);
+            problem_ids.push_back(std::make_pair(item.first, ids));
+        }
+        for (const auto& item : entries) {
+            if (item.second.problem_id == UNKNOWN_PROBLEM) {
+                load_ids.push_back(item.first);
+            }
+        }
+    }
+
+    std::shared_ptr<const Snapshot> previous;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        previous = current_snapshot;
+    }
+
+    // 成员和顺序都未变化的排行沿用上一份快照；变化的排行中已在快照里的讨论直接复用，只加载新进入排行的讨论
+    std::unordered_map<int, const Discussion*> known;
+    if (previous) {
+        for (const auto& discussion : previous->global) {
+            known[discussion.getId()] = &discussion;
+        }
+        for (const auto& item : previous->by_problem) {
+            for (const auto& discussion : item.second) {
+                known[discussion.getId()] = &discussion;
+            }
+        }
+    }
+
+    const std::vector<Discussion>* previous_global = previous ? &previous->global : nullptr;
+    bool global_changed = !sameMembers(previous_global, global_ids);
+    if (global_changed) {
+        appendUnknown(global_ids, known, load_ids);
+    }
+    std::vector<bool> problem_changed;
+    for (const auto& item : problem_ids) {
+        const std::vector<Discussion>* previous_ranking = nullptr;
+        if (previous) {
+            auto it = previous->by_problem.find(item.first);
+            if (it != previous->by_problem.end()) {
+                previous_ranking = &it->second;
+            }
+        }
+        problem_changed.push_back(!sameMembers(previous_ranking, item.second));
+        if (problem_changed.back()) {
+            appendUnknown(item.second, known, load_ids);
+        }
+    }
+    std::sort(load_ids.begin(), load_ids.end());
+    load_ids.erase(std::unique(load_ids.begin(), load_ids.end()), load_ids.end());
+
+    // 快照只用于列表，不读取讨论正文
+    std::vector<Discussion> discussions;
+    if (!DiscussionDAO::getDiscussionsByIds(load_ids, discussions, false)) {
+        // 结果不完整时无法区分讨论是否已删除，保留上一份快照，下次刷新重试
+        std::cerr << "刷新热门讨论失败，沿用上一份快照" << std::endl;
+        return;
+    }
+    std::unordered_map<int, Discussion> loaded;
+    for (const auto& discussion : discussions) {
+        loaded[discussion.getId()] = discussion;
+    }
+    for (int id : load_ids) {
+        if (loaded.find(id) == loaded.end()) {
+            known.erase(id);
+        }
+    }
+
+    // 补全题目ID，移除数据库中已不存在的讨论（如随题目一起删除的讨论）
+    if (!load_ids.empty()) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        for (int id : load_ids) {
+            auto entry_it = entries.find(id);
+            if (entry_it == entries.end()) {
+                continue;
+            }
+            auto loaded_it = loaded.find(id);
+            unlinkEntry(id, entry_it->second);
+            if (loaded_it == loaded.end()) {
+                entries.erase(entry_it);
+                continue;
+            }
+            entry_it->second.problem_id = loaded_it->second.getProblemId();
+            linkEntry(id, entry_it->second);
+        }
+    }
+
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+    if (global_changed) {
+        buildRanking(global_ids, loaded, known, snapshot->global);
+    } else {
+        snapshot->global = previous->global;
+    }
+    for (size_t i = 0; i < problem_ids.size(); i++) {
+        std::vector<Discussion>& ranking = snapshot->by_problem[problem_ids[i].first];
+        if (problem_changed[i]) {
+            buildRanking(problem_ids[i].second, loaded, known, ranking);
+        } else {
+            ranking = previous->by_problem.find(problem_ids[i].first)->second;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    current_snapshot = snapshot;
+}
\ No newline at end of file
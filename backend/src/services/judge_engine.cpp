@@ -2,6 +2,8 @@
 #include "../../include/services/submission_service.h"
 #include "../../include/models/submission_repository.h"
 #include "../../include/models/problem_repository.h"
+#include "../../include/services/submission_events.h"
+#include "../../include/services/warm_runner.h"
 #include <cstdlib>
 #include <cstdio>
 #include <iostream>
@@ -56,6 +58,58 @@ bool isDirectoryWritable(const std::string& dir) {
     return false;
 }
 
+// 读取文件的全部内容
+static std::string readWholeFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+// 根据程序的结束方式（正常退出或被信号终止）判定运行结果，time_used_ms 和 memory_used_kb 需已填好
+static void classifyTermination(bool exited, int code, int time_limit_ms, int memory_limit_kb, ExecutionResult& result) {
+    if (exited) {
+        result.exit_code = code;
+        
+        if (result.memory_used_kb > memory_limit_kb) {
+            // 未限制地址空间时按实际占用判定；运行时碰到 RLIMIT_DATA 后以非零状态退出，同样算内存超限
+            result.success = false;
+            result.result = JudgeResult::MEMORY_LIMIT_EXCEEDED;
+            result.error_message = "程序超出内存限制";
+        } else if (result.exit_code == 0) {
+            result.success = true;
+            result.result = JudgeResult::ACCEPTED;
+        } else {
+            result.success = false;
+            result.result = JudgeResult::RUNTIME_ERROR;
+            result.error_message = "程序以非零状态码退出: " + std::to_string(result.exit_code);
+        }
+    } 
+    else {
+        result.success = false;
+        result.exit_code = -1;
+        
+        int signal = code;
+        if (signal == SIGXCPU || result.time_used_ms >= time_limit_ms) {
+            result.result = JudgeResult::TIME_LIMIT_EXCEEDED;
+            result.error_message = "程序超出时间限制";
+        } 
+        else if (result.memory_used_kb >= memory_limit_kb) {
+            // 分配失败后程序可能段错误，运行时也可能自行中止
+            result.result = JudgeResult::MEMORY_LIMIT_EXCEEDED;
+            result.error_message = "程序超出内存限制";
+        } 
+        else if (signal == SIGSEGV) {
+            result.result = JudgeResult::RUNTIME_ERROR;
+            result.error_message = "段错误";
+        } 
+        else {
+            result.result = JudgeResult::RUNTIME_ERROR;
+            result.error_message = "程序被信号终止: " + std::to_string(signal);
+        }
+    }
+}
+
 // 定义默认配置
 #define DEFAULT_WORK_DIR "/tmp/judge_engine"
 #define DEFAULT_TIME_LIMIT_MS 1000
@@ -127,7 +181,7 @@ bool JudgeEngine::judge(int submission_id, std::string& error_message) {
     
     // 获取题目信息
     Problem problem = ProblemRepository::getProblemById(submission.getProblemId());
-    if (problem.getId() == 0) {
+    if (problem.getId() == 0 || problem.getStatus() == PROBLEM_STATUS_DELETING) {
         error_message = "题目不存在";
         std::cerr << "【评测引擎】" << error_message << std::endl;
         return false;
@@ -156,22 +210,18 @@ bool JudgeEngine::judge(int submission_id, std::string& error_message) {
     }
     std::cout << "【评测引擎】创建临时目录: " << temp_dir << std::endl;
     
-    // 设置语言
-    std::string language;
-    switch (submission.getLanguage()) {
-        case Language::CPP:
-            language = "cpp";
-            break;
-        default:
-            error_message = "不支持的语言";
-            std::cerr << "【评测引擎】" << error_message << std::endl;
-            SubmissionService::judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, error_message);
-            cleanup(temp_dir);
-            return false;
+    // 查找语言的工具链
+    const Toolchain* toolchain = ToolchainRegistry::find(submission.getLanguage());
+    if (!toolchain || !toolchain->available) {
+        error_message = toolchain ? "评测机未安装该语言的编译器或解释器" : "不支持的语言";
+        std::cerr << "【评测引擎】" << error_message << std::endl;
+        SubmissionService::judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, error_message);
+        cleanup(temp_dir);
+        return false;
     }
     
     // 创建源文件
-    std::string source_file = createSourceFile(submission.getSourceCode(), language, temp_dir);
+    std::string source_file = createSourceFile(submission.getSourceCode(), *toolchain, temp_dir);
     if (source_file.empty()) {
         error_message = "创建源文件失败";
         std::cerr << "【评测引擎】" << error_message << std::endl;
@@ -182,7 +232,7 @@ bool JudgeEngine::judge(int submission_id, std::string& error_message) {
     std::cout << "【评测引擎】创建源文件: " << source_file << std::endl;
     
     // 编译代码
-    CompileResult compile_result = compileCode(submission.getSourceCode(), language, temp_dir);
+    CompileResult compile_result = compileCode(submission.getSourceCode(), *toolchain, temp_dir);
     if (!compile_result.success) {
         // 更新编译错误信息
         std::cout << "【评测引擎】编译错误: " << compile_result.error_message << std::endl;
@@ -211,7 +261,8 @@ bool JudgeEngine::judge(int submission_id, std::string& error_message) {
         // 执行测试用例
         TestPointExecutionResult test_result = executeTestCase(
             testcase.id, 
-            compile_result.executable_path, 
+            *toolchain, 
+            temp_dir, 
             testcase, 
             problem.getTimeLimit() > 0 ? problem.getTimeLimit() : time_limit_ms_, 
             problem.getMemoryLimit() > 0 ? problem.getMemoryLimit() : memory_limit_kb_
@@ -242,6 +293,17 @@ bool JudgeEngine::judge(int submission_id, std::string& error_message) {
         
         SubmissionService::addTestResult(point_result);
         
+        // 推送测试点进度
+        Json::Value progress;
+        progress["submission_id"] = submission_id;
+        progress["case"] = static_cast<int>(i + 1);
+        progress["total"] = total_cases;
+        progress["passed"] = test_result.passed;
+        progress["result"] = static_cast<int>(test_result.result);
+        progress["time_used"] = test_result.time_used_ms;
+        progress["memory_used"] = test_result.memory_used_kb;
+        SubmissionEvents::publish(submission_id, "progress", progress);
+        
         std::cout << "【评测引擎】测试用例 " << (i+1) << " 结果: " 
                   << (test_result.passed ? "通过" : "未通过") 
                   << ", 用时: " << test_result.time_used_ms << "ms" 
@@ -298,14 +360,14 @@ bool JudgeEngine::judge(int submission_id, std::string& error_message) {
 }
 
 // 编译代码
-CompileResult JudgeEngine::compileCode(const std::string& source_code, const std::string& language, const std::string& compile_dir) {
-    std::string source_file = createSourceFile(source_code, language, compile_dir);
+CompileResult JudgeEngine::compileCode(const std::string& source_code, const Toolchain& toolchain, const std::string& compile_dir) {
+    std::string source_file = createSourceFile(source_code, toolchain, compile_dir);
     if (source_file.empty()) {
         return CompileResult(false, "创建源文件失败");
     }
     
     // 获取编译命令
-    std::string compile_cmd = getCompileCommand(source_file, language);
+    std::string compile_cmd = getCompileCommand(toolchain, compile_dir);
     
     // 创建编译输出和错误文件
     std::string compile_output_file = compile_dir + "/compile_output.txt";
@@ -314,8 +376,8 @@ CompileResult JudgeEngine::compileCode(const std::string& source_code, const std
     // 构造完整命令（重定向输出和错误）
     std::string command = compile_cmd + " > " + compile_output_file + " 2> " + compile_error_file;
     
-    // 执行编译命令
-    int result = system(command.c_str());
+    // 执行编译命令（没有编译步骤的语言跳过）
+    int result = compile_cmd.empty() ? 0 : system(command.c_str());
     
     // 检查编译结果
     if (result != 0) {
@@ -333,13 +395,10 @@ CompileResult JudgeEngine::compileCode(const std::string& source_code, const std
         return CompileResult(false, error_message);
     }
     
-    // 构造可执行文件路径
-    std::string executable_path;
-    if (language == "cpp") {
-        executable_path = compile_dir + "/solution";
-    }
+    // 构造编译产物路径
+    std::string executable_path = compile_dir + "/" + toolchain.artifact;
     
-    // 检查可执行文件是否存在
+    // 检查编译产物是否存在
     struct stat st;
     if (stat(executable_path.c_str(), &st) != 0) {
         return CompileResult(false, "编译似乎成功但未生成可执行文件");
@@ -349,7 +408,7 @@ CompileResult JudgeEngine::compileCode(const std::string& source_code, const std
 }
 
 // 执行程序
-ExecutionResult JudgeEngine::executeProgram(const std::string& executable_path, const std::string& input, int time_limit_ms, int memory_limit_kb) {
+ExecutionResult JudgeEngine::executeProgram(const std::vector<std::string>& arguments, const std::string& input, int time_limit_ms, int memory_limit_kb, bool limit_address_space, int data_reserve_kb) {
     ExecutionResult result;
     
     // 创建临时文件用于输入和输出
@@ -410,12 +469,24 @@ ExecutionResult JudgeEngine::executeProgram(const std::string& executable_path,
         setrlimit(RLIMIT_CPU, &time_limit);
         
         struct rlimit mem_limit;
-        mem_limit.rlim_cur = memory_limit_kb * 1024; // 转换为字节
-        mem_limit.rlim_max = mem_limit.rlim_cur;
-        setrlimit(RLIMIT_AS, &mem_limit);
+        if (limit_address_space) {
+            mem_limit.rlim_cur = static_cast<rlim_t>(memory_limit_kb) * 1024; // 转换为字节
+            mem_limit.rlim_max = mem_limit.rlim_cur;
+            setrlimit(RLIMIT_AS, &mem_limit);
+        } else {
+            // 只统计可写的私有映射，运行时预留但未提交的地址空间不计入
+            mem_limit.rlim_cur = (static_cast<rlim_t>(memory_limit_kb) + data_reserve_kb) * 1024;
+            mem_limit.rlim_max = mem_limit.rlim_cur;
+            setrlimit(RLIMIT_DATA, &mem_limit);
+        }
         
-        // 执行程序
-        execl(executable_path.c_str(), executable_path.c_str(), NULL);
+        // 执行程序，解释器等按PATH查找
+        std::vector<char*> argv;
+        for (const auto& argument : arguments) {
+            argv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        argv.push_back(NULL);
+        execvp(argv[0], argv.data());
         
         // 如果到达这里，说明执行失败
         exit(EXIT_FAILURE);
@@ -443,18 +514,12 @@ ExecutionResult JudgeEngine::executeProgram(const std::string& executable_path,
         
         // 读取程序输出
         close(output_fd);
-        std::ifstream output_file(output_file_template);
-        std::stringstream output_stream;
-        output_stream << output_file.rdbuf();
-        result.output = output_stream.str();
+        result.output = readWholeFile(output_file_template);
         std::cout << "【评测引擎】程序输出: " << result.output << std::endl;
         
         // 读取错误输出
         close(error_fd);
-        std::ifstream error_file(error_file_template);
-        std::stringstream error_stream;
-        error_stream << error_file.rdbuf();
-        result.error_message = error_stream.str();
+        result.error_message = readWholeFile(error_file_template);
         if (!result.error_message.empty()) {
             std::cout << "【评测引擎】程序错误输出: " << result.error_message << std::endl;
         }
@@ -471,39 +536,10 @@ ExecutionResult JudgeEngine::executeProgram(const std::string& executable_path,
         
         // 检查运行结果
         if (WIFEXITED(status)) {
-            result.exit_code = WEXITSTATUS(status);
-            
-            if (result.exit_code == 0) {
-                result.success = true;
-                result.result = JudgeResult::ACCEPTED;
-            } else {
-                result.success = false;
-                result.result = JudgeResult::RUNTIME_ERROR;
-                result.error_message = "程序以非零状态码退出: " + std::to_string(result.exit_code);
-            }
+            classifyTermination(true, WEXITSTATUS(status), time_limit_ms, memory_limit_kb, result);
         } 
         else if (WIFSIGNALED(status)) {
-            result.success = false;
-            result.exit_code = -1;
-            
-            int signal = WTERMSIG(status);
-            if (signal == SIGXCPU || result.time_used_ms >= time_limit_ms) {
-                result.result = JudgeResult::TIME_LIMIT_EXCEEDED;
-                result.error_message = "程序超出时间限制";
-            } 
-            else if (signal == SIGSEGV) {
-                if (result.memory_used_kb >= memory_limit_kb) {
-                    result.result = JudgeResult::MEMORY_LIMIT_EXCEEDED;
-                    result.error_message = "程序超出内存限制";
-                } else {
-                    result.result = JudgeResult::RUNTIME_ERROR;
-                    result.error_message = "段错误";
-                }
-            } 
-            else {
-                result.result = JudgeResult::RUNTIME_ERROR;
-                result.error_message = "程序被信号终止: " + std::to_string(signal);
-            }
+            classifyTermination(false, WTERMSIG(status), time_limit_ms, memory_limit_kb, result);
         } 
         else {
             result.success = false;
@@ -520,13 +556,75 @@ ExecutionResult JudgeEngine::executeProgram(const std::string& executable_path,
     }
 }
 
+// 在常驻运行时中执行程序
+bool JudgeEngine::executeWarmProgram(const Toolchain& toolchain, const std::string& program_path, const std::string& input, int time_limit_ms, int memory_limit_kb, ExecutionResult& result) {
+    char input_file_template[] = "/tmp/judge_input_XXXXXX";
+    char output_file_template[] = "/tmp/judge_output_XXXXXX";
+    char error_file_template[] = "/tmp/judge_error_XXXXXX";
+    
+    int input_fd = mkstemp(input_file_template);
+    int output_fd = mkstemp(output_file_template);
+    int error_fd = mkstemp(error_file_template);
+    
+    bool files_ready = input_fd != -1 && output_fd != -1 && error_fd != -1;
+    if (files_ready) {
+        write(input_fd, input.c_str(), input.length());
+        write(input_fd, "\n", 1); // 确保输入有换行符结尾
+    }
+    if (input_fd != -1) close(input_fd);
+    if (output_fd != -1) close(output_fd);
+    if (error_fd != -1) close(error_fd);
+    
+    WarmRunStatus status;
+    bool executed = files_ready && WarmRunner::run(toolchain, program_path, input_file_template, output_file_template,
+                                                   error_file_template, time_limit_ms, memory_limit_kb, status);
+    if (executed) {
+        result.output = readWholeFile(output_file_template);
+        std::cout << "【评测引擎】程序输出: " << result.output << std::endl;
+        result.error_message = readWholeFile(error_file_template);
+        if (!result.error_message.empty()) {
+            std::cout << "【评测引擎】程序错误输出: " << result.error_message << std::endl;
+        }
+        
+        // 子进程从常驻进程fork出来，CPU时间不含解释器启动
+        result.time_used_ms = status.time_used_ms > 0 ? status.time_used_ms : status.wall_time_ms;
+        result.memory_used_kb = status.memory_used_kb;
+        classifyTermination(status.exited, status.code, time_limit_ms, memory_limit_kb, result);
+    }
+    
+    unlink(input_file_template);
+    unlink(output_file_template);
+    unlink(error_file_template);
+    return executed;
+}
+
 // 执行测试用例
-TestPointExecutionResult JudgeEngine::executeTestCase(int test_case_id, const std::string& executable_path, const TestCase& testcase, int time_limit_ms, int memory_limit_kb) {
+TestPointExecutionResult JudgeEngine::executeTestCase(int test_case_id, const Toolchain& toolchain, const std::string& dir, const TestCase& testcase, int time_limit_ms, int memory_limit_kb) {
     TestPointExecutionResult result;
     result.test_case_id = test_case_id;
     
-    // 执行程序
-    ExecutionResult exec_result = executeProgram(executable_path, testcase.input, time_limit_ms, memory_limit_kb);
+    // 执行程序，时间和内存限制按语言换算；有常驻运行时的语言优先在常驻运行时中执行，不可用时冷启动
+    ExecutionResult exec_result;
+    if (toolchain.runner_command.empty() ||
+        !executeWarmProgram(toolchain, dir + "/" + toolchain.artifact, testcase.input,
+                            toolchain.effectiveTimeLimit(time_limit_ms),
+                            toolchain.effectiveMemoryLimit(memory_limit_kb), exec_result)) {
+        exec_result = executeProgram(
+            getExecuteCommand(toolchain, dir, memory_limit_kb),
+            testcase.input,
+            toolchain.effectiveTimeLimit(time_limit_ms),
+            toolchain.effectiveMemoryLimit(memory_limit_kb),
+            toolchain.limit_address_space,
+            toolchain.data_reserve_kb
+        );
+    }
+    
+    // 运行时自己报告内存不足（如JVM堆溢出）时按内存超限处理
+    if (exec_result.result == JudgeResult::RUNTIME_ERROR && !toolchain.oom_marker.empty() &&
+        exec_result.error_message.find(toolchain.oom_marker) != std::string::npos) {
+        exec_result.result = JudgeResult::MEMORY_LIMIT_EXCEEDED;
+        exec_result.error_message = "程序超出内存限制";
+    }
     
     // 复制执行结果信息
     result.passed = exec_result.success;
@@ -640,18 +738,13 @@ std::string JudgeEngine::createTempDir(int submission_id) {
 }
 
 // 创建源代码文件
-std::string JudgeEngine::createSourceFile(const std::string& source_code, const std::string& language, const std::string& dir) {
-    std::string filename;
-    if (language == "cpp") {
-        filename = dir + "/solution.cpp";
-    } else {
-        return "";
-    }
+std::string JudgeEngine::createSourceFile(const std::string& source_code, const Toolchain& toolchain, const std::string& dir) {
+    std::string filename = dir + "/" + toolchain.source_file;
     
     try {
         std::ofstream source_file(filename);
         
-        if (language == "cpp") {
+        if (toolchain.language == Language::CPP) {
             // 添加必要的头文件 - 保留最基本的，不过多添加
             source_file << "#include <iostream>\n"
                        << "#include <vector>\n"
@@ -743,18 +836,16 @@ std::string JudgeEngine::createSourceFile(const std::string& source_code, const
 }
 
 // 获取编译命令
-std::string JudgeEngine::getCompileCommand(const std::string& source_file, const std::string& language) {
-    if (language == "cpp") {
-        // 使用C++11标准
-        return "g++ -std=c++11 -O2 -Wall -o " + 
-               source_file.substr(0, source_file.size() - 4) + " " + source_file;
+std::string JudgeEngine::getCompileCommand(const Toolchain& toolchain, const std::string& dir) {
+    if (toolchain.compile_command.empty()) {
+        return "";
     }
-    return "";
+    return ToolchainRegistry::expand(toolchain.compile_command, toolchain, dir, memory_limit_kb_);
 }
 
 // 获取执行命令
-std::string JudgeEngine::getExecuteCommand(const std::string& executable_file, const std::string& language) {
-    return executable_file;
+std::vector<std::string> JudgeEngine::getExecuteCommand(const Toolchain& toolchain, const std::string& dir, int memory_limit_kb) {
+    return ToolchainRegistry::runArguments(toolchain, dir, memory_limit_kb);
 }
 
 // 获取评测结果的字符串描述
@@ -0,0 +1,188 @@
+#include "../../include/services/problem_catalog.h"
+#include "../../include/services/problem_search_index.h"
+#include "../../include/database/database.h"
+#include "../../include/models/problem.h"
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <iostream>
+#include <algorithm>
+#include <mysql/mysql.h>
+
+namespace {
+    // 当前快照，读写都通过 std::atomic_load / std::atomic_store
+    std::shared_ptr<const ProblemCatalog::Snapshot> current_snapshot;
+
+    // 写者之间串行，避免并发的复制修改互相覆盖
+    std::mutex writer_mutex;
+
+    const char* SUMMARY_COLUMNS =
+        "id, title, difficulty, time_limit, memory_limit, status, created_by, created_at, updated_at";
+
+    ProblemSummary parseSummary(MYSQL_ROW row) {
+        ProblemSummary summary;
+        summary.id = std::atoi(row[0]);
+        summary.title = row[1] ? row[1] : "";
+        summary.difficulty = row[2] ? row[2] : "中等";
+        summary.time_limit = row[3] ? std::atoi(row[3]) : 1000;
+        summary.memory_limit = row[4] ? std::atoi(row[4]) : 65536;
+        summary.status = row[5] ? std::atoi(row[5]) : 1;
+        summary.created_by = row[6] ? std::atoi(row[6]) : 0;
+        summary.created_at = row[7] ? std::atoll(row[7]) : 0;
+        summary.updated_at = row[8] ? std::atoll(row[8]) : 0;
+        return summary;
+    }
+
+    bool idGreater(const ProblemSummary& summary, int id) {
+        return summary.id > id;
+    }
+
+    // 在按ID降序排列的快照中查找题目
+    const ProblemSummary* findSummary(const ProblemCatalog::Snapshot& snapshot, int id) {
+        auto it = std::lower_bound(snapshot.begin(), snapshot.end(), id, idGreater);
+        return it != snapshot.end() && it->id == id ? &*it : nullptr;
+    }
+
+    bool matches(const ProblemSummary& summary, const std::string& difficulty, int status) {
+        return (difficulty.empty() || summary.difficulty == difficulty) &&
+               (status < 0 || summary.status == status);
+    }
+}
+
+Json::Value ProblemSummary::toJson() const {
+    Json::Value json;
+    json["id"] = id;
+    json["title"] = title;
+    json["difficulty"] = difficulty;
+    json["time_limit"] = time_limit;
+    json["memory_limit"] = memory_limit;
+    json["status"] = status;
+    json["created_by"] = created_by;
+    json["created_at"] = Json::Int64(created_at);
+    json["updated_at"] = Json::Int64(updated_at);
+    return json;
+}
+
+bool ProblemCatalog::build() {
+    MYSQL_RES* result = Database::getInstance()->executeQuery(std::string("SELECT ") + SUMMARY_COLUMNS + " FROM problems WHERE status <> " +
+                                                               std::to_string(PROBLEM_STATUS_DELETING) + " ORDER BY id DESC");
+    if (!result) {
+        std::cerr << "载入题目目录失败，数据库错误" << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (row[0]) {
+            snapshot->push_back(parseSummary(row));
+        }
+    }
+    mysql_free_result(result);
+
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    std::atomic_store(&current_snapshot, std::shared_ptr<const Snapshot>(snapshot));
+    std::cout << "题目目录已载入，题目数: " << snapshot->size() << std::endl;
+    return true;
+}
+
+bool ProblemCatalog::ready() {
+    return std::atomic_load(&current_snapshot) != nullptr;
+}
+
+void ProblemCatalog::refresh(int problem_id) {
+    // 读取和替换都持有写锁，同一题目的并发修改不会让旧数据覆盖新数据
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&current_snapshot);
+    if (!current) {
+        return;
+    }
+
+    std::string sql = std::string("SELECT ") + SUMMARY_COLUMNS + " FROM problems WHERE id = " +
+                      std::to_string(problem_id) + " AND status <> " + std::to_string(PROBLEM_STATUS_DELETING);
+    MYSQL_RES* result = Database::getInstance()->executeQuery(sql);
+    if (!result) {
+        std::cerr << "刷新题目目录失败，题目ID: " << problem_id << std::endl;
+        return;
+    }
+    MYSQL_ROW row = mysql_fetch_row(result);
+    bool exists = row && row[0];
+    ProblemSummary summary;
+    if (exists) {
+        summary = parseSummary(row);
+    }
+    mysql_free_result(result);
+
+    std::shared_ptr<Snapshot> updated = std::make_shared<Snapshot>(*current);
+    auto it = std::lower_bound(updated->begin(), updated->end(), problem_id, idGreater);
+    if (!exists) {
+        if (it == updated->end() || it->id != problem_id) {
+            return;
+        }
+        updated->erase(it);
+    } else if (it != updated->end() && it->id == problem_id) {
+        *it = summary;
+    } else {
+        updated->insert(it, summary);
+    }
+    std::atomic_store(&current_snapshot, std::shared_ptr<const Snapshot>(updated));
+}
+
+void ProblemCatalog::remove(int problem_id) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&current_snapshot);
+    if (!current || !findSummary(*current, problem_id)) {
+        return;
+    }
+
+    std::shared_ptr<Snapshot> updated = std::make_shared<Snapshot>(*current);
+    updated->erase(std::lower_bound(updated->begin(), updated->end(), problem_id, idGreater));
+    std::atomic_store(&current_snapshot, std::shared_ptr<const Snapshot>(updated));
+}
+
+std::shared_ptr<const ProblemCatalog::Snapshot> ProblemCatalog::snapshot() {
+    return std::atomic_load(&current_snapshot);
+}
+
+bool ProblemCatalog::list(const std::string& search, const std::string& difficulty, int status, int offset, int limit,
+                          std::vector<ProblemSummary>& page, int& total) {
+    page.clear();
+    total = 0;
+    offset = std::max(offset, 0);
+
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&current_snapshot);
+    if (!current) {
+        return false;
+    }
+
+    if (search.empty()) {
+        for (const auto& summary : *current) {
+            if (!matches(summary, difficulty, status)) {
+                continue;
+            }
+            if (total >= offset && static_cast<int>(page.size()) < limit) {
+                page.push_back(summary);
+            }
+            total++;
+        }
+        return true;
+    }
+
+    // 取出全部命中的题目（按相关度排序），再按难度和状态筛选
+    std::vector<int> ids;
+    int hits = 0;
+    if (!ProblemSearchIndex::search(search, 0, std::numeric_limits<int>::max(), ids, hits)) {
+        return false;
+    }
+    for (int id : ids) {
+        const ProblemSummary* summary = findSummary(*current, id);
+        if (!summary || !matches(*summary, difficulty, status)) {
+            continue;
+        }
+        if (total >= offset && static_cast<int>(page.size()) < limit) {
+            page.push_back(*summary);
+        }
+        total++;
+    }
+    return true;
+}
@@ -0,0 +1,312 @@
+#include "../../include/services/problem_deletion.h"
+#include "../../include/services/problem_stats.h"
+#include "../../include/services/hot_discussions.h"
+#include "../../include/services/discussion_likes.h"
+#include "../../include/services/ranking_service.h"
+#include "../../include/database/database.h"
+#include "../../include/models/problem.h"
+#include "../../include/utils/cache_version.h"
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+#include <condition_variable>
+#include <mysql/mysql.h>
+
+namespace {
+    // 删除阶段，按顺序执行，进度保存在 problem_deletions.stage
+    enum Stage {
+        STAGE_SUBMISSIONS = 0,     // 提交记录及其测试点结果，同时撤销对用户统计的贡献
+        STAGE_REPLIES = 1,         // 讨论回复及其点赞
+        STAGE_DISCUSSIONS = 2,     // 讨论及其点赞
+        STAGE_TESTCASES = 3,       // 测试用例
+        STAGE_PROBLEM = 4          // 题目本身、用户题目状态和任务记录
+    };
+
+    std::mutex worker_mutex;
+    std::condition_variable worker_cond;
+    std::thread worker;
+    std::atomic<bool> worker_running(false);
+    bool wake_pending = false;
+
+    std::string joinIds(const std::vector<int>& ids) {
+        std::stringstream ss;
+        for (size_t i = 0; i < ids.size(); i++) {
+            ss << (i > 0 ? "," : "") << ids[i];
+        }
+        return ss.str();
+    }
+
+    void saveStage(int problem_id, int stage) {
+        std::stringstream sql;
+        sql << "UPDATE problem_deletions SET stage = " << stage << ", updated_at = " << std::time(nullptr)
+            << " WHERE problem_id = " << problem_id;
+        Database::getInstance()->executeCommand(sql.str());
+    }
+
+    // 批次之间暂停，被停止时返回false
+    bool pause() {
+        std::unique_lock<std::mutex> lock(worker_mutex);
+        worker_cond.wait_for(lock, std::chrono::milliseconds(PROBLEM_DELETE_PAUSE_MS),
+                             []() { return !worker_running; });
+        return worker_running;
+    }
+}
+
+void ProblemDeletion::start() {
+    if (worker_running.exchange(true)) {
+        return;
+    }
+
+    worker = std::thread([]() {
+        std::unique_lock<std::mutex> lock(worker_mutex);
+        while (worker_running) {
+            wake_pending = false;
+            lock.unlock();
+
+            // 依次执行所有未完成的任务（包括上次运行中断的）
+            std::vector<std::pair<int, int>> jobs;
+            MYSQL_RES* result = Database::getInstance()->executeQuery(
+                "SELECT problem_id, stage FROM problem_deletions ORDER BY created_at");
+            if (result) {
+                MYSQL_ROW row;
+                while ((row = mysql_fetch_row(result))) {
+                    if (row[0]) {
+                        jobs.push_back(std::make_pair(std::atoi(row[0]), row[1] ? std::atoi(row[1]) : 0));
+                    }
+                }
+                mysql_free_result(result);
+            }
+            for (const auto& job : jobs) {
+                if (!worker_running) {
+                    break;
+                }
+                runJob(job.first, job.second);
+            }
+
+            lock.lock();
+            worker_cond.wait_for(lock, std::chrono::milliseconds(PROBLEM_DELETE_POLL_MS),
+                                 []() { return !worker_running || wake_pending; });
+        }
+    });
+    std::cout << "题目删除线程已启动" << std::endl;
+}
+
+void ProblemDeletion::stop() {
+    if (!worker_running.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex);
+    }
+    worker_cond.notify_all();
+
+    if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) {
+        worker.join();
+    }
+    std::cout << "题目删除线程已停止" << std::endl;
+}
+
+bool ProblemDeletion::schedule(int problem_id, std::string& error_message) {
+    Database* db = Database::getInstance();
+
+    std::stringstream check_sql;
+    check_sql << "SELECT id FROM problems WHERE id = " << problem_id << " AND status <> " << PROBLEM_STATUS_DELETING;
+    MYSQL_RES* result = db->executeQuery(check_sql.str());
+    bool exists = result && mysql_num_rows(result) > 0;
+    if (result) {
+        mysql_free_result(result);
+    }
+    if (!exists) {
+        error_message = "题目不存在";
+        return false;
+    }
+
+    // 标记和登记在同一事务中完成，不会出现隐藏了题目却没有删除任务的情况
+    int64_t now = std::time(nullptr);
+    std::vector<std::string> commands;
+    std::stringstream hide_sql;
+    hide_sql << "UPDATE problems SET status = " << PROBLEM_STATUS_DELETING << ", updated_at = " << now
+             << " WHERE id = " << problem_id;
+    commands.push_back(hide_sql.str());
+    std::stringstream job_sql;
+    job_sql << "INSERT INTO problem_deletions (problem_id, stage, created_at, updated_at) VALUES ("
+            << problem_id << ", " << STAGE_SUBMISSIONS << ", " << now << ", " << now << ") "
+            << "ON DUPLICATE KEY UPDATE updated_at = VALUES(updated_at)";
+    commands.push_back(job_sql.str());
+
+    unsigned long long affected_rows = 0;
+    if (!db->executeTransaction(commands, affected_rows)) {
+        error_message = "删除题目失败，数据库错误";
+        return false;
+    }
+
+    std::cout << "题目 " << problem_id << " 已标记为删除中，关联数据由后台删除" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex);
+        wake_pending = true;
+    }
+    worker_cond.notify_all();
+    return true;
+}
+
+bool ProblemDeletion::runJob(int problem_id, int stage) {
+    std::cout << "开始删除题目 " << problem_id << " 的关联数据，阶段: " << stage << std::endl;
+    long long total = 0;
+
+    while (stage < STAGE_PROBLEM) {
+        long long deleted = deleteBatch(problem_id, stage);
+        if (deleted < 0) {
+            std::cerr << "删除题目 " << problem_id << " 的关联数据失败，稍后重试" << std::endl;
+            return false;
+        }
+        total += deleted;
+        if (deleted == 0) {
+            stage++;
+            saveStage(problem_id, stage);
+        }
+        if (!pause()) {
+            return false;
+        }
+    }
+
+    // 删除期间仍可能有新的提交写入，先清理干净再删除题目
+    long long late = deleteBatch(problem_id, STAGE_SUBMISSIONS);
+    while (late > 0) {
+        total += late;
+        if (!pause()) {
+            return false;
+        }
+        late = deleteBatch(problem_id, STAGE_SUBMISSIONS);
+    }
+    if (late < 0 || deleteBatch(problem_id, STAGE_PROBLEM) < 0) {
+        std::cerr << "删除题目 " << problem_id << " 失败，稍后重试" << std::endl;
+        return false;
+    }
+
+    // 删除期间评测结束的提交可能又累计了统计
+    ProblemStats::remove(problem_id);
+    CacheVersion::bump(CacheVersion::PROBLEMS);
+    std::cout << "题目 " << problem_id << " 删除完成，共删除关联数据 " << total << " 行" << std::endl;
+    return true;
+}
+
+long long ProblemDeletion::deleteBatch(int problem_id, int stage) {
+    std::stringstream select_sql;
+    switch (stage) {
+        case STAGE_SUBMISSIONS:
+            // 按ID升序删除，首次通过在最早的通过提交所在批次撤销
+            select_sql << "SELECT id FROM submissions WHERE problem_id = " << problem_id << " ORDER BY id";
+            break;
+        case STAGE_REPLIES:
+            select_sql << "SELECT dr.id FROM discussion_replies dr INNER JOIN discussions d ON dr.discussion_id = d.id "
+                       << "WHERE d.problem_id = " << problem_id;
+            break;
+        case STAGE_DISCUSSIONS:
+            select_sql << "SELECT id FROM discussions WHERE problem_id = " << problem_id;
+            break;
+        case STAGE_TESTCASES:
+            select_sql << "SELECT id FROM testcases WHERE problem_id = " << problem_id;
+            break;
+        default:
+            break;
+    }
+
+    std::vector<int> ids;
+    std::vector<std::string> commands;
+    if (stage == STAGE_PROBLEM) {
+        commands.push_back("DELETE FROM problems WHERE id = " + std::to_string(problem_id) +
+                           " AND status = " + std::to_string(PROBLEM_STATUS_DELETING));
+        commands.push_back("DELETE FROM user_problem_status WHERE problem_id = " + std::to_string(problem_id));
+        commands.push_back("DELETE FROM problem_deletions WHERE problem_id = " + std::to_string(problem_id));
+    } else {
+        select_sql << " LIMIT " << PROBLEM_DELETE_BATCH;
+        if (!selectIds(select_sql.str(), ids)) {
+            return -1;
+        }
+        if (ids.empty()) {
+            return 0;
+        }
+    }
+
+    std::string id_list = joinIds(ids);
+    std::vector<int> user_ids;
+    switch (stage) {
+        case STAGE_SUBMISSIONS:
+            commands.push_back("DELETE FROM test_point_results WHERE submission_id IN (" + id_list + ")");
+            commands.push_back("DELETE FROM submissions WHERE id IN (" + id_list + ")");
+            break;
+        case STAGE_REPLIES:
+            commands.push_back("DELETE FROM discussion_likes WHERE target_type = " +
+                               std::to_string(static_cast<int>(LikeTarget::REPLY)) +
+                               " AND target_id IN (" + id_list + ")");
+            commands.push_back("DELETE FROM discussion_replies WHERE id IN (" + id_list + ")");
+            break;
+        case STAGE_DISCUSSIONS:
+            // 上一阶段之后新增的回复一并删除
+            commands.push_back("DELETE FROM discussion_replies WHERE discussion_id IN (" + id_list + ")");
+            commands.push_back("DELETE FROM discussion_likes WHERE target_type = " +
+                               std::to_string(static_cast<int>(LikeTarget::DISCUSSION)) +
+                               " AND target_id IN (" + id_list + ")");
+            commands.push_back("DELETE FROM discussions WHERE id IN (" + id_list + ")");
+            break;
+        case STAGE_TESTCASES:
+            commands.push_back("DELETE FROM testcases WHERE id IN (" + id_list + ")");
+            break;
+        default:
+            break;
+    }
+
+    unsigned long long affected_rows = 0;
+    bool committed = false;
+    if (stage == STAGE_SUBMISSIONS) {
+        // 撤销用户计数、每日分桶的查询和删除提交在同一事务中：查询锁定这批提交，
+        // 撤销的正是被删除的结果，中断后也不会重复撤销
+        committed = Database::getInstance()->executeTransaction(
+            RankingService::submissionRevocationQuery(ids),
+            [&user_ids](MYSQL_RES* result, std::vector<std::string>& revocation) {
+                user_ids.clear();
+                RankingService::buildSubmissionRevocation(result, revocation, user_ids);
+                return true;
+            },
+            commands, affected_rows);
+    } else {
+        committed = Database::getInstance()->executeTransaction(commands, affected_rows);
+    }
+    if (!committed) {
+        return -1;
+    }
+
+    // 排名按剩余的提交重新统计
+    for (int user_id : user_ids) {
+        RankingService::updateUserRanking(user_id);
+    }
+    if (stage == STAGE_DISCUSSIONS) {
+        for (int id : ids) {
+            HotDiscussions::remove(id);
+        }
+        CacheVersion::bump(CacheVersion::DISCUSSIONS);
+    }
+    // 选出的行已被并发删除时影响行数可能为0，按选出的行数计，避免误判阶段已完成
+    return std::max(static_cast<long long>(affected_rows), static_cast<long long>(ids.size()));
+}
+
+bool ProblemDeletion::selectIds(const std::string& sql, std::vector<int>& ids) {
+    ids.clear();
+    MYSQL_RES* result = Database::getInstance()->executeQuery(sql);
+    if (!result) {
+        return false;
+    }
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (row[0]) {
+            ids.push_back(std::atoi(row[0]));
+        }
+    }
+    mysql_free_result(result);
+    return true;
+}
@@ -0,0 +1,347 @@
+#include "../../include/services/problem_search_index.h"
+#include "../../include/database/database.h"
+#include "../../include/models/problem.h"
+#include <map>
+#include <cmath>
+#include <mutex>
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <mysql/mysql.h>
+
+namespace {
+    // 词在单个题目中的出现次数
+    struct Posting {
+        int title_count;
+        int body_count;
+    };
+
+    typedef std::unordered_map<int, Posting> PostingList;
+
+    // 一段连续的词或中日韩文字
+    struct Run {
+        std::string text;
+        std::vector<std::string> chars;
+        bool cjk;
+    };
+
+    std::mutex index_mutex;
+    bool index_ready = false;
+
+    // 词典有序，英文查询词可按前缀取出一段词
+    std::map<std::string, PostingList> terms;
+
+    // 每个题目包含的词，更新和删除时据此清理倒排表
+    std::unordered_map<int, std::vector<std::string>> doc_terms;
+
+    // 规范化后的标题和描述，用于校验较长的中文短语
+    std::unordered_map<int, std::string> doc_texts;
+
+    bool isCjk(uint32_t cp) {
+        return (cp >= 0x4E00 && cp <= 0x9FFF) ||   // 中日韩统一表意文字
+               (cp >= 0x3400 && cp <= 0x4DBF) ||   // 扩展A
+               (cp >= 0xF900 && cp <= 0xFAFF) ||   // 兼容表意文字
+               (cp >= 0x3040 && cp <= 0x30FF) ||   // 平假名、片假名
+               (cp >= 0xAC00 && cp <= 0xD7AF);     // 韩文音节
+    }
+
+    // 切分为英文数字词和中日韩文字段，其余字符作为分隔符
+    std::vector<Run> splitRuns(const std::string& text) {
+        std::vector<Run> runs;
+        Run current;
+        current.cjk = false;
+
+        auto flush = [&]() {
+            if (!current.text.empty()) {
+                runs.push_back(current);
+            }
+            current.text.clear();
+            current.chars.clear();
+        };
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            unsigned char c = static_cast<unsigned char>(text[pos]);
+            if (c < 0x80) {
+                pos++;
+                if (std::isalnum(c)) {
+                    if (current.cjk) {
+                        flush();
+                    }
+                    current.cjk = false;
+                    current.text.push_back(static_cast<char>(std::tolower(c)));
+                } else {
+                    flush();
+                }
+                continue;
+            }
+
+            // 解码一个UTF-8字符，不完整的序列按分隔符处理
+            size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+            if (length == 1 || pos + length > text.size()) {
+                pos++;
+                flush();
+                continue;
+            }
+            uint32_t cp = c & (0xFF >> (length + 1));
+            for (size_t i = 1; i < length; i++) {
+                cp = (cp << 6) | (static_cast<unsigned char>(text[pos + i]) & 0x3F);
+            }
+            std::string ch = text.substr(pos, length);
+            pos += length;
+
+            if (isCjk(cp)) {
+                if (!current.cjk) {
+                    flush();
+                }
+                current.cjk = true;
+                current.text += ch;
+                current.chars.push_back(ch);
+            } else {
+                flush();
+            }
+        }
+        flush();
+        return runs;
+    }
+
+    // 文本中的索引词及出现次数：英文数字词整体索引，中文按单字和相邻两字索引
+    void collectTerms(const std::string& text, std::map<std::string, int>& counts, std::string& normalized) {
+        for (const auto& run : splitRuns(text)) {
+            normalized += run.text;
+            normalized += ' ';
+            if (!run.cjk) {
+                counts[run.text]++;
+                continue;
+            }
+            for (size_t i = 0; i < run.chars.size(); i++) {
+                counts[run.chars[i]]++;
+                if (i + 1 < run.chars.size()) {
+                    counts[run.chars[i] + run.chars[i + 1]]++;
+                }
+            }
+        }
+    }
+
+    // 以下函数调用方持有 index_mutex
+    void removeDoc(int problem_id) {
+        auto it = doc_terms.find(problem_id);
+        if (it == doc_terms.end()) {
+            return;
+        }
+        for (const auto& term : it->second) {
+            auto term_it = terms.find(term);
+            if (term_it == terms.end()) {
+                continue;
+            }
+            term_it->second.erase(problem_id);
+            if (term_it->second.empty()) {
+                terms.erase(term_it);
+            }
+        }
+        doc_terms.erase(it);
+        doc_texts.erase(problem_id);
+    }
+
+    void addDoc(int problem_id, const std::string& title, const std::string& description) {
+        std::map<std::string, int> title_counts;
+        std::map<std::string, int> body_counts;
+        std::string normalized;
+        collectTerms(title, title_counts, normalized);
+        normalized += '\n';
+        collectTerms(description, body_counts, normalized);
+
+        std::vector<std::string>& doc_term_list = doc_terms[problem_id];
+        for (const auto& item : title_counts) {
+            Posting& posting = terms[item.first][problem_id];
+            posting.title_count = item.second;
+            posting.body_count = 0;
+            doc_term_list.push_back(item.first);
+        }
+        for (const auto& item : body_counts) {
+            PostingList& postings = terms[item.first];
+            auto posting_it = postings.find(problem_id);
+            if (posting_it == postings.end()) {
+                Posting posting = {0, item.second};
+                postings[problem_id] = posting;
+                doc_term_list.push_back(item.first);
+            } else {
+                posting_it->second.body_count = item.second;
+            }
+        }
+        doc_texts[problem_id] = normalized;
+    }
+
+    int weightOf(const Posting& posting) {
+        return (posting.title_count > 0 ? PROBLEM_SEARCH_TITLE_WEIGHT : 0) +
+               std::min(posting.body_count, PROBLEM_SEARCH_BODY_CAP);
+    }
+
+    // 单个查询词命中的题目及权重
+    std::unordered_map<int, int> matchRun(const Run& run) {
+        std::unordered_map<int, int> matches;
+
+        if (!run.cjk) {
+            // 英文数字按前缀匹配
+            for (auto it = terms.lower_bound(run.text);
+                 it != terms.end() && it->first.compare(0, run.text.size(), run.text) == 0; ++it) {
+                for (const auto& posting : it->second) {
+                    matches[posting.first] += weightOf(posting.second);
+                }
+            }
+            return matches;
+        }
+
+        if (run.chars.size() == 1) {
+            auto it = terms.find(run.text);
+            if (it != terms.end()) {
+                for (const auto& posting : it->second) {
+                    matches[posting.first] = weightOf(posting.second);
+                }
+            }
+            return matches;
+        }
+
+        // 对各个两字片段求交集，权重取最小值
+        for (size_t i = 0; i + 1 < run.chars.size(); i++) {
+            auto it = terms.find(run.chars[i] + run.chars[i + 1]);
+            if (it == terms.end()) {
+                return std::unordered_map<int, int>();
+            }
+            if (i == 0) {
+                for (const auto& posting : it->second) {
+                    matches[posting.first] = weightOf(posting.second);
+                }
+                continue;
+            }
+            for (auto match = matches.begin(); match != matches.end();) {
+                auto posting = it->second.find(match->first);
+                if (posting == it->second.end()) {
+                    match = matches.erase(match);
+                } else {
+                    match->second = std::min(match->second, weightOf(posting->second));
+                    ++match;
+                }
+            }
+        }
+
+        // 两字片段都出现不代表短语连续出现，三字及以上时在原文中校验
+        if (run.chars.size() > 2) {
+            for (auto match = matches.begin(); match != matches.end();) {
+                if (doc_texts[match->first].find(run.text) == std::string::npos) {
+                    match = matches.erase(match);
+                } else {
+                    ++match;
+                }
+            }
+        }
+        return matches;
+    }
+}
+
+bool ProblemSearchIndex::build() {
+    MYSQL_RES* result = Database::getInstance()->executeQuery(
+        "SELECT id, title, description FROM problems WHERE status <> " + std::to_string(PROBLEM_STATUS_DELETING));
+    if (!result) {
+        std::cerr << "建立题目检索索引失败，数据库错误" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(index_mutex);
+    terms.clear();
+    doc_terms.clear();
+    doc_texts.clear();
+
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (row[0]) {
+            addDoc(std::stoi(row[0]), row[1] ? row[1] : "", row[2] ? row[2] : "");
+        }
+    }
+    mysql_free_result(result);
+
+    index_ready = true;
+    std::cout << "题目检索索引已建立，题目数: " << doc_terms.size() << "，词数: " << terms.size() << std::endl;
+    return true;
+}
+
+bool ProblemSearchIndex::ready() {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    return index_ready;
+}
+
+void ProblemSearchIndex::update(int problem_id, const std::string& title, const std::string& description) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    removeDoc(problem_id);
+    addDoc(problem_id, title, description);
+}
+
+void ProblemSearchIndex::remove(int problem_id) {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    removeDoc(problem_id);
+}
+
+bool ProblemSearchIndex::search(const std::string& query, int offset, int limit, std::vector<int>& ids, int& total) {
+    ids.clear();
+    total = 0;
+
+    std::vector<Run> runs = splitRuns(query);
+    if (runs.size() > PROBLEM_SEARCH_MAX_TERMS) {
+        runs.resize(PROBLEM_SEARCH_MAX_TERMS);
+    }
+
+    std::vector<std::pair<double, int>> ranked;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        if (!index_ready) {
+            return false;
+        }
+        if (runs.empty()) {
+            return true;
+        }
+
+        // 逐个查询词求交集，得分为各词权重乘以 log(1 + N / df)
+        std::unordered_map<int, double> scores;
+        double doc_count = static_cast<double>(doc_terms.size());
+        for (size_t i = 0; i < runs.size(); i++) {
+            std::unordered_map<int, int> matches = matchRun(runs[i]);
+            double idf = std::log(1.0 + doc_count / std::max<size_t>(matches.size(), 1));
+            if (i == 0) {
+                for (const auto& match : matches) {
+                    scores[match.first] = match.second * idf;
+                }
+            } else {
+                for (auto it = scores.begin(); it != scores.end();) {
+                    auto match = matches.find(it->first);
+                    if (match == matches.end()) {
+                        it = scores.erase(it);
+                    } else {
+                        it->second += match->second * idf;
+                        ++it;
+                    }
+                }
+            }
+            if (scores.empty()) {
+                return true;
+            }
+        }
+
+        ranked.reserve(scores.size());
+        for (const auto& item : scores) {
+            ranked.push_back(std::make_pair(item.second, item.first));
+        }
+    }
+
+    // 得分降序，同分时ID降序（与列表页的默认顺序一致）
+    std::sort(ranked.begin(), ranked.end(), [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second > b.second;
+    });
+
+    total = static_cast<int>(ranked.size());
+    for (int i = std::max(offset, 0); i < total && static_cast<int>(ids.size()) < limit; i++) {
+        ids.push_back(ranked[i].second);
+    }
+    return true;
+}
@@ -1,10 +1,17 @@
 #include "../../include/services/problem_service.h"
 #include "../../include/database/database.h"
+#include "../../include/utils/cache_version.h"
+#include "../../include/services/problem_search_index.h"
+#include "../../include/services/problem_catalog.h"
+#include "../../include/services/problem_stats.h"
+#include "../../include/services/problem_deletion.h"
 #include <iostream>
 #include <ctime>
 #include <sstream>
 #include <mysql/mysql.h>
 #include <memory>
+#include <unordered_map>
+#include <algorithm>
 
 // 自定义MySQL结果集智能指针包装器
 class MySQLResultWrapper {
@@ -58,7 +65,7 @@ public:
 };
 
 // 获取所有题目
-std::vector<Problem> ProblemService::getAllProblems(int offset, int limit, const std::string& search) {
+std::vector<Problem> ProblemService::getAllProblems(int offset, int limit, const std::string& search, int* total) {
     std::vector<Problem> problems;
     Database* db = Database::getInstance();
     
@@ -67,13 +74,33 @@ std::vector<Problem> ProblemService::getAllProblems(int offset, int limit, const
         sql << "SELECT id, title, description, code_template, input_format, output_format, difficulty, "
             << "time_limit, memory_limit, example_input, example_output, hint, "
             << "created_by, created_at, updated_at, status "
-            << "FROM problems WHERE 1=1 ";
+            << "FROM problems WHERE status <> " << PROBLEM_STATUS_DELETING << " ";
         
-        if (!search.empty()) {
-            sql << "AND (title LIKE '%" << search << "%' OR description LIKE '%" << search << "%') ";
+        // 有搜索词时先从检索索引取出当前页的题目ID（按相关度排序），再按主键读取
+        std::vector<int> search_ids;
+        int search_total = 0;
+        bool use_index = !search.empty() && ProblemSearchIndex::search(search, offset, limit, search_ids, search_total);
+        if (total) {
+            *total = use_index ? search_total : countProblems(search);
         }
         
-        sql << "ORDER BY id DESC LIMIT " << limit << " OFFSET " << offset;
+        if (use_index) {
+            if (search_ids.empty()) {
+                return problems;
+            }
+            sql << "AND id IN (";
+            for (size_t i = 0; i < search_ids.size(); i++) {
+                sql << (i > 0 ? "," : "") << search_ids[i];
+            }
+            sql << ")";
+        } else {
+            if (!search.empty()) {
+                std::string escaped_search = db->escapeString(search);
+                sql << "AND (title LIKE '%" << escaped_search << "%' OR description LIKE '%" << escaped_search << "%') ";
+            }
+            
+            sql << "ORDER BY id DESC LIMIT " << limit << " OFFSET " << offset;
+        }
         
         MYSQL_RES* rawResult = db->executeQuery(sql.str());
         if (!rawResult) {
@@ -108,6 +135,17 @@ std::vector<Problem> ProblemService::getAllProblems(int offset, int limit, const
             
             problems.push_back(problem);
         }
+        
+        // 按检索结果的顺序排列
+        if (use_index) {
+            std::unordered_map<int, size_t> order;
+            for (size_t i = 0; i < search_ids.size(); i++) {
+                order[search_ids[i]] = i;
+            }
+            std::sort(problems.begin(), problems.end(), [&order](const Problem& a, const Problem& b) {
+                return order[a.getId()] < order[b.getId()];
+            });
+        }
     } catch (const std::exception& e) {
         std::cerr << "获取题目列表时发生异常: " << e.what() << std::endl;
     } catch (...) {
@@ -128,7 +166,7 @@ Problem ProblemService::getProblemById(int problem_id, bool with_testcases) {
         sql << "SELECT id, title, description, code_template, input_format, output_format, difficulty, "
             << "time_limit, memory_limit, example_input, example_output, hint, "
             << "created_by, created_at, updated_at, status "
-            << "FROM problems WHERE id = " << problem_id;
+            << "FROM problems WHERE id = " << problem_id << " AND status <> " << PROBLEM_STATUS_DELETING;
         
         std::cout << "准备执行查询: " << sql.str() << std::endl;
         MYSQL_RES* rawResult = db->executeQuery(sql.str());
@@ -193,6 +231,10 @@ Problem ProblemService::getProblemById(int problem_id, bool with_testcases) {
 
 // 创建题目
 bool ProblemService::createProblem(const Problem& problem, std::string& error_message) {
+    if (problem.getStatus() == PROBLEM_STATUS_DELETING) {
+        error_message = "无效的题目状态";
+        return false;
+    }
     Database* db = Database::getInstance();
     
     // 当前时间戳
@@ -218,13 +260,14 @@ bool ProblemService::createProblem(const Problem& problem, std::string& error_me
         << now << ", "
         << problem.getStatus() << ")";
     
-    if (!db->executeCommand(sql.str())) {
+    // 在执行插入的连接上读取新题目ID
+    unsigned long long insert_id = 0;
+    if (!db->executeInsert(sql.str(), insert_id)) {
         error_message = "创建题目失败";
         return false;
     }
     
-    // 获取新插入的题目ID
-    int problem_id = db->getLastInsertId();
+    int problem_id = static_cast<int>(insert_id);
     
     // 如果有测试用例，添加测试用例
     const std::vector<TestCase>& testcases = problem.getTestCases();
@@ -244,11 +287,19 @@ bool ProblemService::createProblem(const Problem& problem, std::string& error_me
         }
     }
     
+    ProblemSearchIndex::update(problem_id, problem.getTitle(), problem.getDescription());
+    ProblemCatalog::refresh(problem_id);
+    CacheVersion::bump(CacheVersion::PROBLEMS);
     return true;
 }
 
 // 更新题目
 bool ProblemService::updateProblem(const Problem& problem, std::string& error_message) {
+    // 删除中状态只由删除流程设置，更新时写入会让题目被当作正在删除
+    if (problem.getStatus() == PROBLEM_STATUS_DELETING) {
+        error_message = "无效的题目状态";
+        return false;
+    }
     Database* db = Database::getInstance();
     
     // 当前时间戳
@@ -269,128 +320,31 @@ bool ProblemService::updateProblem(const Problem& problem, std::string& error_me
         << "hint = '" << db->escapeString(problem.getHint()) << "', "
         << "updated_at = " << now << ", "
         << "status = " << problem.getStatus() << " "
-        << "WHERE id = " << problem.getId();
+        << "WHERE id = " << problem.getId() << " AND status <> " << PROBLEM_STATUS_DELETING;
     
     if (!db->executeCommand(sql.str())) {
         error_message = "更新题目失败";
         return false;
     }
     
+    ProblemSearchIndex::update(problem.getId(), problem.getTitle(), problem.getDescription());
+    ProblemCatalog::refresh(problem.getId());
+    CacheVersion::bump(CacheVersion::PROBLEMS);
     return true;
 }
 
 // 删除题目
 bool ProblemService::deleteProblem(int problem_id, std::string& error_message) {
-    Database* db = Database::getInstance();
-    
-    // 先检查题目是否存在
-    std::stringstream check_sql;
-    check_sql << "SELECT id FROM problems WHERE id = " << problem_id;
-    
-    MYSQL_RES* result = db->executeQuery(check_sql.str());
-    bool exists = result && mysql_num_rows(result) > 0;
-    
-    if (result) {
-        mysql_free_result(result);
-    }
-    
-    if (!exists) {
-        error_message = "题目不存在";
-        return false;
-    }
-    
-    std::cout << "开始删除题目 ID: " << problem_id << std::endl;
-    
-    // 开始事务
-    if (!db->executeCommand("START TRANSACTION")) {
-        error_message = "无法开始事务";
-        std::cout << "开始事务失败" << std::endl;
+    // 题目标记为删除中后立即对外不可见，提交记录、讨论、测试用例等由后台分批删除
+    if (!ProblemDeletion::schedule(problem_id, error_message)) {
         return false;
     }
     
-    bool success = true;
-    
-    // 1. 先删除与题目相关的讨论回复
-    std::stringstream discussion_replies_sql;
-    discussion_replies_sql << "DELETE dr FROM discussion_replies dr "
-                           << "INNER JOIN discussions d ON dr.discussion_id = d.id "
-                           << "WHERE d.problem_id = " << problem_id;
-    
-    std::cout << "删除讨论回复: " << discussion_replies_sql.str() << std::endl;
-    if (!db->executeCommand(discussion_replies_sql.str())) {
-        std::cout << "删除讨论回复失败" << std::endl;
-        success = false;
-    }
-    
-    // 2. 删除与题目相关的讨论
-    std::stringstream discussions_sql;
-    discussions_sql << "DELETE FROM discussions WHERE problem_id = " << problem_id;
-    
-    std::cout << "删除讨论: " << discussions_sql.str() << std::endl;
-    if (!db->executeCommand(discussions_sql.str())) {
-        std::cout << "删除讨论失败" << std::endl;
-        success = false;
-    }
-    
-    // 3. 删除与题目相关的测试点结果
-    std::stringstream test_results_sql;
-    test_results_sql << "DELETE tpr FROM test_point_results tpr "
-                     << "INNER JOIN submissions s ON tpr.submission_id = s.id "
-                     << "WHERE s.problem_id = " << problem_id;
-    
-    std::cout << "删除测试点结果: " << test_results_sql.str() << std::endl;
-    if (!db->executeCommand(test_results_sql.str())) {
-        std::cout << "删除测试点结果失败" << std::endl;
-        success = false;
-    }
-    
-    // 4. 删除与题目相关的提交记录
-    std::stringstream submissions_sql;
-    submissions_sql << "DELETE FROM submissions WHERE problem_id = " << problem_id;
-    
-    std::cout << "删除提交记录: " << submissions_sql.str() << std::endl;
-    if (!db->executeCommand(submissions_sql.str())) {
-        std::cout << "删除提交记录失败" << std::endl;
-        success = false;
-    }
-    
-    // 5. 删除测试用例
-    std::stringstream tc_sql;
-    tc_sql << "DELETE FROM testcases WHERE problem_id = " << problem_id;
-    
-    std::cout << "删除测试用例: " << tc_sql.str() << std::endl;
-    if (!db->executeCommand(tc_sql.str())) {
-        std::cout << "删除测试用例失败" << std::endl;
-        success = false;
-    }
-    
-    // 6. 最后删除题目
-    std::stringstream sql;
-    sql << "DELETE FROM problems WHERE id = " << problem_id;
-    
-    std::cout << "删除题目: " << sql.str() << std::endl;
-    if (!db->executeCommand(sql.str())) {
-        std::cout << "删除题目失败" << std::endl;
-        success = false;
-    }
-    
-    // 如果所有操作都成功，提交事务；否则回滚
-    if (success) {
-        std::cout << "所有删除操作成功，提交事务" << std::endl;
-        if (!db->executeCommand("COMMIT")) {
-            error_message = "无法提交事务";
-            std::cout << "提交事务失败" << std::endl;
-            db->executeCommand("ROLLBACK");
-            return false;
-        }
-        std::cout << "成功删除题目 ID: " << problem_id << std::endl;
-        return true;
-    } else {
-        std::cout << "删除过程中出现错误，回滚事务" << std::endl;
-        db->executeCommand("ROLLBACK");
-        error_message = "删除题目失败，已回滚所有操作";
-        return false;
-    }
+    ProblemSearchIndex::remove(problem_id);
+    ProblemCatalog::remove(problem_id);
+    ProblemStats::remove(problem_id);
+    CacheVersion::bump(CacheVersion::PROBLEMS);
+    return true;
 }
 
 // 添加测试用例
@@ -413,12 +367,14 @@ bool ProblemService::addTestCase(int problem_id, const TestCase& testcase, std::
         return false;
     }
     
+    touchProblemUpdatedAt(problem_id);
     return true;
 }
 
 // 更新测试用例
 bool ProblemService::updateTestCase(const TestCase& testcase, std::string& error_message) {
     Database* db = Database::getInstance();
+    int problem_id = getProblemIdByTestCaseId(testcase.id);
     
     std::stringstream sql;
     sql << "UPDATE testcases SET "
@@ -432,12 +388,14 @@ bool ProblemService::updateTestCase(const TestCase& testcase, std::string& error
         return false;
     }
     
+    touchProblemUpdatedAt(problem_id);
     return true;
 }
 
 // 删除测试用例
 bool ProblemService::deleteTestCase(int testcase_id, std::string& error_message) {
     Database* db = Database::getInstance();
+    int problem_id = getProblemIdByTestCaseId(testcase_id);
     
     std::stringstream sql;
     sql << "DELETE FROM testcases WHERE id = " << testcase_id;
@@ -447,6 +405,7 @@ bool ProblemService::deleteTestCase(int testcase_id, std::string& error_message)
         return false;
     }
     
+    touchProblemUpdatedAt(problem_id);
     return true;
 }
 
@@ -540,11 +499,18 @@ int ProblemService::countProblems(const std::string& search) {
     Database* db = Database::getInstance();
     
     try {
+        // 有搜索词时直接使用检索索引的命中数
+        std::vector<int> search_ids;
+        if (!search.empty() && ProblemSearchIndex::search(search, 0, 0, search_ids, count)) {
+            return count;
+        }
+        
         std::stringstream sql;
-        sql << "SELECT COUNT(*) FROM problems WHERE 1=1 ";
+        sql << "SELECT COUNT(*) FROM problems WHERE status <> " << PROBLEM_STATUS_DELETING << " ";
         
         if (!search.empty()) {
-            sql << "AND (title LIKE '%" << search << "%' OR description LIKE '%" << search << "%') ";
+            std::string escaped_search = db->escapeString(search);
+            sql << "AND (title LIKE '%" << escaped_search << "%' OR description LIKE '%" << escaped_search << "%') ";
         }
         
         MYSQL_RES* rawResult = db->executeQuery(sql.str());
@@ -602,4 +568,55 @@ bool ProblemService::checkProblemPermission(int problem_id, int user_id, int use
     
     mysql_free_result(result);
     return has_permission;
+}
+
+// 获取题目的最后更新时间（题目不存在时返回-1）
+int64_t ProblemService::getProblemUpdatedAt(int problem_id) {
+    Database* db = Database::getInstance();
+    
+    std::stringstream sql;
+    sql << "SELECT updated_at FROM problems WHERE id = " << problem_id << " AND status <> " << PROBLEM_STATUS_DELETING;
+    
+    MySQLResultWrapper result(db->executeQuery(sql.str()));
+    if (!result.isValid()) {
+        return -1;
+    }
+    
+    MYSQL_ROW row = result.fetchRow();
+    if (!row || !row[0]) {
+        return -1;
+    }
+    
+    try {
+        return std::stoll(row[0]);
+    } catch (const std::exception& e) {
+        return -1;
+    }
+}
+
+// 获取测试用例所属的题目ID（不存在时返回0）
+int ProblemService::getProblemIdByTestCaseId(int testcase_id) {
+    Database* db = Database::getInstance();
+    
+    std::stringstream sql;
+    sql << "SELECT problem_id FROM testcases WHERE id = " << testcase_id;
+    
+    MySQLResultWrapper result(db->executeQuery(sql.str()));
+    MYSQL_ROW row = result.fetchRow();
+    if (!row || !row[0]) {
+        return 0;
+    }
+    
+    return std::atoi(row[0]);
+}
+
+// 测试用例变化时刷新题目的更新时间，使题目详情的ETag失效
+void ProblemService::touchProblemUpdatedAt(int problem_id) {
+    if (problem_id > 0) {
+        std::stringstream sql;
+        sql << "UPDATE problems SET updated_at = " << std::time(nullptr) << " WHERE id = " << problem_id;
+        Database::getInstance()->executeCommand(sql.str());
+        ProblemCatalog::refresh(problem_id);
+    }
+    CacheVersion::bump(CacheVersion::PROBLEMS);
 } 
\ No newline at end of file
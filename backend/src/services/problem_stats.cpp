@@ -0,0 +1,355 @@
+#include "../../include/services/problem_stats.h"
+#include "../../include/database/database.h"
+#include "../../include/utils/periodic_flusher.h"
+#include "../../include/utils/cache_version.h"
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <iostream>
+#include <unordered_map>
+#include <mysql/mysql.h>
+
+namespace {
+    // problem_stats 表中各评测结果的列，顺序与 verdict_counts 一致
+    const char* VERDICT_COLUMNS[PROBLEM_VERDICT_KINDS] = {
+        "accepted_count", "wrong_answer_count", "time_limit_count", "memory_limit_count",
+        "runtime_error_count", "compile_error_count", "system_error_count"
+    };
+
+    // verdict_counts 在JSON中的键
+    const char* VERDICT_KEYS[PROBLEM_VERDICT_KINDS] = {
+        "accepted", "wrong_answer", "time_limit_exceeded", "memory_limit_exceeded",
+        "runtime_error", "compile_error", "system_error"
+    };
+
+    // problem_stats 表的副本及其缓存版本，和待写回的增量
+    std::mutex stats_mutex;
+    std::unordered_map<int, ProblemStatsItem> totals;
+    uint64_t totals_version = 0;
+    std::unordered_map<int, ProblemStatsItem> pending;
+
+    std::atomic<bool> started(false);
+
+    // 表为空但回填失败时为true：此时不写回增量（保持表为空），由写回线程重试回填
+    std::atomic<bool> backfill_needed(false);
+    // 副本载入失败时为true，由写回线程重新载入
+    std::atomic<bool> reload_needed(false);
+    PeriodicFlusher flusher(PROBLEM_STATS_FLUSH_INTERVAL_MS, &ProblemStats::flush);
+
+    // 同一时间只允许一次写回；删除题目时也持有，避免写回把已删除的行重新插入
+    std::mutex flush_mutex;
+
+    // 读取 problem_stats 表和对应的缓存版本，查询失败时返回false
+    // 两者在同一条语句中读取，版本号与统计来自同一个一致性读快照；表为空时仍返回版本号所在的一行
+    bool loadTable(std::unordered_map<int, ProblemStatsItem>& loaded, uint64_t& version) {
+        std::stringstream sql;
+        sql << "SELECT v.version, p.problem_id, p.submission_count, p.solver_count";
+        for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+            sql << ", p." << VERDICT_COLUMNS[i];
+        }
+        sql << " FROM (SELECT IFNULL(MAX(version), 0) AS version FROM cache_versions WHERE scope = "
+            << static_cast<int>(CacheVersion::PROBLEM_STATS) << ") v LEFT JOIN problem_stats p ON 1 = 1";
+
+        MYSQL_RES* result = Database::getInstance()->executeQuery(sql.str());
+        if (!result) {
+            return false;
+        }
+        version = 0;
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(result))) {
+            version = row[0] ? std::strtoull(row[0], nullptr, 10) : 0;
+            if (!row[1]) {
+                continue;
+            }
+            ProblemStatsItem& item = loaded[std::atoi(row[1])];
+            item.submission_count = row[2] ? std::atoi(row[2]) : 0;
+            item.solver_count = row[3] ? std::atoi(row[3]) : 0;
+            for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+                item.verdict_counts[i] = row[4 + i] ? std::atoi(row[4 + i]) : 0;
+            }
+        }
+        mysql_free_result(result);
+        return true;
+    }
+
+    // 以载入的数据替换内存中的副本
+    void installTotals(std::unordered_map<int, ProblemStatsItem>& loaded, uint64_t version) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        totals.swap(loaded);
+        totals_version = version;
+    }
+
+    // 重新载入 problem_stats 表，失败时保留原来的副本
+    bool reloadTotals() {
+        std::unordered_map<int, ProblemStatsItem> loaded;
+        uint64_t version = 0;
+        if (!loadTable(loaded, version)) {
+            reload_needed = true;
+            return false;
+        }
+        reload_needed = false;
+        installTotals(loaded, version);
+        return true;
+    }
+
+    // 累加到 problem_stats 表的语句，行不存在时插入
+    std::string upsertSql(const std::vector<std::pair<int, ProblemStatsItem>>& deltas) {
+        int64_t now = std::time(nullptr);
+        std::stringstream sql;
+        sql << "INSERT INTO problem_stats (problem_id, submission_count, solver_count";
+        for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+            sql << ", " << VERDICT_COLUMNS[i];
+        }
+        sql << ", updated_at) VALUES ";
+        for (size_t i = 0; i < deltas.size(); i++) {
+            const ProblemStatsItem& item = deltas[i].second;
+            sql << (i > 0 ? ", (" : "(") << deltas[i].first << ", " << item.submission_count << ", " << item.solver_count;
+            for (int j = 0; j < PROBLEM_VERDICT_KINDS; j++) {
+                sql << ", " << item.verdict_counts[j];
+            }
+            sql << ", " << now << ")";
+        }
+        sql << " ON DUPLICATE KEY UPDATE submission_count = submission_count + VALUES(submission_count), "
+            << "solver_count = solver_count + VALUES(solver_count)";
+        for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+            sql << ", " << VERDICT_COLUMNS[i] << " = " << VERDICT_COLUMNS[i] << " + VALUES(" << VERDICT_COLUMNS[i] << ")";
+        }
+        sql << ", updated_at = VALUES(updated_at)";
+        return sql.str();
+    }
+}
+
+void ProblemStatsItem::add(const ProblemStatsItem& other) {
+    submission_count += other.submission_count;
+    solver_count += other.solver_count;
+    for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+        verdict_counts[i] += other.verdict_counts[i];
+    }
+}
+
+void ProblemStatsItem::subtract(const ProblemStatsItem& other) {
+    submission_count -= other.submission_count;
+    solver_count -= other.solver_count;
+    for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+        verdict_counts[i] -= other.verdict_counts[i];
+    }
+}
+
+void ProblemStatsItem::writeJson(Json::Value& json, bool with_verdicts) const {
+    json["submission_count"] = submission_count;
+    json["accepted_count"] = acceptedCount();
+    json["solver_count"] = solver_count;
+
+    char rate[16];
+    std::snprintf(rate, sizeof(rate), "%.1f%%",
+                  submission_count > 0 ? acceptedCount() * 100.0 / submission_count : 0.0);
+    json["acceptance_rate"] = rate;
+
+    if (with_verdicts) {
+        Json::Value verdicts(Json::objectValue);
+        for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+            verdicts[VERDICT_KEYS[i]] = verdict_counts[i];
+        }
+        json["verdict_counts"] = verdicts;
+    }
+}
+
+void ProblemStats::start() {
+    if (started.exchange(true)) {
+        return;
+    }
+
+    std::unordered_map<int, ProblemStatsItem> loaded;
+    uint64_t version = 0;
+    if (!loadTable(loaded, version)) {
+        std::cerr << "载入题目统计失败，由写回线程重新载入" << std::endl;
+        reload_needed = true;
+    } else if (loaded.empty()) {
+        if (backfill()) {
+            loadTable(loaded, version);
+        } else {
+            backfill_needed = true;
+        }
+    }
+
+    size_t problem_count = loaded.size();
+    installTotals(loaded, version);
+    std::cout << "题目统计已载入，题目数: " << problem_count << std::endl;
+
+    flusher.start();
+    std::cout << "题目统计写回线程已启动，间隔: " << PROBLEM_STATS_FLUSH_INTERVAL_MS << "ms" << std::endl;
+}
+
+void ProblemStats::stop() {
+    if (!started.exchange(false) || !flusher.stop()) {
+        return;
+    }
+    std::cout << "题目统计写回线程已停止" << std::endl;
+}
+
+void ProblemStats::recordVerdict(int problem_id, JudgeResult result, bool first_solve) {
+    int verdict = static_cast<int>(result) - static_cast<int>(JudgeResult::ACCEPTED);
+    if (problem_id <= 0 || verdict < 0 || verdict >= PROBLEM_VERDICT_KINDS) {
+        return;
+    }
+
+    ProblemStatsItem delta;
+    delta.submission_count = 1;
+    delta.solver_count = first_solve ? 1 : 0;
+    delta.verdict_counts[verdict] = 1;
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    pending[problem_id].add(delta);
+}
+
+ProblemStatsItem ProblemStats::get(int problem_id, uint64_t& version) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    version = totals_version;
+    auto it = totals.find(problem_id);
+    return it != totals.end() ? it->second : ProblemStatsItem();
+}
+
+uint64_t ProblemStats::get(const std::vector<int>& problem_ids, std::vector<ProblemStatsItem>& stats) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.clear();
+    for (int problem_id : problem_ids) {
+        auto it = totals.find(problem_id);
+        stats.push_back(it != totals.end() ? it->second : ProblemStatsItem());
+    }
+    return totals_version;
+}
+
+void ProblemStats::remove(int problem_id) {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        totals.erase(problem_id);
+        pending.erase(problem_id);
+    }
+    Database::getInstance()->executeCommand("DELETE FROM problem_stats WHERE problem_id = " +
+                                            std::to_string(problem_id));
+}
+
+void ProblemStats::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+
+    // 回填成功前表保持为空，回填会把这期间的评测结果一并统计进去
+    if (backfill_needed) {
+        if (!backfill()) {
+            return;
+        }
+        backfill_needed = false;
+        reloadTotals();
+    }
+
+    std::unordered_map<int, ProblemStatsItem> deltas;
+    uint64_t loaded_version = 0;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        deltas.swap(pending);
+        loaded_version = totals_version;
+    }
+
+    typedef std::vector<std::pair<int, ProblemStatsItem>> Batch;
+    bool written = flushInBatches<Batch>(deltas, PROBLEM_STATS_FLUSH_BATCH, &ProblemStats::persistDeltas,
+                                         [](const Batch& batch) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        for (const auto& item : batch) {
+            pending[item.first].add(item.second);
+        }
+    });
+
+    // 本实例或其他实例写回后重新载入副本，列表和详情的统计与ETag随之更新
+    if (written || reload_needed || CacheVersion::get(CacheVersion::PROBLEM_STATS) != loaded_version) {
+        reloadTotals();
+    }
+}
+
+bool ProblemStats::backfill() {
+    // 聚合前已记录的评测结果都已写入提交记录，会被下面的聚合统计；先取下这部分增量，
+    // 聚合成功后只扣除它们，聚合期间新记录的评测结果留待写回
+    std::unordered_map<int, ProblemStatsItem> covered;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        covered = pending;
+    }
+
+    std::stringstream sql;
+    sql << "SELECT problem_id, COUNT(*), COUNT(DISTINCT CASE WHEN result = "
+        << static_cast<int>(JudgeResult::ACCEPTED) << " THEN user_id ELSE NULL END)";
+    for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+        sql << ", SUM(result = " << static_cast<int>(JudgeResult::ACCEPTED) + i << ")";
+    }
+    sql << " FROM submissions WHERE result BETWEEN " << static_cast<int>(JudgeResult::ACCEPTED)
+        << " AND " << static_cast<int>(JudgeResult::SYSTEM_ERROR) << " GROUP BY problem_id";
+
+    MYSQL_RES* result = Database::getInstance()->executeQuery(sql.str());
+    if (!result) {
+        std::cerr << "回填题目统计失败，数据库错误" << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<int, ProblemStatsItem>> rows;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (!row[0]) {
+            continue;
+        }
+        ProblemStatsItem item;
+        item.submission_count = row[1] ? std::atoi(row[1]) : 0;
+        item.solver_count = row[2] ? std::atoi(row[2]) : 0;
+        for (int i = 0; i < PROBLEM_VERDICT_KINDS; i++) {
+            item.verdict_counts[i] = row[3 + i] ? std::atoi(row[3 + i]) : 0;
+        }
+        rows.push_back(std::make_pair(std::atoi(row[0]), item));
+    }
+    mysql_free_result(result);
+
+    // 所有批次在一个事务中写入，失败时表保持为空，下次回填从头开始
+    std::vector<std::string> commands;
+    commands.push_back(CacheVersion::bumpStatement(CacheVersion::PROBLEM_STATS));
+    std::vector<std::pair<int, ProblemStatsItem>> batch;
+    for (size_t i = 0; i < rows.size(); i++) {
+        batch.push_back(rows[i]);
+        if (batch.size() < PROBLEM_STATS_FLUSH_BATCH && i + 1 < rows.size()) {
+            continue;
+        }
+        commands.push_back(upsertSql(batch));
+        batch.clear();
+    }
+    unsigned long long affected_rows = 0;
+    if (!Database::getInstance()->executeTransaction(commands, affected_rows)) {
+        std::cerr << "回填题目统计失败，写入 problem_stats 出错" << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        for (const auto& item : covered) {
+            auto it = pending.find(item.first);
+            if (it == pending.end()) {
+                continue;
+            }
+            it->second.subtract(item.second);
+            if (it->second.submission_count <= 0) {
+                pending.erase(it);
+            }
+        }
+    }
+
+    std::cout << "已从提交记录回填题目统计，题目数: " << rows.size() << std::endl;
+    return true;
+}
+
+bool ProblemStats::persistDeltas(const std::vector<std::pair<int, ProblemStatsItem>>& deltas) {
+    if (deltas.empty()) {
+        return true;
+    }
+    std::vector<std::string> commands;
+    commands.push_back(upsertSql(deltas));
+    commands.push_back(CacheVersion::bumpStatement(CacheVersion::PROBLEM_STATS));
+    unsigned long long affected_rows = 0;
+    return Database::getInstance()->executeTransaction(commands, affected_rows);
+}
\ No newline at end of file
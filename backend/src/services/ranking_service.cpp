@@ -0,0 +1,825 @@
+#include "../../include/services/ranking_service.h"
+#include "../../include/database/database.h"
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <mysql/mysql.h>
+
+namespace {
+    // 排序键：解题数降序，通过率降序，提交数升序，用户ID升序
+    struct RankKey {
+        int solved_count;
+        float acceptance_rate;
+        int total_submissions;
+        int user_id;
+
+        bool operator<(const RankKey& other) const {
+            if (solved_count != other.solved_count) return solved_count > other.solved_count;
+            if (acceptance_rate != other.acceptance_rate) return acceptance_rate > other.acceptance_rate;
+            if (total_submissions != other.total_submissions) return total_submissions < other.total_submissions;
+            return user_id < other.user_id;
+        }
+
+        bool operator==(const RankKey& other) const {
+            return !(*this < other) && !(other < *this);
+        }
+    };
+
+    RankKey keyOf(const UserRankingItem& item) {
+        RankKey key = {item.solved_count, item.acceptance_rate, item.total_submissions, item.user_id};
+        return key;
+    }
+
+    // 顺序统计树：按随机优先级保持平衡的二叉搜索树（treap），每个节点记录子树大小
+    struct Node {
+        RankKey key;
+        unsigned priority;
+        int size;
+        Node* left;
+        Node* right;
+    };
+
+    std::mt19937 priority_generator(std::random_device{}());
+
+    int sizeOf(Node* node) {
+        return node ? node->size : 0;
+    }
+
+    void updateSize(Node* node) {
+        node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+    }
+
+    // 拆分为小于 key 和不小于 key 的两棵树
+    void split(Node* node, const RankKey& key, Node*& left, Node*& right) {
+        if (!node) {
+            left = right = nullptr;
+            return;
+        }
+        if (node->key < key) {
+            split(node->right, key, node->right, right);
+            left = node;
+        } else {
+            split(node->left, key, left, node->left);
+            right = node;
+        }
+        updateSize(node);
+    }
+
+    Node* merge(Node* left, Node* right) {
+        if (!left || !right) {
+            return left ? left : right;
+        }
+        if (left->priority > right->priority) {
+            left->right = merge(left->right, right);
+            updateSize(left);
+            return left;
+        }
+        right->left = merge(left, right->left);
+        updateSize(right);
+        return right;
+    }
+
+    Node* insertKey(Node* root, const RankKey& key) {
+        Node* node = new Node{key, static_cast<unsigned>(priority_generator()), 1, nullptr, nullptr};
+        Node* left = nullptr;
+        Node* right = nullptr;
+        split(root, key, left, right);
+        return merge(merge(left, node), right);
+    }
+
+    Node* eraseKey(Node* node, const RankKey& key) {
+        if (!node) {
+            return nullptr;
+        }
+        if (node->key == key) {
+            Node* merged = merge(node->left, node->right);
+            delete node;
+            return merged;
+        }
+        if (key < node->key) {
+            node->left = eraseKey(node->left, key);
+        } else {
+            node->right = eraseKey(node->right, key);
+        }
+        updateSize(node);
+        return node;
+    }
+
+    // 小于 key 的节点数
+    int countLess(Node* node, const RankKey& key) {
+        int count = 0;
+        while (node) {
+            if (node->key < key) {
+                count += sizeOf(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return count;
+    }
+
+    // 第 index 个节点（从0开始）
+    Node* nodeAt(Node* node, int index) {
+        while (node) {
+            int left_size = sizeOf(node->left);
+            if (index < left_size) {
+                node = node->left;
+            } else if (index == left_size) {
+                return node;
+            } else {
+                index -= left_size + 1;
+                node = node->right;
+            }
+        }
+        return nullptr;
+    }
+
+    void destroy(Node* node) {
+        if (node) {
+            destroy(node->left);
+            destroy(node->right);
+            delete node;
+        }
+    }
+
+    // 排名状态
+    std::mutex state_mutex;
+    Node* root = nullptr;
+    std::unordered_map<int, UserRankingItem> items;
+    int active_users = 0;
+
+    std::mutex update_locks[RANKING_UPDATE_LOCKS];
+
+    // 以下函数调用方持有 state_mutex
+    void removeItem(int user_id) {
+        auto it = items.find(user_id);
+        if (it == items.end()) {
+            return;
+        }
+        root = eraseKey(root, keyOf(it->second));
+        if (it->second.total_submissions > 0) {
+            active_users--;
+        }
+        items.erase(it);
+    }
+
+    void putItem(const UserRankingItem& item) {
+        removeItem(item.user_id);
+        items[item.user_id] = item;
+        root = insertKey(root, keyOf(item));
+        if (item.total_submissions > 0) {
+            active_users++;
+        }
+    }
+
+    void replaceAll(const std::vector<UserRankingItem>& new_items) {
+        destroy(root);
+        root = nullptr;
+        items.clear();
+        active_users = 0;
+        for (const auto& item : new_items) {
+            putItem(item);
+        }
+    }
+
+    // 统计列：用户ID、解题数、尝试题目数、提交数、简单/中等/困难解题数、最后提交时间
+    const std::string STATS_COLUMNS =
+        "u.id, "
+        "COUNT(DISTINCT CASE WHEN s.result = 2 THEN s.problem_id ELSE NULL END), "
+        "COUNT(DISTINCT s.problem_id), "
+        "COUNT(s.id), "
+        "COUNT(DISTINCT CASE WHEN s.result = 2 AND p.difficulty = '简单' THEN s.problem_id ELSE NULL END), "
+        "COUNT(DISTINCT CASE WHEN s.result = 2 AND p.difficulty = '中等' THEN s.problem_id ELSE NULL END), "
+        "COUNT(DISTINCT CASE WHEN s.result = 2 AND p.difficulty = '困难' THEN s.problem_id ELSE NULL END), "
+        "IFNULL(MAX(s.created_at), 0)";
+
+    const std::string STATS_FROM =
+        " FROM users u "
+        "LEFT JOIN submissions s ON s.user_id = u.id "
+        "LEFT JOIN problems p ON p.id = s.problem_id "
+        "WHERE u.role < 2"; // 排除管理员
+
+    // 按 STATS_COLUMNS 的列顺序解析一行，分数和通过率由计数推出
+    UserRankingItem itemFromRow(MYSQL_ROW row) {
+        UserRankingItem item;
+        item.user_id = row[0] ? std::stoi(row[0]) : 0;
+        item.solved_count = row[1] ? std::stoi(row[1]) : 0;
+        item.attempted_count = row[2] ? std::stoi(row[2]) : 0;
+        item.total_submissions = row[3] ? std::stoi(row[3]) : 0;
+        item.easy_count = row[4] ? std::stoi(row[4]) : 0;
+        item.medium_count = row[5] ? std::stoi(row[5]) : 0;
+        item.hard_count = row[6] ? std::stoi(row[6]) : 0;
+        item.last_submission = row[7] ? std::stoll(row[7]) : 0;
+
+        // 简单题10分，中等题20分，困难题30分
+        item.score = item.easy_count * 10 + item.medium_count * 20 + item.hard_count * 30;
+        // 保留两位小数
+        item.acceptance_rate = item.attempted_count > 0
+            ? static_cast<float>(std::round(item.solved_count * 10000.0 / item.attempted_count) / 100.0)
+            : 0.0f;
+        return item;
+    }
+
+    // init_markers 中的标记：对应的表已从提交记录完整建立，之后只做增量维护
+    const char* MARKER_RANKINGS = "user_rankings";
+    const char* MARKER_PROBLEM_STATUS = "user_problem_status";
+    const char* MARKER_DAILY_STATS = "user_daily_stats";
+
+    // 查询标记是否存在，查询失败时返回false
+    bool markerExists(const char* name, bool& exists) {
+        MYSQL_RES* res = Database::getInstance()->executeQuery(
+            "SELECT 1 FROM init_markers WHERE name = '" + std::string(name) + "'");
+        if (!res) {
+            return false;
+        }
+        exists = mysql_num_rows(res) > 0;
+        mysql_free_result(res);
+        return true;
+    }
+
+    std::string markerStatement(const char* name) {
+        return "INSERT IGNORE INTO init_markers (name, created_at) VALUES ('" + std::string(name) + "', " +
+               std::to_string(std::time(nullptr)) + ")";
+    }
+
+    // 一批提交对用户或某日分桶的贡献
+    struct StatsContribution {
+        int submissions = 0;
+        int accepted = 0;
+        int solved = 0;
+        int easy = 0;
+        int medium = 0;
+        int hard = 0;
+        int score = 0;
+    };
+
+    // 计数列减去 amount，不低于0
+    void appendDecrement(std::string& sets, const char* column, int amount) {
+        if (amount == 0) {
+            return;
+        }
+        if (!sets.empty()) sets += ", ";
+        sets += std::string(column) + " = GREATEST(" + column + " - " + std::to_string(amount) + ", 0)";
+    }
+
+    // 本地时间的日期键，如 20240615
+    int dayKey(std::time_t t) {
+        std::tm local;
+        localtime_r(&t, &local);
+        return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+    }
+
+    // 时间段起始日的零点，周从周日开始（与 MySQL 的 YEARWEEK 默认模式一致），无效的时间段返回-1
+    std::time_t windowStart(const std::string& time_range, std::time_t now) {
+        std::tm local;
+        localtime_r(&now, &local);
+        if (time_range == "week") {
+            local.tm_mday -= local.tm_wday;
+        } else if (time_range == "month") {
+            local.tm_mday = 1;
+        } else if (time_range != "day") {
+            return -1;
+        }
+        local.tm_hour = 0;
+        local.tm_min = 0;
+        local.tm_sec = 0;
+        local.tm_isdst = -1;
+        return std::mktime(&local);
+    }
+
+    // 在SQL中按 dayKey() 的规则计算时间戳列的日期键，覆盖 start 所在日到 end 所在日
+    // 不使用 FROM_UNIXTIME：它按数据库会话的时区换算，可能与本进程的时区不同。
+    // 这里由本进程算出各日零点，INTERVAL() 返回时间戳之前的零点个数，再用 ELT() 取对应的日期键
+    std::string dayKeyExpression(const std::string& column, std::time_t start, std::time_t end) {
+        std::string boundaries;
+        std::string keys = std::to_string(dayKey(start));
+        std::tm local;
+        localtime_r(&start, &local);
+        for (;;) {
+            local.tm_mday += 1;
+            local.tm_hour = 0;
+            local.tm_min = 0;
+            local.tm_sec = 0;
+            local.tm_isdst = -1;
+            std::time_t midnight = std::mktime(&local);
+            if (midnight > end) {
+                break;
+            }
+            boundaries += ", " + std::to_string(midnight);
+            keys += ", " + std::to_string(dayKey(midnight));
+        }
+        if (boundaries.empty()) {
+            return keys;
+        }
+        return "ELT(INTERVAL(" + column + boundaries + ") + 1, " + keys + ")";
+    }
+
+    bool loadItems(const std::string& query, std::vector<UserRankingItem>& result) {
+        MYSQL_RES* res = Database::getInstance()->executeQuery(query);
+        if (!res) {
+            return false;
+        }
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(res))) {
+            result.push_back(itemFromRow(row));
+        }
+        mysql_free_result(res);
+        return true;
+    }
+}
+
+void RankingService::initialize() {
+    backfillProblemStatus();
+    backfillDailyStats();
+
+    // 只有完整重建过的排名表才可信：表中可能只有重建前个别用户写入的行
+    bool built = false;
+    std::vector<UserRankingItem> loaded;
+    if (markerExists(MARKER_RANKINGS, built) && built &&
+        loadItems("SELECT user_id, solved_count, attempted_count, total_submissions, "
+                  "easy_count, medium_count, hard_count, last_submission FROM user_rankings", loaded)) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        replaceAll(loaded);
+        std::cout << "排行榜已从排名表载入，用户数: " << loaded.size() << std::endl;
+        return;
+    }
+
+    std::cout << "排名表尚未建立，从提交记录重建排行榜" << std::endl;
+    if (refreshAllRankings()) {
+        Database::getInstance()->executeCommand(markerStatement(MARKER_RANKINGS));
+    }
+}
+
+std::vector<UserRankingItem> RankingService::getUserRankingList(int offset, int limit) {
+    if (offset < 0) offset = 0;
+    if (limit <= 0 || limit > RANKING_PAGE_LIMIT) limit = 10;
+
+    std::vector<UserRankingItem> page;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        for (int i = offset; i < offset + limit; i++) {
+            Node* node = nodeAt(root, i);
+            if (!node) {
+                break;
+            }
+            page.push_back(items[node->key.user_id]);
+        }
+    }
+
+    fillUserInfo(page);
+    return page;
+}
+
+UserRankingItem RankingService::getUserRanking(int user_id) {
+    std::vector<UserRankingItem> result(1);
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        auto it = items.find(user_id);
+        if (it == items.end()) {
+            return UserRankingItem();
+        }
+        result[0] = it->second;
+    }
+
+    fillUserInfo(result);
+    return result[0];
+}
+
+int RankingService::getUserRankingPosition(int user_id) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    auto it = items.find(user_id);
+    if (it == items.end()) {
+        return 0;
+    }
+    return countLess(root, keyOf(it->second)) + 1;
+}
+
+int RankingService::getRankedUserCount() {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    return sizeOf(root);
+}
+
+bool RankingService::updateUserRanking(int user_id) {
+    // 同一用户的统计与写入按顺序执行，避免较早的统计结果覆盖较新的
+    std::lock_guard<std::mutex> update_lock(update_locks[user_id % RANKING_UPDATE_LOCKS]);
+
+    UserRankingItem item;
+    bool ranked = false;
+    if (!loadUserStats(user_id, item, ranked)) {
+        std::cerr << "统计用户排名数据失败，用户ID: " << user_id << std::endl;
+        return false;
+    }
+
+    if (!ranked) {
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            removeItem(user_id);
+        }
+        return Database::getInstance()->executeCommand(
+            "DELETE FROM user_rankings WHERE user_id = " + std::to_string(user_id));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        putItem(item);
+    }
+    return updateRankingTable(std::vector<UserRankingItem>(1, item));
+}
+
+bool RankingService::refreshAllRankings() {
+    std::vector<UserRankingItem> all_items;
+    if (!loadItems("SELECT " + STATS_COLUMNS + STATS_FROM + " GROUP BY u.id", all_items)) {
+        std::cerr << "重建排行榜失败，数据库错误" << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        replaceAll(all_items);
+    }
+    std::cout << "排行榜已重建，用户数: " << all_items.size() << std::endl;
+
+    // 写入本次统计的结果后删除不再参与排名的用户
+    std::time_t refreshed_at = std::time(nullptr);
+    if (!updateRankingTable(all_items)) {
+        return false;
+    }
+    return Database::getInstance()->executeCommand(
+        "DELETE FROM user_rankings WHERE updated_at < " + std::to_string(refreshed_at));
+}
+
+bool RankingService::applyVerdict(int user_id, std::time_t submitted_at, bool accepted, const VerdictDelta& delta) {
+    int easy = 0, medium = 0, hard = 0;
+    if (delta.first_solve) {
+        easy = delta.difficulty == "简单" ? 1 : 0;
+        medium = delta.difficulty == "中等" ? 1 : 0;
+        hard = delta.difficulty == "困难" ? 1 : 0;
+    }
+    int score = easy * 10 + medium * 20 + hard * 30;
+
+    bool success = true;
+    bool ranked = false;
+    {
+        std::lock_guard<std::mutex> update_lock(update_locks[user_id % RANKING_UPDATE_LOCKS]);
+        UserRankingItem item;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            auto it = items.find(user_id);
+            if (it != items.end()) {
+                item = it->second;
+                item.total_submissions++;
+                item.attempted_count += delta.first_attempt ? 1 : 0;
+                item.solved_count += delta.first_solve ? 1 : 0;
+                item.easy_count += easy;
+                item.medium_count += medium;
+                item.hard_count += hard;
+                item.score += score;
+                item.acceptance_rate = item.attempted_count > 0
+                    ? static_cast<float>(std::round(item.solved_count * 10000.0 / item.attempted_count) / 100.0)
+                    : 0.0f;
+                item.last_submission = std::max(item.last_submission, submitted_at);
+                putItem(item);
+                ranked = true;
+            }
+        }
+
+        if (ranked) {
+            success = updateRankingTable(std::vector<UserRankingItem>(1, item));
+        }
+    }
+
+    // 不在排行榜中的用户（如管理员或尚未载入的用户）重新统计一次
+    if (!ranked || !success) {
+        success = updateUserRanking(user_id) && success;
+    }
+
+    std::string values = std::to_string(user_id) + ", " + std::to_string(dayKey(submitted_at)) + ", 1, " +
+                         (accepted ? "1" : "0") + ", " + (delta.first_solve ? "1" : "0") + ", " +
+                         std::to_string(easy) + ", " + std::to_string(medium) + ", " + std::to_string(hard) + ", " +
+                         std::to_string(score);
+    return Database::getInstance()->executeCommand(
+        "INSERT INTO user_daily_stats (user_id, day, submission_count, accepted_count, solved_count, "
+        "easy_count, medium_count, hard_count, score) VALUES (" + values + ") "
+        "ON DUPLICATE KEY UPDATE submission_count = submission_count + VALUES(submission_count), "
+        "accepted_count = accepted_count + VALUES(accepted_count), solved_count = solved_count + VALUES(solved_count), "
+        "easy_count = easy_count + VALUES(easy_count), medium_count = medium_count + VALUES(medium_count), "
+        "hard_count = hard_count + VALUES(hard_count), score = score + VALUES(score)") && success;
+}
+
+std::string RankingService::submissionRevocationQuery(const std::vector<int>& submission_ids) {
+    std::stringstream id_list;
+    for (size_t i = 0; i < submission_ids.size(); i++) {
+        id_list << (i > 0 ? "," : "") << submission_ids[i];
+    }
+
+    // 锁定这批提交和对应的题目状态，评测线程在删除提交的事务提交前不能再改变它们；
+    // 评测中的提交也一并锁定，结果由下面按 result 过滤。status.solved 为1表示首次通过尚未撤销
+    return "SELECT s.user_id, s.problem_id, s.created_at, s.result, p.difficulty, IFNULL(st.solved, 0) "
+           "FROM submissions s "
+           "LEFT JOIN problems p ON p.id = s.problem_id "
+           "LEFT JOIN user_problem_status st ON st.user_id = s.user_id AND st.problem_id = s.problem_id "
+           "WHERE s.id IN (" + (submission_ids.empty() ? std::string("0") : id_list.str()) + ") "
+           "ORDER BY s.id FOR UPDATE";
+}
+
+void RankingService::buildSubmissionRevocation(MYSQL_RES* result, std::vector<std::string>& commands,
+                                               std::vector<int>& user_ids) {
+    std::map<int, StatsContribution> by_user;
+    std::map<std::pair<int, int>, StatsContribution> by_day;
+    std::set<std::pair<int, int>> revoked_solves;  // （用户ID，题目ID）
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        // 只有已出结果的提交计入过统计
+        int verdict = row[3] ? std::atoi(row[3]) : 0;
+        if (verdict < 2) {
+            continue;
+        }
+        int user_id = row[0] ? std::atoi(row[0]) : 0;
+        int problem_id = row[1] ? std::atoi(row[1]) : 0;
+        std::time_t created_at = row[2] ? std::atoll(row[2]) : 0;
+        bool accepted = verdict == 2;
+        std::string difficulty = row[4] ? row[4] : "";
+        bool solved = row[5] && std::atoi(row[5]) != 0;
+
+        StatsContribution& user = by_user[user_id];
+        StatsContribution& day = by_day[std::make_pair(user_id, dayKey(created_at))];
+        user.submissions++;
+        day.submissions++;
+        day.accepted += accepted ? 1 : 0;
+
+        // 首次通过记在最早的通过提交上，与评测时的计入方式一致
+        if (accepted && solved && revoked_solves.insert(std::make_pair(user_id, problem_id)).second) {
+            int easy = difficulty == "简单" ? 1 : 0;
+            int medium = difficulty == "中等" ? 1 : 0;
+            int hard = difficulty == "困难" ? 1 : 0;
+            int score = easy * 10 + medium * 20 + hard * 30;
+            for (StatsContribution* item : {&user, &day}) {
+                item->solved++;
+                item->easy += easy;
+                item->medium += medium;
+                item->hard += hard;
+                item->score += score;
+            }
+        }
+    }
+
+    for (const auto& item : by_user) {
+        const StatsContribution& c = item.second;
+        std::string sets;
+        appendDecrement(sets, "submission_count", c.submissions);
+        appendDecrement(sets, "solved_count", c.solved);
+        appendDecrement(sets, "easy_count", c.easy);
+        appendDecrement(sets, "medium_count", c.medium);
+        appendDecrement(sets, "hard_count", c.hard);
+        appendDecrement(sets, "score", c.score);
+        commands.push_back("UPDATE users SET " + sets + " WHERE id = " + std::to_string(item.first));
+        user_ids.push_back(item.first);
+    }
+    for (const auto& item : by_day) {
+        const StatsContribution& c = item.second;
+        std::string sets;
+        appendDecrement(sets, "submission_count", c.submissions);
+        appendDecrement(sets, "accepted_count", c.accepted);
+        appendDecrement(sets, "solved_count", c.solved);
+        appendDecrement(sets, "easy_count", c.easy);
+        appendDecrement(sets, "medium_count", c.medium);
+        appendDecrement(sets, "hard_count", c.hard);
+        appendDecrement(sets, "score", c.score);
+        commands.push_back("UPDATE user_daily_stats SET " + sets + " WHERE day = " + std::to_string(item.first.second) +
+                           " AND user_id = " + std::to_string(item.first.first));
+    }
+    for (const auto& item : revoked_solves) {
+        commands.push_back("UPDATE user_problem_status SET solved = 0, solved_at = 0 WHERE user_id = " +
+                           std::to_string(item.first) + " AND problem_id = " + std::to_string(item.second));
+    }
+}
+
+bool RankingService::getWindowRankingList(const std::string& time_range, int offset, int limit,
+                                          std::vector<UserRankingItem>& items, int& total) {
+    std::time_t now = std::time(nullptr);
+    std::time_t start = windowStart(time_range, now);
+    if (start < 0) {
+        return false;
+    }
+    if (offset < 0) offset = 0;
+    if (limit <= 0 || limit > RANKING_PAGE_LIMIT) limit = 10;
+
+    // 主键 (day, user_id) 覆盖日期范围过滤，每个用户最多累加31个桶
+    std::string from = " FROM user_daily_stats b JOIN users u ON u.id = b.user_id AND u.role < 2 "
+                       "WHERE b.day BETWEEN " + std::to_string(dayKey(start)) + " AND " +
+                       std::to_string(dayKey(now));
+
+    Database* db = Database::getInstance();
+    MYSQL_RES* res = db->executeQuery("SELECT COUNT(DISTINCT b.user_id)" + from);
+    if (!res) {
+        return false;
+    }
+    MYSQL_ROW row = mysql_fetch_row(res);
+    total = row && row[0] ? std::stoi(row[0]) : 0;
+    mysql_free_result(res);
+
+    items.clear();
+    if (total == 0) {
+        return true;
+    }
+
+    res = db->executeQuery(
+        "SELECT b.user_id, SUM(b.solved_count) AS solved, SUM(b.submission_count) AS submissions, "
+        "SUM(b.easy_count), SUM(b.medium_count), SUM(b.hard_count), SUM(b.score), "
+        "ROUND(SUM(b.accepted_count) * 100.0 / SUM(b.submission_count), 2) AS rate" + from +
+        " GROUP BY b.user_id ORDER BY solved DESC, rate DESC, submissions ASC, b.user_id ASC"
+        " LIMIT " + std::to_string(limit) + " OFFSET " + std::to_string(offset));
+    if (!res) {
+        return false;
+    }
+    while ((row = mysql_fetch_row(res))) {
+        UserRankingItem item;
+        item.user_id = row[0] ? std::stoi(row[0]) : 0;
+        item.solved_count = row[1] ? std::stoi(row[1]) : 0;
+        item.total_submissions = row[2] ? std::stoi(row[2]) : 0;
+        item.easy_count = row[3] ? std::stoi(row[3]) : 0;
+        item.medium_count = row[4] ? std::stoi(row[4]) : 0;
+        item.hard_count = row[5] ? std::stoi(row[5]) : 0;
+        item.score = row[6] ? std::stoi(row[6]) : 0;
+        item.acceptance_rate = row[7] ? std::stof(row[7]) : 0.0f;
+        items.push_back(item);
+    }
+    mysql_free_result(res);
+
+    fillUserInfo(items);
+    return true;
+}
+
+std::map<std::string, int> RankingService::getRankingStats() {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    std::map<std::string, int> stats;
+    stats["total_users"] = sizeOf(root);
+    stats["active_users"] = active_users;
+    return stats;
+}
+
+bool RankingService::loadUserStats(int user_id, UserRankingItem& item, bool& ranked) {
+    std::vector<UserRankingItem> result;
+    if (!loadItems("SELECT " + STATS_COLUMNS + STATS_FROM + " AND u.id = " + std::to_string(user_id) +
+                   " GROUP BY u.id", result)) {
+        return false;
+    }
+    ranked = !result.empty();
+    if (ranked) {
+        item = result[0];
+    }
+    return true;
+}
+
+bool RankingService::updateRankingTable(const std::vector<UserRankingItem>& items) {
+    Database* db = Database::getInstance();
+    std::string now = std::to_string(std::time(nullptr));
+    bool success = true;
+
+    for (size_t start = 0; start < items.size(); start += RANKING_PERSIST_BATCH) {
+        std::string values;
+        for (size_t i = start; i < items.size() && i < start + RANKING_PERSIST_BATCH; i++) {
+            const UserRankingItem& item = items[i];
+            if (!values.empty()) {
+                values += ", ";
+            }
+            values += "(" + std::to_string(item.user_id) + ", " + std::to_string(item.solved_count) + ", " +
+                      std::to_string(item.attempted_count) + ", " + std::to_string(item.total_submissions) + ", " +
+                      std::to_string(item.easy_count) + ", " + std::to_string(item.medium_count) + ", " +
+                      std::to_string(item.hard_count) + ", " + std::to_string(item.score) + ", " +
+                      std::to_string(item.acceptance_rate) + ", " + std::to_string(item.last_submission) + ", " +
+                      now + ")";
+        }
+
+        std::string query =
+            "INSERT INTO user_rankings (user_id, solved_count, attempted_count, total_submissions, "
+            "easy_count, medium_count, hard_count, score, acceptance_rate, last_submission, updated_at) VALUES " +
+            values +
+            " ON DUPLICATE KEY UPDATE solved_count = VALUES(solved_count), attempted_count = VALUES(attempted_count), "
+            "total_submissions = VALUES(total_submissions), easy_count = VALUES(easy_count), "
+            "medium_count = VALUES(medium_count), hard_count = VALUES(hard_count), score = VALUES(score), "
+            "acceptance_rate = VALUES(acceptance_rate), last_submission = VALUES(last_submission), "
+            "updated_at = VALUES(updated_at)";
+
+        if (!db->executeCommand(query)) {
+            std::cerr << "写入排名表失败" << std::endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+void RankingService::fillUserInfo(std::vector<UserRankingItem>& items) {
+    if (items.empty()) {
+        return;
+    }
+
+    std::string ids;
+    for (const auto& item : items) {
+        if (!ids.empty()) {
+            ids += ",";
+        }
+        ids += std::to_string(item.user_id);
+    }
+
+    MYSQL_RES* res = Database::getInstance()->executeQuery(
+        "SELECT id, username, IFNULL(avatar, '') FROM users WHERE id IN (" + ids + ")");
+    if (!res) {
+        return;
+    }
+
+    std::unordered_map<int, std::pair<std::string, std::string>> users;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res))) {
+        if (row[0]) {
+            users[std::stoi(row[0])] = std::make_pair(row[1] ? row[1] : "", row[2] ? row[2] : "");
+        }
+    }
+    mysql_free_result(res);
+
+    for (auto& item : items) {
+        auto it = users.find(item.user_id);
+        if (it != users.end()) {
+            item.username = it->second.first;
+            item.avatar = it->second.second;
+        }
+    }
+}
+
+bool RankingService::backfillDailyStats() {
+    bool done = false;
+    if (!markerExists(MARKER_DAILY_STATS, done)) {
+        return false;
+    }
+    if (done) {
+        return true;
+    }
+
+    // 覆盖本周和本月中较早的一个起点；首次通过由每个（用户，题目）最早的通过提交确定
+    std::time_t now = std::time(nullptr);
+    std::time_t start = std::min(windowStart("week", now), windowStart("month", now));
+    std::string query =
+        "INSERT INTO user_daily_stats (user_id, day, submission_count, accepted_count, solved_count, "
+        "easy_count, medium_count, hard_count, score) "
+        "SELECT s.user_id, " + dayKeyExpression("s.created_at", start, now) + " AS day, "
+        "COUNT(*), SUM(s.result = 2), COUNT(f.id), "
+        "SUM(f.id IS NOT NULL AND p.difficulty = '简单'), "
+        "SUM(f.id IS NOT NULL AND p.difficulty = '中等'), "
+        "SUM(f.id IS NOT NULL AND p.difficulty = '困难'), "
+        "SUM(CASE WHEN f.id IS NULL THEN 0 WHEN p.difficulty = '简单' THEN 10 "
+        "WHEN p.difficulty = '中等' THEN 20 WHEN p.difficulty = '困难' THEN 30 ELSE 0 END) "
+        "FROM submissions s "
+        "LEFT JOIN (SELECT MIN(id) AS id FROM submissions WHERE result = 2 GROUP BY user_id, problem_id) f "
+        "ON f.id = s.id "
+        "LEFT JOIN problems p ON p.id = s.problem_id "
+        "WHERE s.result >= 2 AND s.created_at >= " + std::to_string(start) + // 只统计已出结果的提交
+        " GROUP BY s.user_id, day";
+
+    // 先清掉回填范围内已有的分桶（如升级前写入的），回填与标记在同一事务中完成
+    std::vector<std::string> commands;
+    commands.push_back("DELETE FROM user_daily_stats WHERE day >= " + std::to_string(dayKey(start)));
+    commands.push_back(query);
+    commands.push_back(markerStatement(MARKER_DAILY_STATS));
+    unsigned long long affected_rows = 0;
+    if (!Database::getInstance()->executeTransaction(commands, affected_rows)) {
+        std::cerr << "回填每日排名统计失败" << std::endl;
+        return false;
+    }
+    std::cout << "每日排名统计已从提交记录回填" << std::endl;
+    return true;
+}
+
+bool RankingService::backfillProblemStatus() {
+    bool done = false;
+    if (!markerExists(MARKER_PROBLEM_STATUS, done)) {
+        return false;
+    }
+    if (done) {
+        return true;
+    }
+
+    std::string query =
+        "INSERT INTO user_problem_status (user_id, problem_id, solved, solved_at) "
+        "SELECT user_id, problem_id, MAX(result = 2), IFNULL(MIN(CASE WHEN result = 2 THEN created_at END), 0) "
+        "FROM submissions GROUP BY user_id, problem_id";
+
+    // 按提交记录整表重建，已有的行（如升级前写入的）一并替换
+    std::vector<std::string> commands;
+    commands.push_back("DELETE FROM user_problem_status");
+    commands.push_back(query);
+    commands.push_back(markerStatement(MARKER_PROBLEM_STATUS));
+    unsigned long long affected_rows = 0;
+    if (!Database::getInstance()->executeTransaction(commands, affected_rows)) {
+        std::cerr << "回填用户题目状态失败" << std::endl;
+        return false;
+    }
+    std::cout << "用户题目状态已从提交记录回填" << std::endl;
+    return true;
+}
@@ -0,0 +1,123 @@
+#include "../../include/services/submission_events.h"
+#include "../../include/http/json_writer.h"
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <condition_variable>
+
+namespace {
+    // 单个提交的事件通道
+    struct EventChannel {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<SubmissionEvent> events;
+        bool finished = false;
+        std::time_t finished_at = 0;
+    };
+
+    std::mutex channels_mutex;
+    std::map<int, std::shared_ptr<EventChannel>> channels;
+    std::atomic<int> active_streams(0);
+    std::atomic<int> stream_limit(4);  // 默认8个工作线程的一半
+
+    std::shared_ptr<EventChannel> findChannel(int submission_id) {
+        std::lock_guard<std::mutex> lock(channels_mutex);
+        auto it = channels.find(submission_id);
+        return it != channels.end() ? it->second : nullptr;
+    }
+
+    // 清理评测结束超过保留时间的通道（调用方持有channels_mutex）
+    void sweepExpired() {
+        std::time_t now = std::time(nullptr);
+        for (auto it = channels.begin(); it != channels.end();) {
+            std::shared_ptr<EventChannel> channel = it->second;
+            bool expired = false;
+            {
+                std::lock_guard<std::mutex> lock(channel->mutex);
+                expired = channel->finished && now - channel->finished_at > SUBMISSION_EVENTS_RETAIN_SECONDS;
+            }
+            if (expired) {
+                it = channels.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void SubmissionEvents::open(int submission_id) {
+    std::lock_guard<std::mutex> lock(channels_mutex);
+    sweepExpired();
+    std::shared_ptr<EventChannel>& channel = channels[submission_id];
+    if (!channel) {
+        channel = std::make_shared<EventChannel>();
+    }
+}
+
+void SubmissionEvents::publish(int submission_id, const std::string& name, const Json::Value& data, bool final) {
+    std::shared_ptr<EventChannel> channel = findChannel(submission_id);
+    if (!channel) {
+        // 未登记的提交（如同步评测）没有订阅者，直接忽略
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (channel->finished) {
+            return;
+        }
+        SubmissionEvent event;
+        event.seq = channel->events.size() + 1;
+        event.name = name;
+        event.data = http::JsonWriter::toString(data);
+        channel->events.push_back(std::move(event));
+        if (final) {
+            channel->finished = true;
+            channel->finished_at = std::time(nullptr);
+        }
+    }
+    channel->cond.notify_all();
+}
+
+bool SubmissionEvents::isTracked(int submission_id) {
+    return findChannel(submission_id) != nullptr;
+}
+
+bool SubmissionEvents::waitEvents(int submission_id, size_t after_seq, int timeout_ms,
+                                  std::vector<SubmissionEvent>& events, bool& finished) {
+    std::shared_ptr<EventChannel> channel = findChannel(submission_id);
+    if (!channel) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(channel->mutex);
+    channel->cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&channel, after_seq]() {
+        return channel->events.size() > after_seq || channel->finished;
+    });
+
+    for (size_t i = after_seq; i < channel->events.size(); i++) {
+        events.push_back(channel->events[i]);
+    }
+    finished = channel->finished;
+    return true;
+}
+
+void SubmissionEvents::setStreamLimit(size_t worker_threads) {
+    stream_limit = std::max(1, static_cast<int>(worker_threads / SUBMISSION_STREAM_WORKER_SHARE));
+}
+
+bool SubmissionEvents::acquireStream() {
+    if (++active_streams > stream_limit) {
+        --active_streams;
+        return false;
+    }
+    return true;
+}
+
+void SubmissionEvents::releaseStream() {
+    --active_streams;
+}
@@ -3,25 +3,137 @@
 #include "../../include/models/submission.h"
 #include "../../include/models/submission_repository.h"
 #include "../../include/services/judge_engine.h"
+#include "../../include/services/warm_runner.h"
 #include "../../include/services/user_service.h"
+#include "../../include/services/ranking_service.h"
+#include "../../include/services/problem_stats.h"
+#include "../../include/services/submission_events.h"
 #include <iostream>
+#include <cstdlib>
+#include <sstream>
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <atomic>
 #include <condition_variable>
 #include <unistd.h>
 #include <mysql/mysql.h>
 #include <json/json.h>
 
+// 评测队列：提交请求只负责入队，评测线程在后台依次评测并通过事件中心推送进度
+namespace {
+    std::mutex judge_queue_mutex;
+    std::condition_variable judge_queue_cond;
+    std::queue<int> judge_queue;
+    std::vector<std::thread> judge_workers;
+    std::atomic<bool> judge_running(false);
+}
+
 // 线程管理接口实现
 void SubmissionService::ensureJudgeThreadRunning() {
-    // 不再需要启动评测线程
-    std::cout << "同步评测模式，无需启动评测线程" << std::endl;
+    if (judge_running.exchange(true)) {
+        return;
+    }
+    
+    for (int i = 0; i < JUDGE_WORKER_COUNT; i++) {
+        judge_workers.emplace_back([]() {
+            while (true) {
+                int submission_id = 0;
+                {
+                    std::unique_lock<std::mutex> lock(judge_queue_mutex);
+                    judge_queue_cond.wait(lock, []() { return !judge_running || !judge_queue.empty(); });
+                    if (!judge_running) {
+                        return;
+                    }
+                    submission_id = judge_queue.front();
+                    judge_queue.pop();
+                }
+                runJudge(submission_id);
+            }
+        });
+    }
+    std::cout << "评测线程已启动，线程数: " << JUDGE_WORKER_COUNT << std::endl;
+    
+    // 停止时队列中尚未评测的提交只保存在数据库中，启动后重新排队
+    requeueUnfinished();
+}
+
+void SubmissionService::requeueUnfinished() {
+    std::stringstream sql;
+    sql << "SELECT id FROM submissions WHERE result IN (" << static_cast<int>(JudgeResult::PENDING) << ", "
+        << static_cast<int>(JudgeResult::JUDGING) << ") ORDER BY id";
+    MYSQL_RES* result = Database::getInstance()->executeQuery(sql.str());
+    if (!result) {
+        return;
+    }
+    
+    std::vector<int> ids;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (row[0]) {
+            ids.push_back(std::atoi(row[0]));
+        }
+    }
+    mysql_free_result(result);
+    if (ids.empty()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(judge_queue_mutex);
+        for (int id : ids) {
+            SubmissionEvents::open(id);
+            judge_queue.push(id);
+        }
+    }
+    judge_queue_cond.notify_all();
+    std::cout << "重新排队未完成评测的提交: " << ids.size() << " 个" << std::endl;
 }
 
 void SubmissionService::stopJudgeThread() {
-    // 不再需要停止评测线程
-    std::cout << "同步评测模式，无需停止评测线程" << std::endl;
+    if (!judge_running.exchange(false)) {
+        return;
+    }
+    judge_queue_cond.notify_all();
+    
+    // 等待正在进行的评测完成
+    for (auto& worker : judge_workers) {
+        if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) {
+            worker.join();
+        }
+    }
+    judge_workers.clear();
+    
+    // 评测线程都已退出，结束常驻运行时
+    WarmRunner::stop();
+    std::cout << "评测线程已停止" << std::endl;
+}
+
+// 评测单个提交，评测失败时记录系统错误
+void SubmissionService::runJudge(int submission_id) {
+    JudgeEngine judge_engine;
+    std::string judge_error_message;
+    
+    try {
+        std::cout << "【评测引擎】开始评测提交ID: " << submission_id << std::endl;
+        bool judge_success = judge_engine.judge(submission_id, judge_error_message);
+        
+        if (judge_success) {
+            std::cout << "【评测引擎】成功完成评测，提交ID: " << submission_id << std::endl;
+        } else {
+            std::cerr << "【评测引擎】评测失败，提交ID: " << submission_id << ", 错误: " << judge_error_message << std::endl;
+            // 更新提交状态为系统错误
+            judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, "评测失败: " + judge_error_message);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "【评测引擎】评测异常，提交ID: " << submission_id << ", 错误: " << e.what() << std::endl;
+        // 更新提交状态为系统错误
+        judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, std::string("评测系统异常: ") + e.what());
+    } catch (...) {
+        std::cerr << "【评测引擎】评测发生未知异常，提交ID: " << submission_id << std::endl;
+        // 更新提交状态为系统错误
+        judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, "评测系统发生未知异常");
+    }
 }
 
 // 获取题目的提交列表
@@ -76,37 +188,23 @@ bool SubmissionService::createSubmission(Submission& submission, std::string& er
             return false;
         }
         
-        std::cout << "提交记录验证成功，开始同步评测，用户ID: " 
+        std::cout << "提交记录验证成功，用户ID: " 
                   << check.getUserId() << ", 题目ID: " << check.getProblemId() 
                   << ", 语言: " << check.getLanguageStr() << std::endl;
         
-        // 更新提交状态为评测中
-        check.setResult(JudgeResult::JUDGING);
-        SubmissionRepository::updateSubmission(check);
-        
-        // 直接评测
-        JudgeEngine judge_engine;
-        std::string judge_error_message;
+        // 登记事件通道，订阅者可以在评测开始前就连接
+        SubmissionEvents::open(submission_id);
         
-        try {
-            std::cout << "【评测引擎】开始同步评测提交ID: " << submission_id << std::endl;
-            bool judge_success = judge_engine.judge(submission_id, judge_error_message);
-            
-            if (judge_success) {
-                std::cout << "【评测引擎】成功完成评测，提交ID: " << submission_id << std::endl;
-            } else {
-                std::cerr << "【评测引擎】评测失败，提交ID: " << submission_id << ", 错误: " << judge_error_message << std::endl;
-                // 更新提交状态为系统错误
-                judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, "评测失败: " + judge_error_message);
+        if (judge_running) {
+            // 加入评测队列，由评测线程异步评测
+            {
+                std::lock_guard<std::mutex> lock(judge_queue_mutex);
+                judge_queue.push(submission_id);
             }
-        } catch (const std::exception& e) {
-            std::cerr << "【评测引擎】评测异常，提交ID: " << submission_id << ", 错误: " << e.what() << std::endl;
-            // 更新提交状态为系统错误
-            judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, std::string("评测系统异常: ") + e.what());
-        } catch (...) {
-            std::cerr << "【评测引擎】评测发生未知异常，提交ID: " << submission_id << std::endl;
-            // 更新提交状态为系统错误
-            judgeSubmission(submission_id, JudgeResult::SYSTEM_ERROR, 0, 0, 0, "评测系统发生未知异常");
+            judge_queue_cond.notify_one();
+        } else {
+            // 评测线程未启动时退回同步评测
+            runJudge(submission_id);
         }
     } else {
         std::cerr << "创建提交失败，数据库操作返回错误" << std::endl;
@@ -155,10 +253,21 @@ bool SubmissionService::judgeSubmission(int submission_id, JudgeResult result, i
         // 检查是否通过评测
         bool is_accepted = (result == JudgeResult::ACCEPTED);
         
-        // 更新用户的排行榜统计信息
-        UserService::updateUserLeaderboardStats(submission.getUserId(), submission.getProblemId(), is_accepted);
+        // 更新用户的排行榜统计信息，再按同一结果调整总排行榜和提交当天的分桶
+        VerdictDelta delta;
+        if (UserService::updateUserLeaderboardStats(submission.getUserId(), submission.getProblemId(), is_accepted, delta)) {
+            RankingService::applyVerdict(submission.getUserId(), submission.getCreatedAt(), is_accepted, delta);
+        }
+        
+        // 累计题目的提交统计，通过人数按是否首次通过计算
+        ProblemStats::recordVerdict(submission.getProblemId(), result, delta.first_solve);
     }
     
+    // 推送最终结果，订阅者收到后关闭推送流
+    Json::Value verdict;
+    verdict["submission"] = submission.toJson();
+    SubmissionEvents::publish(submission_id, "verdict", verdict, true);
+    
     return success;
 }
 
@@ -283,7 +392,14 @@ bool SubmissionService::updateSubmissionStatus(int submission_id, JudgeResult re
     
     // 更新状态
     submission.setResult(result);
-    return SubmissionRepository::updateSubmission(submission);
+    bool success = SubmissionRepository::updateSubmission(submission);
+    
+    Json::Value status;
+    status["submission_id"] = submission_id;
+    status["result"] = static_cast<int>(result);
+    SubmissionEvents::publish(submission_id, "status", status);
+    
+    return success;
 }
 
 // 获取用户题目状态
@@ -0,0 +1,189 @@
+#include "../../include/services/toolchain_registry.h"
+#include <mutex>
+#include <sstream>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+    std::once_flag init_flag;
+    std::vector<Toolchain> toolchains;
+
+    void replaceAll(std::string& text, const std::string& from, const std::string& to) {
+        size_t pos = 0;
+        while ((pos = text.find(from, pos)) != std::string::npos) {
+            text.replace(pos, from.length(), to);
+            pos += to.length();
+        }
+    }
+
+    std::vector<std::string> splitArguments(const std::string& command) {
+        std::vector<std::string> arguments;
+        std::istringstream stream(command);
+        std::string argument;
+        while (stream >> argument) {
+            arguments.push_back(argument);
+        }
+        return arguments;
+    }
+
+    bool runQuietly(const std::string& command) {
+        return system(("(" + command + ") > /dev/null 2>&1").c_str()) == 0;
+    }
+
+    std::vector<Toolchain> defaultToolchains() {
+        std::vector<Toolchain> list;
+
+        Toolchain c;
+        c.language = Language::C;
+        c.name = "c";
+        c.source_file = "solution.c";
+        c.artifact = "solution";
+        c.compile_command = "gcc -std=c11 -O2 -Wall -o {exe} {src} -lm";
+        c.run_command = "{exe}";
+        c.probe_command = "gcc --version";
+        list.push_back(c);
+
+        Toolchain cpp;
+        cpp.language = Language::CPP;
+        cpp.name = "cpp";
+        cpp.source_file = "solution.cpp";
+        cpp.artifact = "solution";
+        cpp.compile_command = "g++ -std=c++11 -O2 -Wall -o {exe} {src}";
+        cpp.run_command = "{exe}";
+        cpp.probe_command = "g++ --version";
+        list.push_back(cpp);
+
+        // 启动时生成JDK核心类的类数据共享归档，运行时映射归档，免去每次启动解析和校验核心类；
+        // 串行GC减少启动的线程数和常驻内存。堆大小按题目内存限制设置，另给JVM自身留出常驻内存；
+        // 地址空间不做限制，改用 RLIMIT_DATA 兜底，给元空间、代码缓存和线程栈留出余量
+        Toolchain java;
+        java.language = Language::JAVA;
+        java.name = "java";
+        java.source_file = "Main.java";
+        java.artifact = "Main.class";
+        java.compile_command = "javac -J-Xshare:auto -encoding UTF-8 -d {dir} {src}";
+        java.run_command = "java {warm} -XX:+UseSerialGC -Xms16m -Xmx{mem_mb}m -Xss64m -cp {dir} Main";
+        java.probe_command = "javac -version && java -version";
+        java.prepare_command = "java -Xshare:dump -XX:SharedArchiveFile={cache}/java_base.jsa";
+        java.warm_options = "-Xshare:auto -XX:SharedArchiveFile={cache}/java_base.jsa";
+        java.oom_marker = "java.lang.OutOfMemoryError";
+        java.time_multiplier = 2.0;
+        java.time_extra_ms = 500;
+        java.memory_extra_kb = 65536;
+        java.limit_address_space = false;
+        java.data_reserve_kb = 262144;
+        list.push_back(java);
+
+        // 编译阶段把源文件预编译为字节码（同时检查语法错误），运行时直接执行字节码；
+        // -S 跳过 site 模块的导入，评测只使用标准库。测试点默认从常驻的解释器fork执行
+        Toolchain python;
+        python.language = Language::PYTHON;
+        python.name = "python";
+        python.source_file = "solution.py";
+        python.artifact = "solution.pyc";
+        python.compile_command = "python3 -c \"import py_compile, sys; "
+                                 "py_compile.compile(sys.argv[1], cfile=sys.argv[2], doraise=True)\" {src} {exe}";
+        python.run_command = "python3 {warm} {exe}";
+        python.probe_command = "python3 --version";
+        python.warm_options = "-S";
+        python.runner_command = "python3 -S {cache}/python_runner.py";
+        python.oom_marker = "MemoryError";
+        python.time_multiplier = 3.0;
+        python.time_extra_ms = 200;
+        python.memory_extra_kb = 16384;
+        list.push_back(python);
+
+        // 编译阶段只做语法检查；V8的老生代大小按题目内存限制设置，RLIMIT_DATA 另给新生代和代码空间留出余量
+        Toolchain javascript;
+        javascript.language = Language::JAVASCRIPT;
+        javascript.name = "javascript";
+        javascript.source_file = "solution.js";
+        javascript.artifact = "solution.js";
+        javascript.compile_command = "node --check {src}";
+        javascript.run_command = "node {warm} --max-old-space-size={mem_mb} {exe}";
+        javascript.probe_command = "node --version";
+        javascript.oom_marker = "out of memory";
+        javascript.time_multiplier = 2.0;
+        javascript.time_extra_ms = 200;
+        javascript.memory_extra_kb = 32768;
+        javascript.limit_address_space = false;
+        javascript.data_reserve_kb = 262144;
+        list.push_back(javascript);
+
+        return list;
+    }
+
+    void initializeOnce() {
+        toolchains = defaultToolchains();
+        runQuietly(std::string("mkdir -p ") + TOOLCHAIN_CACHE_DIR);
+
+        for (auto& toolchain : toolchains) {
+            toolchain.available = runQuietly(toolchain.probe_command);
+            if (!toolchain.available) {
+                std::cout << "【评测引擎】未安装 " << toolchain.name << " 工具链，该语言的提交将无法评测" << std::endl;
+                continue;
+            }
+
+            if (toolchain.prepare_command.empty()) {
+                toolchain.warmed = true;
+            } else {
+                std::string prepare = ToolchainRegistry::expand(toolchain.prepare_command, toolchain, TOOLCHAIN_CACHE_DIR, 0);
+                toolchain.warmed = runQuietly(prepare);
+                if (!toolchain.warmed) {
+                    std::cerr << "【评测引擎】" << toolchain.name << " 工具链预热失败，以冷启动方式运行" << std::endl;
+                }
+            }
+            std::cout << "【评测引擎】" << toolchain.name << " 工具链可用"
+                      << (toolchain.warmed && !toolchain.warm_options.empty() ? "，已预热" : "") << std::endl;
+        }
+    }
+}
+
+int Toolchain::effectiveTimeLimit(int time_limit_ms) const {
+    return static_cast<int>(time_limit_ms * time_multiplier) + time_extra_ms;
+}
+
+int Toolchain::effectiveMemoryLimit(int memory_limit_kb) const {
+    return memory_limit_kb + memory_extra_kb;
+}
+
+void ToolchainRegistry::initialize() {
+    std::call_once(init_flag, initializeOnce);
+}
+
+const Toolchain* ToolchainRegistry::find(Language language) {
+    initialize();
+    for (const auto& toolchain : toolchains) {
+        if (toolchain.language == language) {
+            return &toolchain;
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<Toolchain>& ToolchainRegistry::all() {
+    initialize();
+    return toolchains;
+}
+
+std::string ToolchainRegistry::expand(const std::string& command, const Toolchain& toolchain,
+                                      const std::string& dir, int memory_limit_kb) {
+    std::string result = command;
+    // {warm} 中可能还有其他占位符，先替换
+    replaceAll(result, "{warm}", toolchain.warmed ? toolchain.warm_options : "");
+    replaceAll(result, "{src}", dir + "/" + toolchain.source_file);
+    replaceAll(result, "{exe}", dir + "/" + toolchain.artifact);
+    replaceAll(result, "{dir}", dir);
+    replaceAll(result, "{cache}", TOOLCHAIN_CACHE_DIR);
+    replaceAll(result, "{mem_mb}", std::to_string(memory_limit_kb > 1024 ? memory_limit_kb / 1024 : 1));
+    return result;
+}
+
+std::vector<std::string> ToolchainRegistry::runArguments(const Toolchain& toolchain, const std::string& dir,
+                                                         int memory_limit_kb) {
+    return splitArguments(expand(toolchain.run_command, toolchain, dir, memory_limit_kb));
+}
+
+std::vector<std::string> ToolchainRegistry::runnerArguments(const Toolchain& toolchain) {
+    return splitArguments(expand(toolchain.runner_command, toolchain, TOOLCHAIN_CACHE_DIR, 0));
+}
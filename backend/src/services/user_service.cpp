@@ -1,13 +1,37 @@
 #include "../../include/services/user_service.h"
 #include "../../include/database/database.h"
 #include "../../include/utils/jwt.h"
+#include "../../include/utils/password_hasher.h"
+#include "../../include/services/ranking_service.h"
+#include "../../include/utils/cache_version.h"
 #include <regex>
 #include <iostream>
 #include <ctime>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <mysql/mysql.h>
 #include <json/json.h>
 
+// 新用户加入排行榜（按用户名查出新插入的ID）
+static void addNewUserToRanking(const std::string &username)
+{
+    Database *db = Database::getInstance();
+    MYSQL_RES *result = db->executeQuery("SELECT id FROM users WHERE username = '" + db->escapeString(username) + "'");
+    if (!result)
+    {
+        return;
+    }
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int user_id = row && row[0] ? std::stoi(row[0]) : 0;
+    mysql_free_result(result);
+
+    if (user_id > 0)
+    {
+        RankingService::updateUserRanking(user_id);
+    }
+}
+
 // 验证密码强度
 bool UserService::validatePassword(const std::string &password)
 {
@@ -110,10 +134,13 @@ bool UserService::registerUser(const std::string &username, const std::string &e
         return false;
     }
 
-    // 生成密码哈希和盐 - C++11兼容写法
-    std::pair<std::string, std::string> password_data = User::generatePasswordHash(password);
-    std::string password_hash = password_data.first;
-    std::string salt = password_data.second;
+    // 生成密码哈希和盐（在哈希线程池中计算）
+    std::string password_hash;
+    std::string salt;
+    if (!PasswordHasher::hashPassword(password, password_hash, salt, error_message))
+    {
+        return false;
+    }
 
     // 获取数据库连接
     Database *db = Database::getInstance();
@@ -149,6 +176,7 @@ bool UserService::registerUser(const std::string &username, const std::string &e
         return false;
     }
 
+    addNewUserToRanking(username);
     return true;
 }
 
@@ -187,18 +215,27 @@ std::string UserService::login(const std::string &username, const std::string &p
         return "";
     }
 
-    // 验证密码
-    if (!user.checkPassword(password))
+    // 验证密码（在哈希线程池中计算）
+    PasswordCheck check;
+    if (!PasswordHasher::verifyPassword(password, user.getSalt(), user.getPasswordHash(), check, error_message))
+    {
+        return "";
+    }
+    if (!check.matched)
     {
         error_message = "用户名或密码错误";
         return "";
     }
 
-    // 更新最后登录时间
+    // 更新最后登录时间，旧格式的密码哈希同时升级为当前格式
     user.updateLastLogin();
     std::string update_query = "UPDATE users SET last_login = " + std::to_string(user.getLastLogin()) +
-                               ", updated_at = " + std::to_string(user.getUpdatedAt()) +
-                               " WHERE id = " + std::to_string(user.getId());
+                               ", updated_at = " + std::to_string(user.getUpdatedAt());
+    if (!check.rehash.empty())
+    {
+        update_query += ", password_hash = '" + check.rehash + "', salt = '" + check.rehash_salt + "'";
+    }
+    update_query += " WHERE id = " + std::to_string(user.getId());
     db->executeCommand(update_query);
 
     // 生成JWT令牌
@@ -348,17 +385,25 @@ bool UserService::changePassword(int user_id, const std::string &old_password,
         return false;
     }
 
-    // 验证旧密码
-    if (!user.checkPassword(old_password))
+    // 验证旧密码（在哈希线程池中计算）
+    PasswordCheck check;
+    if (!PasswordHasher::verifyPassword(old_password, user.getSalt(), user.getPasswordHash(), check, error_message))
+    {
+        return false;
+    }
+    if (!check.matched)
     {
         error_message = "旧密码不正确";
         return false;
     }
 
-    // 生成新的密码哈希和盐 - C++11兼容写法
-    std::pair<std::string, std::string> password_data = User::generatePasswordHash(new_password);
-    std::string password_hash = password_data.first;
-    std::string salt = password_data.second;
+    // 生成新的密码哈希和盐（在哈希线程池中计算）
+    std::string password_hash;
+    std::string salt;
+    if (!PasswordHasher::hashPassword(new_password, password_hash, salt, error_message))
+    {
+        return false;
+    }
 
     // 获取数据库连接
     Database *db = Database::getInstance();
@@ -484,282 +529,138 @@ bool UserService::getLeaderboard(int offset, int limit, const std::string &time_
                                  int current_user_id, Json::Value &leaderboard_data,
                                  int &total, std::string &error_message)
 {
-    // 获取数据库连接
-    Database *db = Database::getInstance();
-
-    // 先查询数据库确认表结构
-    std::string table_check_query = "SHOW TABLES LIKE 'submissions'";
-    MYSQL_RES *table_check_result = db->executeQuery(table_check_query);
-    bool has_submissions_table = false;
-
-    if (table_check_result && mysql_num_rows(table_check_result) > 0)
-    {
-        has_submissions_table = true;
-        mysql_free_result(table_check_result);
-    }
-    else if (table_check_result)
-    {
-        mysql_free_result(table_check_result);
-    }
-
-    // 根据数据库结构选择不同的查询
-    std::string base_query;
+    if (offset < 0)
+        offset = 0;
 
-    if (has_submissions_table)
-    {
-        // 使用submissions表进行连接查询，获取真实的统计数据
-        base_query = "SELECT u.id, u.username, IFNULL(u.avatar, '') as avatar, "
-                    // 计算已解决的题目数量（distinct problem_id且result=2）
-                    "COUNT(DISTINCT CASE WHEN s.result = 2 THEN s.problem_id ELSE NULL END) as solved_count, "
-                    // 计算总提交数
-                    "COUNT(s.id) as submission_count, "
-                    // 计算分数：简单题10分，中等题20分，困难题30分
-                    "SUM(CASE WHEN s.result = 2 THEN "
-                    "   CASE WHEN p.difficulty = '简单' THEN 10 "
-                    "   WHEN p.difficulty = '中等' THEN 20 "
-                    "   WHEN p.difficulty = '困难' THEN 30 "
-                    "   ELSE 0 END "
-                    "ELSE 0 END) as score, "
-                    // 计算各难度已解决的题目数量
-                    "COUNT(DISTINCT CASE WHEN s.result = 2 AND p.difficulty = '简单' THEN s.problem_id ELSE NULL END) as easy_count, "
-                    "COUNT(DISTINCT CASE WHEN s.result = 2 AND p.difficulty = '中等' THEN s.problem_id ELSE NULL END) as medium_count, "
-                    "COUNT(DISTINCT CASE WHEN s.result = 2 AND p.difficulty = '困难' THEN s.problem_id ELSE NULL END) as hard_count, "
-                    // 计算通过率
-                    "CASE WHEN COUNT(s.id) > 0 THEN "
-                    "ROUND(COUNT(DISTINCT CASE WHEN s.result = 2 THEN s.problem_id ELSE NULL END) * 100.0 / "
-                    "COUNT(DISTINCT s.problem_id), 2) "
-                    "ELSE 0 END as acceptance_rate "
-                    "FROM users u "
-                    "LEFT JOIN submissions s ON u.id = s.user_id "
-                    "LEFT JOIN problems p ON s.problem_id = p.id "
-                    "WHERE u.role < 2 "; // 排除管理员
-    }
-    else
-    {
-        // 没有submissions表，只查询users表
-        base_query = "SELECT u.id, u.username, IFNULL(u.avatar, '') as avatar, "
-                    "u.solved_count, "
-                    "u.submission_count, "
-                    "u.score, "
-                    "u.easy_count, "
-                    "u.medium_count, "
-                    "u.hard_count, "
-                    "CASE WHEN u.submission_count > 0 THEN "
-                    "ROUND(u.solved_count * 100.0 / u.submission_count, 2) "
-                    "ELSE 0 END as acceptance_rate "
-                    "FROM users u "
-                    "WHERE u.role < 2 "; // 排除管理员
-    }
-
-    // 根据时间范围添加条件
-    std::string time_condition = "";
-    if (time_range == "day")
-    {
-        if (has_submissions_table)
-        {
-            time_condition = " AND DATE(FROM_UNIXTIME(s.created_at)) = CURDATE() ";
-        }
-        else
-        {
-            time_condition = " AND DATE(FROM_UNIXTIME(u.last_login)) = CURDATE() ";
-        }
-    }
-    else if (time_range == "week")
-    {
-        if (has_submissions_table)
-        {
-            time_condition = " AND YEARWEEK(FROM_UNIXTIME(s.created_at)) = YEARWEEK(NOW()) ";
-        }
-        else
-        {
-            time_condition = " AND YEARWEEK(FROM_UNIXTIME(u.last_login)) = YEARWEEK(NOW()) ";
-        }
-    }
-    else if (time_range == "month")
+    // 总榜读取内存中的排名，日/周/月榜由每日分桶求和
+    std::vector<UserRankingItem> items;
+    if (time_range == "day" || time_range == "week" || time_range == "month")
     {
-        if (has_submissions_table)
+        if (!RankingService::getWindowRankingList(time_range, offset, limit, items, total))
         {
-            time_condition = " AND MONTH(FROM_UNIXTIME(s.created_at)) = MONTH(NOW()) AND YEAR(FROM_UNIXTIME(s.created_at)) = YEAR(NOW()) ";
-        }
-        else
-        {
-            time_condition = " AND MONTH(FROM_UNIXTIME(u.last_login)) = MONTH(NOW()) AND YEAR(FROM_UNIXTIME(u.last_login)) = YEAR(NOW()) ";
+            error_message = "获取排行榜数据失败，数据库错误";
+            return false;
         }
     }
-
-    // 如果使用submissions表，需要添加GROUP BY
-    std::string group_by = "";
-    if (has_submissions_table)
+    else
     {
-        group_by = " GROUP BY u.id, u.username, u.avatar ";
+        items = RankingService::getUserRankingList(offset, limit);
+        total = RankingService::getRankedUserCount();
     }
 
-    // 添加排序规则
-    std::string order_query = "ORDER BY solved_count DESC, acceptance_rate DESC, submission_count ASC ";
-
-    // 添加分页
-    std::string limit_query = "LIMIT " + std::to_string(limit) + " OFFSET " + std::to_string(offset);
-
-    // 计算总数查询（计算符合条件的用户数量）
-    std::string count_query;
-    if (has_submissions_table && time_range != "all")
-    {
-        count_query = "SELECT COUNT(DISTINCT u.id) FROM users u "
-                     "LEFT JOIN submissions s ON u.id = s.user_id "
-                     "WHERE u.role < 2 " + time_condition;
-    }
-    else
+    Json::Value users(Json::arrayValue);
+    for (size_t i = 0; i < items.size(); i++)
     {
-        count_query = "SELECT COUNT(*) FROM users u WHERE u.role < 2 " + time_condition;
+        const UserRankingItem &item = items[i];
+        Json::Value user;
+        user["rank"] = offset + static_cast<int>(i) + 1;
+        user["user_id"] = item.user_id;
+        user["username"] = item.username;
+        user["avatar"] = item.avatar;
+        user["solved_count"] = item.solved_count;
+        user["submission_count"] = item.total_submissions;
+        user["score"] = item.score;
+        user["easy_count"] = item.easy_count;
+        user["medium_count"] = item.medium_count;
+        user["hard_count"] = item.hard_count;
+        user["acceptance_rate"] = item.acceptance_rate;
+        user["is_current_user"] = (item.user_id == current_user_id);
+        users.append(user);
     }
+    leaderboard_data = users;
 
-    // 执行计算总数查询
-    MYSQL_RES *count_result = db->executeQuery(count_query);
+    return true;
+}
 
-    if (!count_result)
-    {
-        error_message = "获取排行榜数据失败，数据库错误";
-        return false;
-    }
+// 题目难度缓存，题目缓存版本变化时整体失效
+static std::string getProblemDifficulty(int problem_id)
+{
+    static std::mutex cache_mutex;
+    static std::unordered_map<int, std::string> cache;
+    static uint64_t cache_version = 0;
 
-    MYSQL_ROW count_row = mysql_fetch_row(count_result);
-    if (count_row && count_row[0])
+    uint64_t version = CacheVersion::get(CacheVersion::PROBLEMS);
     {
-        total = std::stoi(count_row[0]);
-    }
-    else
-    {
-        total = 0;
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (cache_version != version)
+        {
+            cache.clear();
+            cache_version = version;
+        }
+        auto it = cache.find(problem_id);
+        if (it != cache.end())
+        {
+            return it->second;
+        }
     }
-    mysql_free_result(count_result);
 
-    // 如果没有数据，直接返回空数组
-    if (total == 0)
+    Database *db = Database::getInstance();
+    MYSQL_RES *result = db->executeQuery("SELECT difficulty FROM problems WHERE id = " + std::to_string(problem_id));
+    if (!result)
     {
-        leaderboard_data = Json::Value(Json::arrayValue);
-        return true;
+        return "";
     }
-
-    // 执行查询获取排行榜数据
-    std::string query = base_query + time_condition + group_by + order_query + limit_query;
-
-    // 打印查询语句用于调试
-    std::cout << "执行排行榜查询: " << query << std::endl;
-
-    MYSQL_RES *result = db->executeQuery(query);
-
-    if (!result)
+    MYSQL_ROW row = mysql_fetch_row(result);
+    bool found = row != nullptr;
+    std::string difficulty = row && row[0] ? row[0] : "中等";
+    mysql_free_result(result);
+    if (!found)
     {
-        error_message = "获取排行榜数据失败，数据库错误";
-        std::cout << "查询执行失败" << std::endl;
-        return false;
+        return "";
     }
 
-    // 处理查询结果
-    MYSQL_ROW row;
-    Json::Value users(Json::arrayValue);
-
-    while ((row = mysql_fetch_row(result)))
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (cache_version == version)
     {
-        Json::Value user;
-
-        int user_id = row[0] ? std::stoi(row[0]) : 0;
-        std::string username = row[1] ? row[1] : "";
-        std::string avatar = row[2] ? row[2] : "";
-        int solved_count = row[3] ? std::stoi(row[3]) : 0;
-        int submission_count = row[4] ? std::stoi(row[4]) : 0;
-        int score = row[5] ? std::stoi(row[5]) : 0;
-        int easy_count = row[6] ? std::stoi(row[6]) : 0;
-        int medium_count = row[7] ? std::stoi(row[7]) : 0;
-        int hard_count = row[8] ? std::stoi(row[8]) : 0;
-        double acceptance_rate = row[9] ? std::stod(row[9]) : 0.0;
-
-        user["user_id"] = user_id;
-        user["username"] = username;
-        user["avatar"] = avatar;
-        user["solved_count"] = solved_count;
-        user["submission_count"] = submission_count;
-        user["score"] = score;
-        user["easy_count"] = easy_count;
-        user["medium_count"] = medium_count;
-        user["hard_count"] = hard_count;
-        user["acceptance_rate"] = acceptance_rate;
-        user["is_current_user"] = (user_id == current_user_id);
-
-        users.append(user);
+        cache[problem_id] = difficulty;
     }
-
-    mysql_free_result(result);
-    leaderboard_data = users;
-
-    return true;
+    return difficulty;
 }
 
 // 更新用户排行榜统计信息
-bool UserService::updateUserLeaderboardStats(int user_id, int problem_id, bool is_accepted)
+bool UserService::updateUserLeaderboardStats(int user_id, int problem_id, bool is_accepted, VerdictDelta &delta)
 {
     // 获取数据库连接
     Database *db = Database::getInstance();
 
-    // 1. 获取用户当前统计信息
-    User user = getUserInfo(user_id);
-    if (user.getId() == 0)
-    {
-        return false;
-    }
-
-    // 2. 获取题目信息，确定难度
-    std::string problem_query = "SELECT difficulty FROM problems WHERE id = " + std::to_string(problem_id);
-    MYSQL_RES *problem_result = db->executeQuery(problem_query);
-
-    if (!problem_result || mysql_num_rows(problem_result) == 0)
+    // 1. 记录用户在该题上的状态，(user_id, problem_id) 为主键，由影响行数判断是否首次提交或首次通过：
+    //    1 - 新插入（首次提交），2 - 由未通过变为通过，0 - 无变化。并发评测同一题时只有一个会计为首次通过
+    std::string accepted = is_accepted ? "1" : "0";
+    std::string status_query = "INSERT INTO user_problem_status (user_id, problem_id, solved, solved_at) VALUES (" +
+                               std::to_string(user_id) + ", " + std::to_string(problem_id) + ", " + accepted + ", " +
+                               (is_accepted ? std::to_string(time(nullptr)) : "0") + ") "
+                               "ON DUPLICATE KEY UPDATE solved_at = IF(solved = 0, VALUES(solved_at), solved_at), "
+                               "solved = GREATEST(solved, VALUES(solved))";
+    unsigned long long affected_rows = 0;
+    if (!db->executeCommand(status_query, affected_rows))
     {
-        if (problem_result)
-            mysql_free_result(problem_result);
         return false;
     }
+    delta.first_attempt = affected_rows == 1;
+    delta.first_solve = is_accepted && (affected_rows == 1 || affected_rows == 2);
+    delta.difficulty = delta.first_solve ? getProblemDifficulty(problem_id) : "";
 
-    MYSQL_ROW problem_row = mysql_fetch_row(problem_result);
-    std::string difficulty = problem_row[0] ? problem_row[0] : "中等";
-    mysql_free_result(problem_result);
-
-    // 3. 检查用户是否已经通过该题目，避免重复计算
-    std::string check_query = "SELECT COUNT(*) FROM submissions WHERE user_id = " + std::to_string(user_id) +
-                              " AND problem_id = " + std::to_string(problem_id) +
-                              " AND result = 2"; // 2 表示已通过
-
-    MYSQL_RES *check_result = db->executeQuery(check_query);
-
-    if (!check_result)
-    {
-        return false;
-    }
-
-    MYSQL_ROW check_row = mysql_fetch_row(check_result);
-    bool already_solved = check_row[0] && std::stoi(check_row[0]) > 0;
-    mysql_free_result(check_result);
-
-    // 4. 更新数据
+    // 2. 按条件一次更新用户统计
     std::string update_query = "UPDATE users SET";
 
     // 总是增加提交次数
     update_query += " submission_count = submission_count + 1";
 
-    // 如果是通过且之前没有通过过，则更新解题数量和积分
-    if (is_accepted && !already_solved)
+    // 首次通过时更新解题数量和积分
+    if (delta.first_solve)
     {
         update_query += ", solved_count = solved_count + 1";
 
         // 根据难度增加相应难度的题目计数和积分
-        if (difficulty == "简单")
+        if (delta.difficulty == "简单")
         {
             update_query += ", easy_count = easy_count + 1, score = score + 10";
         }
-        else if (difficulty == "中等")
+        else if (delta.difficulty == "中等")
         {
             update_query += ", medium_count = medium_count + 1, score = score + 20";
         }
-        else if (difficulty == "困难")
+        else if (delta.difficulty == "困难")
         {
             update_query += ", hard_count = hard_count + 1, score = score + 30";
         }
@@ -923,10 +824,12 @@ bool UserService::createUserByAdmin(const std::string& username, const std::stri
         return false;
     }
     
-    // 生成密码哈希和盐 - C++11兼容写法
-    std::pair<std::string, std::string> password_data = User::generatePasswordHash(password);
-    std::string password_hash = password_data.first;
-    std::string salt = password_data.second;
+    // 生成密码哈希和盐（在哈希线程池中计算）
+    std::string password_hash;
+    std::string salt;
+    if (!PasswordHasher::hashPassword(password, password_hash, salt, error_message)) {
+        return false;
+    }
     
     // 获取数据库连接
     Database* db = Database::getInstance();
@@ -961,6 +864,7 @@ bool UserService::createUserByAdmin(const std::string& username, const std::stri
         return false;
     }
     
+    addNewUserToRanking(username);
     return true;
 }
 
@@ -1063,6 +967,11 @@ bool UserService::updateUserByAdmin(int user_id, const Json::Value& user_data,
         return false;
     }
     
+    // 角色变化可能使用户进入或退出排行榜
+    if (user_data.isMember("role")) {
+        RankingService::updateUserRanking(user_id);
+    }
+    
     return true;
 }
 
@@ -1127,6 +1036,8 @@ bool UserService::changeUserRole(int user_id, UserRole role, std::string& error_
         return false;
     }
     
+    // 管理员不参与排名
+    RankingService::updateUserRanking(user_id);
     return true;
 }
 
@@ -1146,10 +1057,12 @@ bool UserService::resetUserPassword(int user_id, const std::string& new_password
         return false;
     }
     
-    // 生成新的密码哈希和盐 - C++11兼容写法
-    std::pair<std::string, std::string> password_data = User::generatePasswordHash(new_password);
-    std::string password_hash = password_data.first;
-    std::string salt = password_data.second;
+    // 生成新的密码哈希和盐（在哈希线程池中计算）
+    std::string password_hash;
+    std::string salt;
+    if (!PasswordHasher::hashPassword(new_password, password_hash, salt, error_message)) {
+        return false;
+    }
     
     // 获取数据库连接
     Database* db = Database::getInstance();
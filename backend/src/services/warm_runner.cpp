@@ -0,0 +1,347 @@
+#include "../../include/services/warm_runner.h"
+#include <map>
+#include <set>
+#include <mutex>
+#include <vector>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+namespace {
+    // 等待常驻进程就绪的时间（毫秒）
+    const int RUNNER_READY_TIMEOUT_MS = 10000;
+
+    // Python常驻进程：导入常用模块后逐行读取请求，每个请求fork一个子进程执行字节码，
+    // 等待子进程结束后回复 "exit|signal 退出码或信号 CPU时间 墙钟时间 最大常驻内存"
+    const char* PYTHON_RUNNER = R"PY(import os, sys, time, marshal, resource, traceback
+import importlib.util
+import math, collections, heapq, bisect, itertools, functools, re, string, random, array
+
+MAGIC = importlib.util.MAGIC_NUMBER
+HEADER_SIZE = 16 if sys.version_info >= (3, 7) else 12
+
+
+def child(program, input_path, output_path, error_path, time_limit_ms, memory_limit_kb, limit_as):
+    for path, target, flags in ((input_path, 0, os.O_RDONLY),
+                                (output_path, 1, os.O_WRONLY | os.O_TRUNC),
+                                (error_path, 2, os.O_WRONLY | os.O_TRUNC)):
+        fd = os.open(path, flags)
+        os.dup2(fd, target)
+        os.close(fd)
+    sys.stdin = open(0, 'r', closefd=False)
+    sys.stdout = open(1, 'w', closefd=False)
+    sys.stderr = open(2, 'w', closefd=False)
+    cpu = time_limit_ms // 1000 + 1
+    resource.setrlimit(resource.RLIMIT_CPU, (cpu, cpu + 1))
+    if limit_as:
+        resource.setrlimit(resource.RLIMIT_AS, (memory_limit_kb * 1024, memory_limit_kb * 1024))
+
+    code = 0
+    try:
+        with open(program, 'rb') as f:
+            data = f.read()
+        if data[:4] != MAGIC:
+            raise RuntimeError('bytecode was compiled by another python version')
+        program_code = marshal.loads(data[HEADER_SIZE:])
+        sys.argv = [program]
+        sys.path[0] = os.path.dirname(program)
+        exec(program_code, {'__name__': '__main__', '__file__': program, '__builtins__': __builtins__})
+    except SystemExit as e:
+        if e.code is None:
+            code = 0
+        elif isinstance(e.code, int):
+            code = e.code
+        else:
+            print(e.code, file=sys.stderr)
+            code = 1
+    except BaseException:
+        traceback.print_exc()
+        code = 1
+    try:
+        sys.stdout.flush()
+        sys.stderr.flush()
+    except BaseException:
+        code = code or 1
+    os._exit(code & 0xff)
+
+
+def main():
+    out = sys.stdout
+    out.write('ready\n')
+    out.flush()
+    while True:
+        line = sys.stdin.readline()
+        if not line:
+            break
+        fields = line.rstrip('\n').split('\t')
+        if len(fields) != 7:
+            out.write('error\n')
+            out.flush()
+            continue
+        start = time.time()
+        pid = os.fork()
+        if pid == 0:
+            try:
+                child(fields[0], fields[1], fields[2], fields[3], int(fields[4]), int(fields[5]), fields[6] == '1')
+            finally:
+                os._exit(1)
+        _, status, usage = os.wait4(pid, 0)
+        wall = int((time.time() - start) * 1000)
+        if os.WIFEXITED(status):
+            kind, value = 'exit', os.WEXITSTATUS(status)
+        else:
+            kind, value = 'signal', os.WTERMSIG(status)
+        out.write('%s %d %d %d %d\n' % (kind, value, int(usage.ru_utime * 1000), wall, usage.ru_maxrss))
+        out.flush()
+
+
+main()
+)PY";
+
+    struct Runtime {
+        pid_t pid;
+        int socket_fd;
+        int generation;
+        std::string buffer;     // 已收到但未处理的响应
+
+        Runtime() : pid(-1), socket_fd(-1), generation(0) {}
+    };
+
+    std::mutex pool_mutex;
+    std::map<std::string, std::vector<Runtime>> idle_runtimes;  // 按语言名称
+    int pool_generation = 0;                                     // stop() 后递增，之前借出的进程归还时直接结束
+
+    std::mutex script_mutex;
+    std::set<std::string> written_scripts;
+
+    // 常驻进程的脚本，写入缓存目录供启动命令使用
+    const char* runnerScript(const std::string& language) {
+        if (language == "python") {
+            return PYTHON_RUNNER;
+        }
+        return nullptr;
+    }
+
+    bool writeScript(const std::string& language) {
+        const char* script = runnerScript(language);
+        if (!script) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(script_mutex);
+        if (written_scripts.count(language)) {
+            return true;
+        }
+        std::string path = std::string(TOOLCHAIN_CACHE_DIR) + "/" + language + "_runner.py";
+        std::ofstream file(path.c_str(), std::ios::trunc);
+        file << script;
+        file.close();
+        if (!file) {
+            std::cerr << "【评测引擎】无法写入常驻运行时脚本: " << path << std::endl;
+            return false;
+        }
+        written_scripts.insert(language);
+        return true;
+    }
+
+    void destroy(Runtime& runtime) {
+        if (runtime.socket_fd >= 0) {
+            close(runtime.socket_fd);
+            runtime.socket_fd = -1;
+        }
+        if (runtime.pid > 0) {
+            kill(runtime.pid, SIGKILL);
+            waitpid(runtime.pid, NULL, 0);
+            runtime.pid = -1;
+        }
+    }
+
+    // 读取一行响应，timeout_ms 小于0表示一直等待
+    bool readLine(Runtime& runtime, std::string& line, int timeout_ms) {
+        while (true) {
+            size_t pos = runtime.buffer.find('\n');
+            if (pos != std::string::npos) {
+                line = runtime.buffer.substr(0, pos);
+                runtime.buffer.erase(0, pos + 1);
+                return true;
+            }
+
+            struct pollfd pfd;
+            pfd.fd = runtime.socket_fd;
+            pfd.events = POLLIN;
+            int ready = poll(&pfd, 1, timeout_ms);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready <= 0) {
+                return false;
+            }
+
+            char chunk[256];
+            ssize_t n = recv(runtime.socket_fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            runtime.buffer.append(chunk, n);
+        }
+    }
+
+    bool sendAll(Runtime& runtime, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            // 常驻进程意外退出时不能让 SIGPIPE 结束服务进程
+            ssize_t n = send(runtime.socket_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            sent += n;
+        }
+        return true;
+    }
+
+    bool spawn(const Toolchain& toolchain, Runtime& runtime) {
+        if (!writeScript(toolchain.name)) {
+            return false;
+        }
+        std::vector<std::string> arguments = ToolchainRegistry::runnerArguments(toolchain);
+        if (arguments.empty()) {
+            return false;
+        }
+
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            std::cerr << "【评测引擎】无法创建常驻运行时的通信管道: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        if (pid == 0) {
+            // 子进程：请求从标准输入读取，响应写到标准输出，不继承服务进程的其他文件描述符
+            dup2(fds[1], STDIN_FILENO);
+            dup2(fds[1], STDOUT_FILENO);
+            long max_fd = sysconf(_SC_OPEN_MAX);
+            if (max_fd < 0 || max_fd > 4096) {
+                max_fd = 4096;
+            }
+            for (int fd = STDERR_FILENO + 1; fd < max_fd; fd++) {
+                close(fd);
+            }
+
+            std::vector<char*> argv;
+            for (const auto& argument : arguments) {
+                argv.push_back(const_cast<char*>(argument.c_str()));
+            }
+            argv.push_back(NULL);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+
+        close(fds[1]);
+        runtime.pid = pid;
+        runtime.socket_fd = fds[0];
+        runtime.buffer.clear();
+
+        std::string line;
+        if (!readLine(runtime, line, RUNNER_READY_TIMEOUT_MS) || line != "ready") {
+            std::cerr << "【评测引擎】" << toolchain.name << " 常驻运行时启动失败，改为冷启动" << std::endl;
+            destroy(runtime);
+            return false;
+        }
+        std::cout << "【评测引擎】已启动 " << toolchain.name << " 常驻运行时，进程ID: " << pid << std::endl;
+        return true;
+    }
+
+    // 借出一个空闲的常驻进程，没有时启动新的
+    bool acquire(const Toolchain& toolchain, Runtime& runtime) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            std::vector<Runtime>& idle = idle_runtimes[toolchain.name];
+            if (!idle.empty()) {
+                runtime = idle.back();
+                idle.pop_back();
+                return true;
+            }
+            runtime.generation = pool_generation;
+        }
+        return spawn(toolchain, runtime);
+    }
+
+    void release(const Toolchain& toolchain, Runtime& runtime) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (runtime.generation == pool_generation) {
+                idle_runtimes[toolchain.name].push_back(runtime);
+                return;
+            }
+        }
+        destroy(runtime);
+    }
+}
+
+bool WarmRunner::run(const Toolchain& toolchain, const std::string& program_path,
+                     const std::string& input_path, const std::string& output_path, const std::string& error_path,
+                     int time_limit_ms, int memory_limit_kb, WarmRunStatus& status) {
+    if (!WARM_RUNNER_ENABLED || toolchain.runner_command.empty()) {
+        return false;
+    }
+
+    Runtime runtime;
+    if (!acquire(toolchain, runtime)) {
+        return false;
+    }
+
+    std::stringstream request;
+    request << program_path << '\t' << input_path << '\t' << output_path << '\t' << error_path << '\t'
+            << time_limit_ms << '\t' << memory_limit_kb << '\t' << (toolchain.limit_address_space ? 1 : 0) << '\n';
+
+    std::string line;
+    char kind[16] = {0};
+    if (!sendAll(runtime, request.str()) || !readLine(runtime, line, -1) ||
+        sscanf(line.c_str(), "%15s %d %d %d %d", kind, &status.code, &status.time_used_ms,
+               &status.wall_time_ms, &status.memory_used_kb) != 5) {
+        // 常驻进程已不可用，结束它，下次重新启动
+        std::cerr << "【评测引擎】" << toolchain.name << " 常驻运行时无响应，改为冷启动" << std::endl;
+        destroy(runtime);
+        return false;
+    }
+    status.exited = strcmp(kind, "exit") == 0;
+
+    release(toolchain, runtime);
+    return true;
+}
+
+void WarmRunner::stop() {
+    std::vector<Runtime> runtimes;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_generation++;
+        for (auto& entry : idle_runtimes) {
+            runtimes.insert(runtimes.end(), entry.second.begin(), entry.second.end());
+        }
+        idle_runtimes.clear();
+    }
+    for (auto& runtime : runtimes) {
+        destroy(runtime);
+    }
+    if (!runtimes.empty()) {
+        std::cout << "【评测引擎】已结束 " << runtimes.size() << " 个常驻运行时" << std::endl;
+    }
+}
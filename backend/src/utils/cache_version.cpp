@@ -0,0 +1,75 @@
+#include "../../include/utils/cache_version.h"
+#include "../../include/database/database.h"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mysql/mysql.h>
+
+namespace {
+    // 本实例已知的版本号，只增不减
+    std::atomic<uint64_t> versions[CacheVersion::SCOPE_COUNT];
+    std::atomic<int64_t> loaded_at_ms(-CACHE_VERSION_REFRESH_MS);
+    std::mutex refresh_mutex;
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void raiseTo(CacheVersion::Scope scope, uint64_t value) {
+        uint64_t current = versions[scope].load();
+        while (current < value && !versions[scope].compare_exchange_weak(current, value)) {
+        }
+    }
+
+    // 读取数据库中的版本号；已有线程在读取时直接使用当前值
+    void refresh() {
+        std::unique_lock<std::mutex> lock(refresh_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || nowMs() - loaded_at_ms < CACHE_VERSION_REFRESH_MS) {
+            return;
+        }
+        loaded_at_ms = nowMs();
+
+        MYSQL_RES* result = Database::getInstance()->executeQuery("SELECT scope, version FROM cache_versions");
+        if (!result) {
+            return;
+        }
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(result))) {
+            int scope = row[0] ? std::atoi(row[0]) : -1;
+            if (scope >= 0 && scope < CacheVersion::SCOPE_COUNT && row[1]) {
+                raiseTo(static_cast<CacheVersion::Scope>(scope), std::strtoull(row[1], nullptr, 10));
+            }
+        }
+        mysql_free_result(result);
+    }
+}
+
+uint64_t CacheVersion::get(Scope scope) {
+    if (nowMs() - loaded_at_ms >= CACHE_VERSION_REFRESH_MS) {
+        refresh();
+    }
+    return versions[scope].load();
+}
+
+void CacheVersion::bump(Scope scope) {
+    // LAST_INSERT_ID(expr) 让插入和更新两种情况都返回递增后的版本号
+    std::string sql = "INSERT INTO cache_versions (scope, version) VALUES (" + std::to_string(static_cast<int>(scope)) +
+                      ", LAST_INSERT_ID(1)) ON DUPLICATE KEY UPDATE version = LAST_INSERT_ID(version + 1)";
+    unsigned long long version = 0;
+    if (Database::getInstance()->executeInsert(sql, version) && version > 0) {
+        raiseTo(scope, version);
+        return;
+    }
+
+    // 数据库不可用时至少让本实例的ETag失效
+    std::cerr << "更新缓存版本失败，仅在本实例递增，作用域: " << scope << std::endl;
+    versions[scope]++;
+}
+
+std::string CacheVersion::bumpStatement(Scope scope) {
+    return "INSERT INTO cache_versions (scope, version) VALUES (" + std::to_string(static_cast<int>(scope)) +
+           ", 1) ON DUPLICATE KEY UPDATE version = version + 1";
+}
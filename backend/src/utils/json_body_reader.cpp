@@ -0,0 +1,579 @@
+#include "../../include/utils/json_body_reader.h"
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+
+// 嵌套深度上限，防止恶意构造的深层嵌套请求耗尽栈空间
+static const int MAX_NESTING_DEPTH = 64;
+
+// JsonBodyReader 实现
+
+JsonBodyReader::JsonBodyReader(const std::string& body)
+    : cur_(body.data()), end_(body.data() + body.size()), depth_(0) {}
+
+void JsonBodyReader::skipWhitespace() {
+    while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\n' || *cur_ == '\r')) {
+        ++cur_;
+    }
+}
+
+bool JsonBodyReader::fail(const std::string& message) {
+    if (error_.empty()) {
+        error_ = message;
+    }
+    return false;
+}
+
+bool JsonBodyReader::expect(char c) {
+    skipWhitespace();
+    if (cur_ >= end_ || *cur_ != c) {
+        return fail(std::string("JSON格式错误: 期望 '") + c + "'");
+    }
+    ++cur_;
+    return true;
+}
+
+bool JsonBodyReader::matchLiteral(const char* literal) {
+    size_t len = std::strlen(literal);
+    if (static_cast<size_t>(end_ - cur_) < len || std::memcmp(cur_, literal, len) != 0) {
+        return fail("JSON格式错误: 无效的字面量");
+    }
+    cur_ += len;
+    return true;
+}
+
+bool JsonBodyReader::readHex4(unsigned int& code) {
+    if (end_ - cur_ < 4) {
+        return fail("JSON格式错误: 不完整的\\u转义");
+    }
+    code = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = *cur_++;
+        code <<= 4;
+        if (c >= '0' && c <= '9') code |= c - '0';
+        else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+        else return fail("JSON格式错误: 无效的\\u转义");
+    }
+    return true;
+}
+
+// 读取字符串字面量（当前位置应为引号），转义序列直接解码到out
+bool JsonBodyReader::readStringToken(std::string& out) {
+    out.clear();
+    if (cur_ >= end_ || *cur_ != '"') {
+        return fail("JSON格式错误: 期望字符串");
+    }
+    ++cur_;
+
+    while (cur_ < end_) {
+        // 批量追加不含转义的连续片段
+        const char* start = cur_;
+        while (cur_ < end_ && *cur_ != '"' && *cur_ != '\\') {
+            ++cur_;
+        }
+        out.append(start, cur_ - start);
+        if (cur_ >= end_) {
+            break;
+        }
+        if (*cur_ == '"') {
+            ++cur_;
+            return true;
+        }
+
+        // 处理转义
+        ++cur_;
+        if (cur_ >= end_) {
+            break;
+        }
+        char esc = *cur_++;
+        switch (esc) {
+            case '"':  out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/':  out.push_back('/'); break;
+            case 'b':  out.push_back('\b'); break;
+            case 'f':  out.push_back('\f'); break;
+            case 'n':  out.push_back('\n'); break;
+            case 'r':  out.push_back('\r'); break;
+            case 't':  out.push_back('\t'); break;
+            case 'u': {
+                unsigned int code = 0;
+                if (!readHex4(code)) {
+                    return false;
+                }
+                // 代理对
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    unsigned int low = 0;
+                    if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') {
+                        return fail("JSON格式错误: 不完整的代理对");
+                    }
+                    cur_ += 2;
+                    if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                        return fail("JSON格式错误: 无效的代理对");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                // 编码为UTF-8
+                if (code < 0x80) {
+                    out.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else if (code < 0x10000) {
+                    out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return fail("JSON格式错误: 无效的转义字符");
+        }
+    }
+
+    return fail("JSON格式错误: 字符串未结束");
+}
+
+// 读取数字字面量的原始文本
+bool JsonBodyReader::readNumberToken(std::string& token) {
+    const char* start = cur_;
+    if (cur_ < end_ && *cur_ == '-') ++cur_;
+    while (cur_ < end_ && ((*cur_ >= '0' && *cur_ <= '9') || *cur_ == '.' || *cur_ == 'e' ||
+                           *cur_ == 'E' || *cur_ == '+' || *cur_ == '-')) {
+        ++cur_;
+    }
+    if (cur_ == start || (cur_ - start == 1 && *start == '-')) {
+        return fail("JSON格式错误: 无效的数字");
+    }
+    token.assign(start, cur_ - start);
+    return true;
+}
+
+bool JsonBodyReader::readObject(const std::function<bool(const std::string& key)>& handler) {
+    if (!expect('{')) {
+        return false;
+    }
+    if (++depth_ > MAX_NESTING_DEPTH) {
+        return fail("JSON嵌套层级过深");
+    }
+
+    std::string key;
+    skipWhitespace();
+    if (cur_ < end_ && *cur_ == '}') {
+        ++cur_;
+        --depth_;
+        return true;
+    }
+
+    while (true) {
+        skipWhitespace();
+        if (!readStringToken(key) || !expect(':')) {
+            return false;
+        }
+        skipWhitespace();
+        if (!handler(key)) {
+            if (hasError() || !skipValue()) {
+                return false;
+            }
+        } else if (hasError()) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (cur_ < end_ && *cur_ == ',') {
+            ++cur_;
+            continue;
+        }
+        if (!expect('}')) {
+            return false;
+        }
+        --depth_;
+        return true;
+    }
+}
+
+bool JsonBodyReader::readArray(const std::function<bool()>& handler) {
+    if (!expect('[')) {
+        return false;
+    }
+    if (++depth_ > MAX_NESTING_DEPTH) {
+        return fail("JSON嵌套层级过深");
+    }
+
+    skipWhitespace();
+    if (cur_ < end_ && *cur_ == ']') {
+        ++cur_;
+        --depth_;
+        return true;
+    }
+
+    while (true) {
+        skipWhitespace();
+        if (!handler()) {
+            if (hasError() || !skipValue()) {
+                return false;
+            }
+        } else if (hasError()) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (cur_ < end_ && *cur_ == ',') {
+            ++cur_;
+            continue;
+        }
+        if (!expect(']')) {
+            return false;
+        }
+        --depth_;
+        return true;
+    }
+}
+
+bool JsonBodyReader::readString(std::string& out) {
+    skipWhitespace();
+    if (cur_ >= end_) {
+        return fail("JSON格式错误: 缺少值");
+    }
+
+    switch (*cur_) {
+        case '"':
+            return readStringToken(out);
+        case 'n':
+            out.clear();
+            return matchLiteral("null");
+        case 't':
+            out = "true";
+            return matchLiteral("true");
+        case 'f':
+            out = "false";
+            return matchLiteral("false");
+        case '{':
+        case '[':
+            return fail("字段类型错误: 期望字符串");
+        default:
+            return readNumberToken(out);
+    }
+}
+
+bool JsonBodyReader::readInt64(int64_t& out) {
+    skipWhitespace();
+    if (cur_ >= end_) {
+        return fail("JSON格式错误: 缺少值");
+    }
+
+    std::string token;
+    if (*cur_ == '"') {
+        // 兼容以字符串形式传递的数字
+        if (!readStringToken(token)) {
+            return false;
+        }
+    } else if (*cur_ == 'n') {
+        out = 0;
+        return matchLiteral("null");
+    } else if (*cur_ == 't') {
+        out = 1;
+        return matchLiteral("true");
+    } else if (*cur_ == 'f') {
+        out = 0;
+        return matchLiteral("false");
+    } else if (!readNumberToken(token)) {
+        return false;
+    }
+
+    errno = 0;
+    char* parse_end = nullptr;
+    if (token.find_first_of(".eE") != std::string::npos) {
+        // 只接受值为整数的小数和指数形式（如 2.0、1e3）；超出 int64 范围的转换是未定义行为，须先检查
+        double value = std::strtod(token.c_str(), &parse_end);
+        if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0) || std::floor(value) != value) {
+            return fail("字段类型错误: 期望整数");
+        }
+        out = static_cast<int64_t>(value);
+    } else {
+        out = std::strtoll(token.c_str(), &parse_end, 10);
+    }
+    if (token.empty() || errno == ERANGE || parse_end == nullptr || *parse_end != '\0') {
+        return fail("字段类型错误: 期望整数");
+    }
+    return true;
+}
+
+bool JsonBodyReader::readInt(int& out) {
+    int64_t value = 0;
+    if (!readInt64(value)) {
+        return false;
+    }
+    if (value < INT32_MIN || value > INT32_MAX) {
+        return fail("字段类型错误: 整数超出范围");
+    }
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool JsonBodyReader::readBool(bool& out) {
+    skipWhitespace();
+    if (cur_ >= end_) {
+        return fail("JSON格式错误: 缺少值");
+    }
+
+    if (*cur_ == 't') {
+        out = true;
+        return matchLiteral("true");
+    }
+    if (*cur_ == 'f' || *cur_ == 'n') {
+        out = false;
+        return matchLiteral(*cur_ == 'f' ? "false" : "null");
+    }
+    if (*cur_ == '"' || *cur_ == '{' || *cur_ == '[') {
+        return fail("字段类型错误: 期望布尔值");
+    }
+
+    // 数字按非零为真处理
+    std::string token;
+    if (!readNumberToken(token)) {
+        return false;
+    }
+    out = std::strtod(token.c_str(), nullptr) != 0.0;
+    return true;
+}
+
+bool JsonBodyReader::skipValue() {
+    skipWhitespace();
+    if (cur_ >= end_) {
+        return fail("JSON格式错误: 缺少值");
+    }
+
+    switch (*cur_) {
+        case '{':
+            return readObject([](const std::string&) { return false; });
+        case '[':
+            return readArray([]() { return false; });
+        case '"': {
+            // 跳过字符串时不做解码
+            ++cur_;
+            while (cur_ < end_ && *cur_ != '"') {
+                if (*cur_ == '\\') {
+                    ++cur_;
+                }
+                ++cur_;
+            }
+            if (cur_ >= end_) {
+                return fail("JSON格式错误: 字符串未结束");
+            }
+            ++cur_;
+            return true;
+        }
+        case 't':
+            return matchLiteral("true");
+        case 'f':
+            return matchLiteral("false");
+        case 'n':
+            return matchLiteral("null");
+        default: {
+            std::string token;
+            return readNumberToken(token);
+        }
+    }
+}
+
+bool JsonBodyReader::finish() {
+    if (hasError()) {
+        return false;
+    }
+    skipWhitespace();
+    if (cur_ != end_) {
+        return fail("JSON格式错误: 存在多余内容");
+    }
+    return true;
+}
+
+// RequestBodyParser 实现
+
+bool RequestBodyParser::finishParse(JsonBodyReader& reader, bool ok, std::string& error_message) {
+    if (!ok || !reader.finish()) {
+        error_message = reader.hasError() ? reader.getError() : "JSON格式错误";
+        return false;
+    }
+    return true;
+}
+
+bool RequestBodyParser::readTestCase(JsonBodyReader& reader, TestCase& testcase, std::set<std::string>* fields) {
+    return reader.readObject([&](const std::string& key) {
+        bool handled = true;
+        if (key == "id") {
+            reader.readInt(testcase.id);
+        } else if (key == "problem_id") {
+            reader.readInt(testcase.problem_id);
+        } else if (key == "input") {
+            reader.readString(testcase.input);
+        } else if (key == "expected_output") {
+            reader.readString(testcase.expected_output);
+        } else if (key == "is_example") {
+            reader.readBool(testcase.is_example);
+        } else if (key == "created_at") {
+            reader.readInt64(testcase.created_at);
+        } else {
+            handled = false;
+        }
+        if (handled && fields) {
+            fields->insert(key);
+        }
+        return handled;
+    });
+}
+
+bool RequestBodyParser::parseProblem(const std::string& body, Problem& problem, std::set<std::string>& fields, std::string& error_message) {
+    JsonBodyReader reader(body);
+    std::string str_value;
+    int int_value = 0;
+    int64_t int64_value = 0;
+    bool deleting_status = false;
+
+    bool ok = reader.readObject([&](const std::string& key) {
+        bool handled = true;
+        if (key == "title") {
+            if (reader.readString(str_value)) problem.setTitle(str_value);
+        } else if (key == "description") {
+            if (reader.readString(str_value)) problem.setDescription(str_value);
+        } else if (key == "input_format") {
+            if (reader.readString(str_value)) problem.setInputFormat(str_value);
+        } else if (key == "output_format") {
+            if (reader.readString(str_value)) problem.setOutputFormat(str_value);
+        } else if (key == "difficulty") {
+            if (reader.readString(str_value)) problem.setDifficulty(str_value);
+        } else if (key == "example_input") {
+            if (reader.readString(str_value)) problem.setExampleInput(str_value);
+        } else if (key == "example_output") {
+            if (reader.readString(str_value)) problem.setExampleOutput(str_value);
+        } else if (key == "hint") {
+            if (reader.readString(str_value)) problem.setHint(str_value);
+        } else if (key == "code_template") {
+            if (reader.readString(str_value)) problem.setCodeTemplate(str_value);
+        } else if (key == "id") {
+            if (reader.readInt(int_value)) problem.setId(int_value);
+        } else if (key == "time_limit") {
+            if (reader.readInt(int_value)) problem.setTimeLimit(int_value);
+        } else if (key == "memory_limit") {
+            if (reader.readInt(int_value)) problem.setMemoryLimit(int_value);
+        } else if (key == "created_by") {
+            if (reader.readInt(int_value)) problem.setCreatedBy(int_value);
+        } else if (key == "status") {
+            // 删除中状态只由删除流程设置
+            if (reader.readInt(int_value)) {
+                deleting_status = int_value == PROBLEM_STATUS_DELETING;
+                problem.setStatus(int_value);
+            }
+        } else if (key == "created_at") {
+            if (reader.readInt64(int64_value)) problem.setCreatedAt(int64_value);
+        } else if (key == "updated_at") {
+            if (reader.readInt64(int64_value)) problem.setUpdatedAt(int64_value);
+        } else if (key == "testcases") {
+            // 测试用例数组，逐个读入后直接追加到题目中
+            reader.readArray([&]() {
+                TestCase testcase = TestCase();
+                if (readTestCase(reader, testcase, nullptr)) {
+                    problem.addTestCase(testcase);
+                }
+                return true;
+            });
+        } else {
+            handled = false;
+        }
+        if (handled) {
+            fields.insert(key);
+        }
+        return handled;
+    });
+
+    if (ok && deleting_status) {
+        error_message = "无效的题目状态";
+        return false;
+    }
+    return finishParse(reader, ok, error_message);
+}
+
+bool RequestBodyParser::parseTestCase(const std::string& body, TestCase& testcase, std::set<std::string>& fields, std::string& error_message) {
+    JsonBodyReader reader(body);
+    bool ok = readTestCase(reader, testcase, &fields);
+    return finishParse(reader, ok, error_message);
+}
+
+bool RequestBodyParser::parseSubmission(const std::string& body, Submission& submission, std::set<std::string>& fields, std::string& error_message) {
+    JsonBodyReader reader(body);
+    std::string str_value;
+    int int_value = 0;
+
+    bool ok = reader.readObject([&](const std::string& key) {
+        bool handled = true;
+        if (key == "problem_id") {
+            if (reader.readInt(int_value)) submission.setProblemId(int_value);
+        } else if (key == "code") {
+            if (reader.readString(str_value)) submission.setSourceCode(str_value);
+        } else if (key == "language") {
+            if (reader.readString(str_value)) submission.setLanguage(str_value);
+        } else {
+            handled = false;
+        }
+        if (handled) {
+            fields.insert(key);
+        }
+        return handled;
+    });
+
+    return finishParse(reader, ok, error_message);
+}
+
+bool RequestBodyParser::parseDiscussion(const std::string& body, Discussion& discussion, std::set<std::string>& fields, std::string& error_message) {
+    JsonBodyReader reader(body);
+    std::string str_value;
+    int int_value = 0;
+
+    bool ok = reader.readObject([&](const std::string& key) {
+        bool handled = true;
+        if (key == "title") {
+            if (reader.readString(str_value)) discussion.setTitle(str_value);
+        } else if (key == "content") {
+            if (reader.readString(str_value)) discussion.setContent(str_value);
+        } else if (key == "problem_id") {
+            if (reader.readInt(int_value)) discussion.setProblemId(int_value);
+        } else {
+            handled = false;
+        }
+        if (handled) {
+            fields.insert(key);
+        }
+        return handled;
+    });
+
+    return finishParse(reader, ok, error_message);
+}
+
+bool RequestBodyParser::parseDiscussionReply(const std::string& body, DiscussionReply& reply, std::set<std::string>& fields, std::string& error_message) {
+    JsonBodyReader reader(body);
+    std::string str_value;
+    int int_value = 0;
+
+    bool ok = reader.readObject([&](const std::string& key) {
+        bool handled = true;
+        if (key == "content") {
+            if (reader.readString(str_value)) reply.setContent(str_value);
+        } else if (key == "parent_id") {
+            if (reader.readInt(int_value)) reply.setParentId(int_value);
+        } else {
+            handled = false;
+        }
+        if (handled) {
+            fields.insert(key);
+        }
+        return handled;
+    });
+
+    return finishParse(reader, ok, error_message);
+}
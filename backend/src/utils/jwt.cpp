@@ -1,124 +1,247 @@
 #include "../../include/utils/jwt.h"
-#include <openssl/hmac.h>
-#include <openssl/sha.h>
-#include <openssl/bio.h>
+#include "../../include/utils/token_cache.h"
+#include "../../include/utils/jwt_keys.h"
+#include "../../include/http/json_writer.h"
 #include <openssl/evp.h>
-#include <openssl/buffer.h>
+#include <openssl/sha.h>
+#include <openssl/crypto.h>
 #include <ctime>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-#include <vector>
-#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
 #include <json/json.h>
 
 // 初始化密钥
 std::string JWT::secret_key = "cplus_web_secret_key_for_jwt_token";
 
-// Base64编码
-std::string JWT::base64_encode(const std::string& data) {
-    BIO* b64 = BIO_new(BIO_f_base64());
-    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL); // 禁止添加换行符
-    BIO* bmem = BIO_new(BIO_s_mem());
-    b64 = BIO_push(b64, bmem);
-    BIO_write(b64, data.c_str(), data.length());
-    BIO_flush(b64);
-    
-    BUF_MEM* bptr;
-    BIO_get_mem_ptr(b64, &bptr);
-    
-    std::string result(bptr->data, bptr->length); // 不再需要减1，因为没有换行符
-    BIO_free_all(b64);
-    
-    // 替换URL安全的Base64字符
-    std::replace(result.begin(), result.end(), '+', '-');
-    std::replace(result.begin(), result.end(), '/', '_');
-    std::replace(result.begin(), result.end(), '=', ' ');
-    
-    // 去除尾部空格
-    result.erase(result.find_last_not_of(' ') + 1);
-    
-    return result;
+namespace {
+    // 密钥版本，更换密钥后各线程重新计算HMAC状态
+    std::atomic<unsigned> key_generation(1);
+
+    const char BASE64URL_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    // base64url解码表，-1表示非法字符
+    struct Base64DecodeTable {
+        signed char values[256];
+        Base64DecodeTable() {
+            std::memset(values, -1, sizeof(values));
+            for (int i = 0; i < 64; i++) {
+                values[static_cast<unsigned char>(BASE64URL_CHARS[i])] = static_cast<signed char>(i);
+            }
+        }
+    };
+    const Base64DecodeTable BASE64_DECODE_TABLE;
+
+    const char JWT_HEADER_JSON[] = "{\"alg\":\"HS256\",\"typ\":\"JWT\"}";
+    const size_t HMAC_BLOCK_SIZE = 64;
+    const size_t SIGNATURE_SIZE = 32;
+
+    // 每个线程预先计算的HMAC状态
+    // 密钥与ipad/opad异或后的首个分组只在密钥变化时哈希一次，之后每次签名只复制这两个SHA256中间状态
+    struct HmacState {
+        unsigned generation = 0;
+        EVP_MD_CTX* inner = nullptr;
+        EVP_MD_CTX* outer = nullptr;
+        EVP_MD_CTX* work = nullptr;
+
+        ~HmacState() {
+            EVP_MD_CTX_free(inner);
+            EVP_MD_CTX_free(outer);
+            EVP_MD_CTX_free(work);
+        }
+
+        bool prepare(const std::string& key) {
+            unsigned current = key_generation.load();
+            if (generation == current) {
+                return true;
+            }
+            if (!inner) {
+                inner = EVP_MD_CTX_new();
+                outer = EVP_MD_CTX_new();
+                work = EVP_MD_CTX_new();
+                if (!inner || !outer || !work) {
+                    return false;
+                }
+            }
+
+            // 超过分组长度的密钥先做一次哈希
+            unsigned char key_block[HMAC_BLOCK_SIZE] = {0};
+            if (key.size() > HMAC_BLOCK_SIZE) {
+                SHA256(reinterpret_cast<const unsigned char*>(key.data()), key.size(), key_block);
+            } else {
+                std::memcpy(key_block, key.data(), key.size());
+            }
+
+            unsigned char ipad[HMAC_BLOCK_SIZE];
+            unsigned char opad[HMAC_BLOCK_SIZE];
+            for (size_t i = 0; i < HMAC_BLOCK_SIZE; i++) {
+                ipad[i] = key_block[i] ^ 0x36;
+                opad[i] = key_block[i] ^ 0x5c;
+            }
+
+            if (EVP_DigestInit_ex(inner, EVP_sha256(), nullptr) != 1 ||
+                EVP_DigestUpdate(inner, ipad, HMAC_BLOCK_SIZE) != 1 ||
+                EVP_DigestInit_ex(outer, EVP_sha256(), nullptr) != 1 ||
+                EVP_DigestUpdate(outer, opad, HMAC_BLOCK_SIZE) != 1) {
+                return false;
+            }
+            generation = current;
+            return true;
+        }
+    };
+
+    HmacState& hmacState() {
+        static thread_local HmacState state;
+        return state;
+    }
+
+    // 每个线程复用的JSON解析器
+    Json::CharReader& payloadReader() {
+        static thread_local std::unique_ptr<Json::CharReader> reader;
+        if (!reader) {
+            Json::CharReaderBuilder builder;
+            reader.reset(builder.newCharReader());
+        }
+        return *reader;
+    }
 }
 
-// Base64解码
-std::string JWT::base64_decode(const std::string& data) {
-    std::string base64 = data;
-    
-    // 替换回标准Base64字符
-    std::replace(base64.begin(), base64.end(), '-', '+');
-    std::replace(base64.begin(), base64.end(), '_', '/');
-    
-    // 添加适当的填充
-    while (base64.length() % 4 != 0) {
-        base64.push_back('=');
+// Base64url编码
+void JWT::base64_encode(const unsigned char* data, size_t length, std::string& out) {
+    out.reserve(out.size() + (length + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 2 < length; i += 3) {
+        unsigned int n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out.push_back(BASE64URL_CHARS[(n >> 18) & 0x3f]);
+        out.push_back(BASE64URL_CHARS[(n >> 12) & 0x3f]);
+        out.push_back(BASE64URL_CHARS[(n >> 6) & 0x3f]);
+        out.push_back(BASE64URL_CHARS[n & 0x3f]);
+    }
+
+    // 剩余1或2个字节，不输出填充字符
+    if (i + 1 == length) {
+        unsigned int n = data[i] << 16;
+        out.push_back(BASE64URL_CHARS[(n >> 18) & 0x3f]);
+        out.push_back(BASE64URL_CHARS[(n >> 12) & 0x3f]);
+    } else if (i + 2 == length) {
+        unsigned int n = (data[i] << 16) | (data[i + 1] << 8);
+        out.push_back(BASE64URL_CHARS[(n >> 18) & 0x3f]);
+        out.push_back(BASE64URL_CHARS[(n >> 12) & 0x3f]);
+        out.push_back(BASE64URL_CHARS[(n >> 6) & 0x3f]);
     }
-    
-    BIO* b64 = BIO_new(BIO_f_base64());
-    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL); // 禁止换行符检查
-    BIO* bmem = BIO_new_mem_buf(base64.c_str(), base64.length());
-    bmem = BIO_push(b64, bmem);
-    
-    std::vector<char> buffer(base64.length());
-    int decoded_length = BIO_read(bmem, buffer.data(), base64.length());
-    BIO_free_all(bmem);
-    
-    return std::string(buffer.data(), decoded_length);
 }
 
-// 创建HMAC签名
-std::string JWT::create_signature(const std::string& header, const std::string& payload) {
-    std::string data = header + "." + payload;
-    
-    unsigned char hmac[EVP_MAX_MD_SIZE];
-    unsigned int hmac_len;
-    
-    HMAC(EVP_sha256(), secret_key.c_str(), secret_key.length(),
-         reinterpret_cast<const unsigned char*>(data.c_str()), data.length(),
-         hmac, &hmac_len);
-    
-    return std::string(reinterpret_cast<char*>(hmac), hmac_len);
+// Base64url解码
+bool JWT::base64_decode(const char* data, size_t length, std::string& out) {
+    // 兼容带填充的输入
+    while (length > 0 && data[length - 1] == '=') {
+        length--;
+    }
+    if (length % 4 == 1) {
+        return false;
+    }
+
+    out.clear();
+    out.reserve(length * 3 / 4);
+
+    unsigned int buffer = 0;
+    int bits = 0;
+    for (size_t i = 0; i < length; i++) {
+        signed char value = BASE64_DECODE_TABLE.values[static_cast<unsigned char>(data[i])];
+        if (value < 0) {
+            return false;
+        }
+        buffer = (buffer << 6) | static_cast<unsigned int>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((buffer >> bits) & 0xff));
+        }
+    }
+    return true;
+}
+
+// 创建HMAC-SHA256签名
+bool JWT::create_signature(const char* data, size_t length, unsigned char* signature) {
+    HmacState& state = hmacState();
+    if (!state.prepare(secret_key)) {
+        std::cerr << "初始化HMAC状态失败" << std::endl;
+        return false;
+    }
+
+    unsigned char inner_hash[SIGNATURE_SIZE];
+    unsigned int hash_len = 0;
+    return EVP_MD_CTX_copy_ex(state.work, state.inner) == 1 &&
+           EVP_DigestUpdate(state.work, data, length) == 1 &&
+           EVP_DigestFinal_ex(state.work, inner_hash, &hash_len) == 1 &&
+           EVP_MD_CTX_copy_ex(state.work, state.outer) == 1 &&
+           EVP_DigestUpdate(state.work, inner_hash, SIGNATURE_SIZE) == 1 &&
+           EVP_DigestFinal_ex(state.work, signature, &hash_len) == 1;
 }
 
 // 设置密钥
 void JWT::setSecretKey(const std::string& key) {
     secret_key = key;
+    key_generation++;
+    TokenCache::clear();
 }
 
 // 生成JWT Token
 std::string JWT::generateToken(const std::map<std::string, std::string>& payload_data, long expiry) {
-    // 构建头部
-    Json::Value header;
-    header["alg"] = "HS256";
-    header["typ"] = "JWT";
-    
-    Json::StreamWriterBuilder writer_builder;
-    writer_builder["indentation"] = "";
-    std::string header_str = Json::writeString(writer_builder, header);
-    
-    // 构建负载
-    Json::Value payload;
+    // 直接拼接负载JSON，值统一为字符串（与验证端的解析方式一致）
+    time_t now = time(nullptr);
+    std::string payload = "{";
     for (const auto& item : payload_data) {
-        payload[item.first] = item.second;
+        if (item.first == "exp" || item.first == "iat") {
+            continue;
+        }
+        http::JsonWriter::writeString(item.first, payload);
+        payload.push_back(':');
+        http::JsonWriter::writeString(item.second, payload);
+        payload.push_back(',');
     }
-    
-    // 添加过期时间
-    time_t now = time(nullptr);
-    payload["exp"] = std::to_string(now + expiry);
-    payload["iat"] = std::to_string(now);
-    
-    std::string payload_str = Json::writeString(writer_builder, payload);
-    
+    payload += "\"exp\":\"" + std::to_string(now + expiry) + "\",\"iat\":\"" + std::to_string(now) + "\"}";
+
+    // 配置了非对称密钥时使用私钥签名，头部带上kid
+    std::shared_ptr<const JwtKey> signing_key = JwtKeyStore::signingKey();
+    if (signing_key) {
+        std::string header = "{\"alg\":\"" + signing_key->alg + "\",\"kid\":";
+        http::JsonWriter::writeString(signing_key->kid, header);
+        header += ",\"typ\":\"JWT\"}";
+
+        std::string token;
+        base64_encode(reinterpret_cast<const unsigned char*>(header.data()), header.size(), token);
+        token.push_back('.');
+        base64_encode(reinterpret_cast<const unsigned char*>(payload.data()), payload.size(), token);
+
+        std::string signature;
+        if (!JwtKeyStore::sign(*signing_key, token.data(), token.size(), signature)) {
+            std::cerr << "JWT签名失败，密钥ID: " << signing_key->kid << std::endl;
+            return "";
+        }
+        token.push_back('.');
+        base64_encode(reinterpret_cast<const unsigned char*>(signature.data()), signature.size(), token);
+        return token;
+    }
+
     // 编码头部和负载
-    std::string encoded_header = base64_encode(header_str);
-    std::string encoded_payload = base64_encode(payload_str);
-    
+    std::string token;
+    token.reserve((sizeof(JWT_HEADER_JSON) + payload.size()) * 4 / 3 + 64);
+    base64_encode(reinterpret_cast<const unsigned char*>(JWT_HEADER_JSON), sizeof(JWT_HEADER_JSON) - 1, token);
+    token.push_back('.');
+    base64_encode(reinterpret_cast<const unsigned char*>(payload.data()), payload.size(), token);
+
     // 创建签名
-    std::string signature = create_signature(encoded_header, encoded_payload);
-    std::string encoded_signature = base64_encode(signature);
-    
-    // 组合JWT
-    return encoded_header + "." + encoded_payload + "." + encoded_signature;
+    unsigned char signature[SIGNATURE_SIZE];
+    if (!create_signature(token.data(), token.size(), signature)) {
+        return "";
+    }
+    token.push_back('.');
+    base64_encode(signature, SIGNATURE_SIZE, token);
+
+    return token;
 }
 
 // 验证JWT Token
@@ -126,71 +249,122 @@ bool JWT::verifyToken(const std::string& token, std::map<std::string, std::strin
     // 分割Token
     size_t first_dot = token.find('.');
     size_t last_dot = token.rfind('.');
-    
+
     if (first_dot == std::string::npos || last_dot == std::string::npos || first_dot == last_dot) {
         return false;
     }
-    
-    std::string encoded_header = token.substr(0, first_dot);
-    std::string encoded_payload = token.substr(first_dot + 1, last_dot - first_dot - 1);
-    std::string encoded_signature = token.substr(last_dot + 1);
-    
-    // 验证签名
-    std::string expected_signature = create_signature(encoded_header, encoded_payload);
-    std::string actual_signature = base64_decode(encoded_signature);
-    
-    if (expected_signature != actual_signature) {
-        return false;
+
+    static thread_local std::string buffer;
+    if (JwtKeyStore::enabled()) {
+        // 非对称模式：按头部的alg和kid选择公钥，不再接受HS256令牌
+        Json::Value header;
+        std::string errors;
+        if (!base64_decode(token.data(), first_dot, buffer) ||
+            !payloadReader().parse(buffer.data(), buffer.data() + buffer.size(), &header, &errors) ||
+            !header.isObject() || !header["alg"].isString()) {
+            return false;
+        }
+        std::string kid = header["kid"].isString() ? header["kid"].asString() : "";
+        std::shared_ptr<const JwtKey> key = kid.empty() ? JwtKeyStore::signingKey() : JwtKeyStore::findKey(kid);
+        if (!key || key->alg != header["alg"].asString()) {
+            return false;
+        }
+        if (!base64_decode(token.data() + last_dot + 1, token.size() - last_dot - 1, buffer) ||
+            !JwtKeyStore::verify(*key, token.data(), last_dot, buffer)) {
+            return false;
+        }
+    } else {
+        // 验证签名（常量时间比较，避免通过响应时间推测签名）
+        if (!base64_decode(token.data() + last_dot + 1, token.size() - last_dot - 1, buffer) ||
+            buffer.size() != SIGNATURE_SIZE) {
+            return false;
+        }
+
+        unsigned char expected_signature[SIGNATURE_SIZE];
+        if (!create_signature(token.data(), last_dot, expected_signature) ||
+            CRYPTO_memcmp(expected_signature, buffer.data(), SIGNATURE_SIZE) != 0) {
+            return false;
+        }
     }
-    
+
     // 解析负载
-    std::string payload_str = base64_decode(encoded_payload);
-    
-    Json::CharReaderBuilder reader_builder;
+    if (!base64_decode(token.data() + first_dot + 1, last_dot - first_dot - 1, buffer)) {
+        return false;
+    }
+
     Json::Value payload;
-    std::istringstream payload_stream(payload_str);
     std::string errors;
-    
-    if (!Json::parseFromStream(reader_builder, payload_stream, &payload, &errors)) {
+    if (!payloadReader().parse(buffer.data(), buffer.data() + buffer.size(), &payload, &errors) ||
+        !payload.isObject()) {
         return false;
     }
-    
+
     // 检查令牌是否过期
     if (payload.isMember("exp")) {
-        long exp_time = std::stol(payload["exp"].asString());
+        long exp_time = std::atol(payload["exp"].asString().c_str());
         time_t now = time(nullptr);
-        
+
         if (now > exp_time) {
             return false;
         }
     }
-    
+
     // 提取负载数据
-    for (const auto& key : payload.getMemberNames()) {
-        out_payload[key] = payload[key].asString();
+    for (auto it = payload.begin(); it != payload.end(); ++it) {
+        out_payload[it.name()] = it->isConvertibleTo(Json::stringValue) ? it->asString() : "";
     }
-    
+
     return true;
 }
 
+// 解析整数声明，缺失或格式错误时返回-1
+static int parseIntClaim(const std::map<std::string, std::string>& payload, const std::string& key) {
+    auto it = payload.find(key);
+    if (it == payload.end()) {
+        return -1;
+    }
+    try {
+        return std::stoi(it->second);
+    } catch (const std::exception& e) {
+        return -1;
+    }
+}
+
+// 验证令牌并缓存声明
+std::shared_ptr<const TokenClaims> JWT::verifyClaims(const std::string& token) {
+    std::shared_ptr<const TokenClaims> cached = TokenCache::get(token);
+    if (cached) {
+        return cached;
+    }
+    
+    std::shared_ptr<TokenClaims> claims = std::make_shared<TokenClaims>();
+    if (!verifyToken(token, claims->payload)) {
+        return nullptr;
+    }
+    
+    claims->user_id = parseIntClaim(claims->payload, "user_id");
+    claims->role = parseIntClaim(claims->payload, "role");
+    auto username_it = claims->payload.find("username");
+    if (username_it != claims->payload.end()) {
+        claims->username = username_it->second;
+    }
+    auto exp_it = claims->payload.find("exp");
+    if (exp_it != claims->payload.end()) {
+        claims->exp = std::atol(exp_it->second.c_str());
+    }
+    
+    TokenCache::put(token, claims);
+    return claims;
+}
+
 // 从令牌中获取用户ID
 int JWT::getUserIdFromToken(const std::string& token) {
-    std::map<std::string, std::string> payload;
-    if (verifyToken(token, payload)) {
-        if (payload.find("user_id") != payload.end()) {
-            return std::stoi(payload["user_id"]);
-        }
-    }
-    return -1;
+    std::shared_ptr<const TokenClaims> claims = verifyClaims(token);
+    return claims ? claims->user_id : -1;
 }
 
 // 从令牌中获取用户角色
 int JWT::getUserRoleFromToken(const std::string& token) {
-    std::map<std::string, std::string> payload;
-    if (verifyToken(token, payload)) {
-        if (payload.find("role") != payload.end()) {
-            return std::stoi(payload["role"]);
-        }
-    }
-    return -1;
+    std::shared_ptr<const TokenClaims> claims = verifyClaims(token);
+    return claims ? claims->role : -1;
 } 
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "../../include/utils/jwt_keys.h"
+#include "../../include/utils/jwt.h"
+#include "../../include/utils/token_cache.h"
+#include <openssl/pem.h>
+#include <openssl/bio.h>
+#include <openssl/ecdsa.h>
+#include <openssl/bn.h>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace {
+    // 密钥集合快照，加载新密钥时整体替换
+    struct KeySet {
+        std::shared_ptr<const JwtKey> signing_key;
+        std::map<std::string, std::shared_ptr<const JwtKey>> keys;
+    };
+
+    std::mutex key_set_mutex;
+    std::shared_ptr<const KeySet> current_key_set;
+
+    std::shared_ptr<const KeySet> snapshot() {
+        std::lock_guard<std::mutex> lock(key_set_mutex);
+        return current_key_set;
+    }
+
+    const size_t ES256_PART_SIZE = 32;
+    // P-256公钥的SubjectPublicKeyInfo DER长度，末尾65字节为 0x04||X||Y
+    const int P256_SPKI_SIZE = 91;
+
+    std::string base64url(const unsigned char* data, size_t length) {
+        std::string out;
+        JWT::base64_encode(data, length, out);
+        return out;
+    }
+
+    // 密钥ID取文件名（不含目录和扩展名）
+    std::string keyIdFromPath(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        size_t dot = name.find('.');
+        return dot == std::string::npos ? name : name.substr(0, dot);
+    }
+
+    // 读取PEM文件，优先按私钥解析，其次按公钥解析
+    EVP_PKEY* readPemKey(const std::string& path, bool& has_private, std::string& error_message) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error_message = "无法打开密钥文件: " + path;
+            return nullptr;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string pem = buffer.str();
+
+        BIO* bio = BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+        EVP_PKEY* pkey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
+        has_private = pkey != nullptr;
+        if (!pkey) {
+            BIO_free(bio);
+            bio = BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+            pkey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+        }
+        BIO_free(bio);
+
+        if (!pkey) {
+            error_message = "无法解析密钥文件: " + path;
+        }
+        return pkey;
+    }
+
+    // 根据密钥类型确定算法并生成JWK
+    std::shared_ptr<JwtKey> buildKey(EVP_PKEY* pkey, bool has_private, const std::string& kid, std::string& error_message) {
+        std::shared_ptr<JwtKey> key = std::make_shared<JwtKey>();
+        key->kid = kid;
+        key->pkey.reset(pkey, EVP_PKEY_free);
+        key->has_private = has_private;
+
+        Json::Value jwk;
+        jwk["kid"] = kid;
+        jwk["use"] = "sig";
+
+        if (EVP_PKEY_id(pkey) == EVP_PKEY_ED25519) {
+            unsigned char raw[32];
+            size_t raw_len = sizeof(raw);
+            if (EVP_PKEY_get_raw_public_key(pkey, raw, &raw_len) != 1 || raw_len != sizeof(raw)) {
+                error_message = "读取Ed25519公钥失败: " + kid;
+                return nullptr;
+            }
+            key->alg = "EdDSA";
+            jwk["kty"] = "OKP";
+            jwk["crv"] = "Ed25519";
+            jwk["x"] = base64url(raw, raw_len);
+        } else if (EVP_PKEY_id(pkey) == EVP_PKEY_EC) {
+            // 只支持P-256，通过公钥DER的固定布局取出坐标，避免依赖不同OpenSSL版本的EC接口
+            unsigned char* der = nullptr;
+            int der_len = i2d_PUBKEY(pkey, &der);
+            if (der_len != P256_SPKI_SIZE || der[der_len - 65] != 0x04 || EVP_PKEY_bits(pkey) != 256) {
+                OPENSSL_free(der);
+                error_message = "EC密钥必须使用P-256曲线: " + kid;
+                return nullptr;
+            }
+            const unsigned char* point = der + der_len - 64;
+            key->alg = "ES256";
+            jwk["kty"] = "EC";
+            jwk["crv"] = "P-256";
+            jwk["x"] = base64url(point, ES256_PART_SIZE);
+            jwk["y"] = base64url(point + ES256_PART_SIZE, ES256_PART_SIZE);
+            OPENSSL_free(der);
+        } else {
+            error_message = "不支持的密钥类型（仅支持P-256和Ed25519）: " + kid;
+            return nullptr;
+        }
+
+        jwk["alg"] = key->alg;
+        key->jwk = jwk;
+        return key;
+    }
+
+    std::shared_ptr<JwtKey> loadKeyFile(const std::string& path, std::string& error_message) {
+        bool has_private = false;
+        EVP_PKEY* pkey = readPemKey(path, has_private, error_message);
+        if (!pkey) {
+            return nullptr;
+        }
+        // pkey 在 buildKey 中交给 shared_ptr 管理，失败时随之释放
+        return buildKey(pkey, has_private, keyIdFromPath(path), error_message);
+    }
+}
+
+bool JwtKeyStore::load(const std::string& signing_key_file, const std::vector<std::string>& verify_key_files,
+                       std::string& error_message) {
+    std::shared_ptr<KeySet> key_set = std::make_shared<KeySet>();
+
+    std::shared_ptr<JwtKey> signing_key = loadKeyFile(signing_key_file, error_message);
+    if (!signing_key) {
+        return false;
+    }
+    if (!signing_key->has_private) {
+        error_message = "签名密钥文件不包含私钥: " + signing_key_file;
+        return false;
+    }
+    key_set->signing_key = signing_key;
+    key_set->keys[signing_key->kid] = signing_key;
+
+    for (const auto& path : verify_key_files) {
+        std::shared_ptr<JwtKey> key = loadKeyFile(path, error_message);
+        if (!key) {
+            return false;
+        }
+        if (key_set->keys.count(key->kid)) {
+            error_message = "密钥ID重复: " + key->kid;
+            return false;
+        }
+        key_set->keys[key->kid] = key;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(key_set_mutex);
+        current_key_set = key_set;
+    }
+    // 已缓存的验证结果可能来自被移除的密钥
+    TokenCache::clear();
+
+    std::cout << "JWT使用" << signing_key->alg << "签名，当前密钥ID: " << signing_key->kid
+              << "，可验证密钥数: " << key_set->keys.size() << std::endl;
+    return true;
+}
+
+bool JwtKeyStore::enabled() {
+    return snapshot() != nullptr;
+}
+
+std::shared_ptr<const JwtKey> JwtKeyStore::signingKey() {
+    std::shared_ptr<const KeySet> key_set = snapshot();
+    return key_set ? key_set->signing_key : nullptr;
+}
+
+std::shared_ptr<const JwtKey> JwtKeyStore::findKey(const std::string& kid) {
+    std::shared_ptr<const KeySet> key_set = snapshot();
+    if (!key_set) {
+        return nullptr;
+    }
+    auto it = key_set->keys.find(kid);
+    return it != key_set->keys.end() ? it->second : nullptr;
+}
+
+Json::Value JwtKeyStore::jwks() {
+    Json::Value result;
+    result["keys"] = Json::Value(Json::arrayValue);
+
+    std::shared_ptr<const KeySet> key_set = snapshot();
+    if (key_set) {
+        // 当前签名密钥排在首位
+        result["keys"].append(key_set->signing_key->jwk);
+        for (const auto& item : key_set->keys) {
+            if (item.second != key_set->signing_key) {
+                result["keys"].append(item.second->jwk);
+            }
+        }
+    }
+    return result;
+}
+
+bool JwtKeyStore::sign(const JwtKey& key, const char* data, size_t length, std::string& signature) {
+    if (!key.has_private) {
+        return false;
+    }
+
+    bool is_ec = key.alg == "ES256";
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+
+    // Ed25519不使用单独的摘要算法
+    size_t sig_len = 0;
+    bool ok = EVP_DigestSignInit(ctx, nullptr, is_ec ? EVP_sha256() : nullptr, nullptr, key.pkey.get()) == 1 &&
+              EVP_DigestSign(ctx, nullptr, &sig_len, reinterpret_cast<const unsigned char*>(data), length) == 1;
+
+    std::string raw(sig_len, '\0');
+    ok = ok && EVP_DigestSign(ctx, reinterpret_cast<unsigned char*>(&raw[0]), &sig_len,
+                              reinterpret_cast<const unsigned char*>(data), length) == 1;
+    EVP_MD_CTX_free(ctx);
+    if (!ok) {
+        return false;
+    }
+    raw.resize(sig_len);
+
+    if (!is_ec) {
+        signature.swap(raw);
+        return true;
+    }
+
+    // ECDSA签名为DER编码，JWS要求转换为定长的 R||S
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(raw.data());
+    ECDSA_SIG* sig = d2i_ECDSA_SIG(nullptr, &p, static_cast<long>(raw.size()));
+    if (!sig) {
+        return false;
+    }
+    const BIGNUM* r = nullptr;
+    const BIGNUM* s = nullptr;
+    ECDSA_SIG_get0(sig, &r, &s);
+
+    signature.assign(ES256_PART_SIZE * 2, '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&signature[0]);
+    ok = BN_bn2binpad(r, out, ES256_PART_SIZE) == static_cast<int>(ES256_PART_SIZE) &&
+         BN_bn2binpad(s, out + ES256_PART_SIZE, ES256_PART_SIZE) == static_cast<int>(ES256_PART_SIZE);
+    ECDSA_SIG_free(sig);
+    return ok;
+}
+
+bool JwtKeyStore::verify(const JwtKey& key, const char* data, size_t length, const std::string& signature) {
+    if (signature.size() != ES256_PART_SIZE * 2) {
+        return false;
+    }
+
+    bool is_ec = key.alg == "ES256";
+    std::string der_signature;
+    if (is_ec) {
+        // 将 R||S 转回DER编码
+        const unsigned char* raw = reinterpret_cast<const unsigned char*>(signature.data());
+        ECDSA_SIG* sig = ECDSA_SIG_new();
+        BIGNUM* r = BN_bin2bn(raw, ES256_PART_SIZE, nullptr);
+        BIGNUM* s = BN_bin2bn(raw + ES256_PART_SIZE, ES256_PART_SIZE, nullptr);
+        if (!sig || !r || !s || ECDSA_SIG_set0(sig, r, s) != 1) {
+            BN_free(r);
+            BN_free(s);
+            ECDSA_SIG_free(sig);
+            return false;
+        }
+        unsigned char* der = nullptr;
+        int der_len = i2d_ECDSA_SIG(sig, &der);
+        ECDSA_SIG_free(sig);
+        if (der_len <= 0) {
+            return false;
+        }
+        der_signature.assign(reinterpret_cast<char*>(der), der_len);
+        OPENSSL_free(der);
+    }
+    const std::string& to_verify = is_ec ? der_signature : signature;
+
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+    bool ok = EVP_DigestVerifyInit(ctx, nullptr, is_ec ? EVP_sha256() : nullptr, nullptr, key.pkey.get()) == 1 &&
+              EVP_DigestVerify(ctx, reinterpret_cast<const unsigned char*>(to_verify.data()), to_verify.size(),
+                               reinterpret_cast<const unsigned char*>(data), length) == 1;
+    EVP_MD_CTX_free(ctx);
+    return ok;
+}
@@ -0,0 +1,196 @@
+#include "../../include/utils/password_hasher.h"
+#include "../../include/httplib/httplib.h"
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+#include <cstdio>
+#include <atomic>
+#include <future>
+#include <algorithm>
+#include <memory>
+#include <iostream>
+
+namespace {
+    const size_t DIGEST_SIZE = 32;
+    const char HEX_CHARS[] = "0123456789abcdef";
+
+    // scrypt内存上限，需大于 128 * r * N
+    const uint64_t SCRYPT_MAX_MEM = 256ULL * 1024 * 1024;
+
+    std::string toHex(const unsigned char* data, size_t length) {
+        std::string out;
+        out.reserve(length * 2);
+        for (size_t i = 0; i < length; i++) {
+            out.push_back(HEX_CHARS[data[i] >> 4]);
+            out.push_back(HEX_CHARS[data[i] & 0x0f]);
+        }
+        return out;
+    }
+
+    // 当前使用的格式前缀
+    std::string currentPrefix() {
+#ifndef OPENSSL_NO_SCRYPT
+        return "$scrypt$ln=" + std::to_string(PASSWORD_SCRYPT_LOG_N) + ",r=" + std::to_string(PASSWORD_SCRYPT_R) +
+               ",p=" + std::to_string(PASSWORD_SCRYPT_P) + "$";
+#else
+        return "$pbkdf2-sha256$i=" + std::to_string(PASSWORD_PBKDF2_ITERATIONS) + "$";
+#endif
+    }
+
+    bool scryptDigest(const std::string& password, const std::string& salt, int log_n, int r, int p,
+                      unsigned char* digest) {
+#ifndef OPENSSL_NO_SCRYPT
+        return EVP_PBE_scrypt(password.data(), password.size(),
+                              reinterpret_cast<const unsigned char*>(salt.data()), salt.size(),
+                              1ULL << log_n, r, p, SCRYPT_MAX_MEM, digest, DIGEST_SIZE) == 1;
+#else
+        return false;
+#endif
+    }
+
+    bool pbkdf2Digest(const std::string& password, const std::string& salt, int iterations, unsigned char* digest) {
+        return PKCS5_PBKDF2_HMAC(password.data(), static_cast<int>(password.size()),
+                                 reinterpret_cast<const unsigned char*>(salt.data()), static_cast<int>(salt.size()),
+                                 iterations, EVP_sha256(), static_cast<int>(DIGEST_SIZE), digest) == 1;
+    }
+
+    // 旧版本格式：SHA256(密码 + 盐)
+    void legacyDigest(const std::string& password, const std::string& salt, unsigned char* digest) {
+        std::string salted_password = password + salt;
+        SHA256(reinterpret_cast<const unsigned char*>(salted_password.data()), salted_password.size(), digest);
+    }
+
+    // 同时在哈希的请求数及上限（默认8个工作线程的1/4）
+    std::atomic<int> in_flight(0);
+    std::atomic<int> in_flight_limit(2);
+
+    // 专用哈希线程池，排队的任务数由 in_flight_limit 限制
+    // 有意不释放：httplib::ThreadPool 析构时不会回收线程，进程退出时由系统清理
+    httplib::ThreadPool& hashPool() {
+        static httplib::ThreadPool* pool = new httplib::ThreadPool(PASSWORD_HASH_THREADS);
+        return *pool;
+    }
+
+    // 在哈希线程池中执行任务并等待完成；同时在哈希的请求已达上限时不排队，直接返回false
+    bool runOnHashPool(const std::function<void()>& task, std::string& error_message) {
+        if (++in_flight > in_flight_limit) {
+            --in_flight;
+            std::cerr << "密码哈希请求过多，拒绝请求" << std::endl;
+            error_message = PASSWORD_HASHER_BUSY_MESSAGE;
+            return false;
+        }
+
+        std::shared_ptr<std::promise<void>> done = std::make_shared<std::promise<void>>();
+        std::future<void> future = done->get_future();
+        if (!hashPool().enqueue([task, done]() {
+                task();
+                done->set_value();
+            })) {
+            --in_flight;
+            error_message = PASSWORD_HASHER_BUSY_MESSAGE;
+            return false;
+        }
+        future.wait();
+        --in_flight;
+        return true;
+    }
+}
+
+void PasswordHasher::setConcurrencyLimit(size_t worker_threads) {
+    // 至少能让所有哈希线程都有任务
+    in_flight_limit = std::max(PASSWORD_HASH_THREADS, static_cast<int>(worker_threads / PASSWORD_HASH_WORKER_SHARE));
+}
+
+std::string PasswordHasher::generateSalt() {
+    unsigned char salt[16];
+    RAND_bytes(salt, sizeof(salt));
+    return toHex(salt, sizeof(salt));
+}
+
+std::string PasswordHasher::computeHash(const std::string& password, const std::string& salt) {
+    unsigned char digest[DIGEST_SIZE];
+#ifndef OPENSSL_NO_SCRYPT
+    bool ok = scryptDigest(password, salt, PASSWORD_SCRYPT_LOG_N, PASSWORD_SCRYPT_R, PASSWORD_SCRYPT_P, digest);
+#else
+    bool ok = pbkdf2Digest(password, salt, PASSWORD_PBKDF2_ITERATIONS, digest);
+#endif
+    if (!ok) {
+        std::cerr << "密码哈希计算失败" << std::endl;
+        return "";
+    }
+    return currentPrefix() + toHex(digest, DIGEST_SIZE);
+}
+
+bool PasswordHasher::checkHash(const std::string& password, const std::string& salt, const std::string& stored_hash,
+                               bool& needs_rehash) {
+    unsigned char digest[DIGEST_SIZE];
+    std::string expected;
+    int log_n = 0, r = 0, p = 0, iterations = 0;
+    char tail = 0;
+
+    // 参数来自数据库，限制取值范围，避免异常数据导致过量的计算或内存占用
+    if (stored_hash.compare(0, 8, "$scrypt$") == 0) {
+        if (std::sscanf(stored_hash.c_str(), "$scrypt$ln=%d,r=%d,p=%d%c", &log_n, &r, &p, &tail) != 4 ||
+            tail != '$' || log_n < 10 || log_n > 20 || r < 1 || r > 16 || p < 1 || p > 4 ||
+            !scryptDigest(password, salt, log_n, r, p, digest)) {
+            return false;
+        }
+    } else if (stored_hash.compare(0, 15, "$pbkdf2-sha256$") == 0) {
+        if (std::sscanf(stored_hash.c_str(), "$pbkdf2-sha256$i=%d%c", &iterations, &tail) != 2 ||
+            tail != '$' || iterations < 1000 || iterations > 10000000 ||
+            !pbkdf2Digest(password, salt, iterations, digest)) {
+            return false;
+        }
+    } else {
+        legacyDigest(password, salt, digest);
+    }
+
+    size_t prefix_length = stored_hash.rfind('$') == std::string::npos ? 0 : stored_hash.rfind('$') + 1;
+    expected = stored_hash.substr(0, prefix_length) + toHex(digest, DIGEST_SIZE);
+
+    // 常量时间比较
+    bool matched = expected.size() == stored_hash.size() &&
+                   CRYPTO_memcmp(expected.data(), stored_hash.data(), expected.size()) == 0;
+    needs_rehash = matched && stored_hash.compare(0, prefix_length, currentPrefix()) != 0;
+    return matched;
+}
+
+bool PasswordHasher::hashPassword(const std::string& password, std::string& password_hash, std::string& salt,
+                                  std::string& error_message) {
+    std::string new_salt = generateSalt();
+    std::string new_hash;
+    if (!runOnHashPool([&]() { new_hash = computeHash(password, new_salt); }, error_message)) {
+        return false;
+    }
+    if (new_hash.empty()) {
+        error_message = "密码哈希计算失败";
+        return false;
+    }
+    password_hash = new_hash;
+    salt = new_salt;
+    return true;
+}
+
+bool PasswordHasher::verifyPassword(const std::string& password, const std::string& salt,
+                                    const std::string& stored_hash, PasswordCheck& check,
+                                    std::string& error_message) {
+    PasswordCheck result;
+    bool ok = runOnHashPool([&]() {
+        bool needs_rehash = false;
+        result.matched = checkHash(password, salt, stored_hash, needs_rehash);
+        if (needs_rehash) {
+            // 同一任务内完成升级，避免再次排队
+            result.rehash_salt = generateSalt();
+            result.rehash = computeHash(password, result.rehash_salt);
+            if (result.rehash.empty()) {
+                result.rehash_salt.clear();
+            }
+        }
+    }, error_message);
+    if (!ok) {
+        return false;
+    }
+    check = result;
+    return true;
+}
@@ -0,0 +1,43 @@
+#include "../../include/utils/periodic_flusher.h"
+#include <chrono>
+
+PeriodicFlusher::PeriodicFlusher(int interval_ms, const std::function<void()>& task, bool run_on_stop)
+    : interval_ms(interval_ms), task(task), run_on_stop(run_on_stop), running(false) {
+}
+
+bool PeriodicFlusher::start() {
+    if (running.exchange(true)) {
+        return false;
+    }
+
+    worker = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            cond.wait_for(lock, std::chrono::milliseconds(interval_ms), [this]() { return !running; });
+            if (!running && !run_on_stop) {
+                break;
+            }
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    });
+    return true;
+}
+
+bool PeriodicFlusher::stop() {
+    if (!running.exchange(false)) {
+        return false;
+    }
+    // 持锁后再通知，避免后台线程检查完 running、尚未进入等待时错过唤醒
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    cond.notify_all();
+
+    // 在任务中调用 stop() 时不能等待自己
+    if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) {
+        worker.join();
+    }
+    return true;
+}
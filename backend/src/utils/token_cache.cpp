@@ -0,0 +1,82 @@
+#include "../../include/utils/token_cache.h"
+#include <list>
+#include <mutex>
+#include <ctime>
+#include <functional>
+#include <unordered_map>
+
+namespace {
+    // 单个分片：LRU链表 + 哈希索引
+    struct Shard {
+        typedef std::pair<std::string, std::shared_ptr<const TokenClaims>> Entry;
+
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    };
+
+    const size_t SHARD_CAPACITY = (TOKEN_CACHE_CAPACITY + TOKEN_CACHE_SHARDS - 1) / TOKEN_CACHE_SHARDS;
+
+    Shard shards[TOKEN_CACHE_SHARDS];
+
+    Shard& shardFor(const std::string& token) {
+        return shards[std::hash<std::string>()(token) % TOKEN_CACHE_SHARDS];
+    }
+
+    bool expired(const TokenClaims& claims, std::time_t now) {
+        return claims.exp > 0 && now > claims.exp;
+    }
+}
+
+std::shared_ptr<const TokenClaims> TokenCache::get(const std::string& token) {
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(token);
+    if (it == shard.index.end()) {
+        return nullptr;
+    }
+
+    if (expired(*it->second->second, std::time(nullptr))) {
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+        return nullptr;
+    }
+
+    // 移到LRU头部
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->second;
+}
+
+void TokenCache::put(const std::string& token, const std::shared_ptr<const TokenClaims>& claims) {
+    if (!claims || expired(*claims, std::time(nullptr))) {
+        return;
+    }
+
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(token);
+    if (it != shard.index.end()) {
+        it->second->second = claims;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+
+    shard.entries.emplace_front(token, claims);
+    shard.index[token] = shard.entries.begin();
+
+    // 超出容量时淘汰最久未使用的令牌
+    while (shard.entries.size() > SHARD_CAPACITY) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+    }
+}
+
+void TokenCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+    }
+}
@@ -0,0 +1,78 @@
+// JWT签名/验证性能测试
+// 用法: ./build/bin/jwt_bench [次数] [线程数]
+#include "../include/utils/jwt.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+
+// 在多个线程中各执行iterations次op，返回每秒完成的次数
+template <typename Op>
+double run(const char* name, int iterations, int threads, Op op) {
+    std::atomic<int> failures(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < iterations; i++) {
+                if (!op(t, i)) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = iterations * threads / seconds;
+    std::cout << name << ": " << static_cast<long long>(rate) << " tokens/sec"
+              << " (" << iterations * threads << " 次, " << seconds << " 秒";
+    if (failures > 0) {
+        std::cout << ", 失败 " << failures.load() << " 次";
+    }
+    std::cout << ")" << std::endl;
+    return rate;
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    if (iterations <= 0 || threads <= 0) {
+        std::cerr << "用法: " << argv[0] << " [次数] [线程数]" << std::endl;
+        return 1;
+    }
+
+    std::map<std::string, std::string> payload;
+    payload["user_id"] = "10086";
+    payload["username"] = "benchmark_user";
+    payload["role"] = "1";
+
+    // 预先生成一批令牌供验证使用
+    std::vector<std::string> tokens;
+    for (int i = 0; i < 1024; i++) {
+        payload["user_id"] = std::to_string(i);
+        tokens.push_back(JWT::generateToken(payload, 3600));
+    }
+
+    std::cout << "线程数: " << threads << std::endl;
+
+    run("签名", iterations, threads, [&payload](int, int) {
+        return !JWT::generateToken(payload, 3600).empty();
+    });
+
+    run("验证", iterations, threads, [&tokens](int, int i) {
+        std::map<std::string, std::string> out;
+        return JWT::verifyToken(tokens[i % tokens.size()], out);
+    });
+
+    run("验证(缓存)", iterations, threads, [&tokens](int, int i) {
+        return JWT::verifyClaims(tokens[i % tokens.size()]) != nullptr;
+    });
+
+    return 0;
+}